@@ -13,12 +13,13 @@ from __future__ import annotations
 from typing import Any, Callable, TYPE_CHECKING, Iterable, Optional
 
 # Third-Party Imports
+from scipy import stats
 import numpy as np
 
 # Perun Imports
 from perun.check.methods import linear_regression, polynomial_regression, fast_check
 from perun.postprocess.regression_analysis import regression_models
-from perun.profile import query
+from perun.profile import convert, query
 from perun.utils.common import common_kit
 from perun.utils.structs import (
     PerformanceChange,
@@ -32,6 +33,8 @@ if TYPE_CHECKING:
 
 
 SAMPLES: int = 1000
+# Changes of the means per repetition with higher p-value are considered to be noise
+SIGNIFICANCE_LEVEL: float = 0.05
 
 np.seterr(divide="ignore", invalid="ignore")
 
@@ -125,6 +128,57 @@ def get_filtered_best_models_of(
     return best_model_map
 
 
+def get_repetition_statistics(profile: Profile) -> dict[str, tuple[float, float, int]]:
+    """Retrieves the statistics of the amounts per repetition grouped by the uid
+
+    The profiles aggregated across the repetitions of the profiling (e.g. by kperf) contain the
+    mean (as the amount) and the variance of the amount per repetition for each resource, together
+    with the number of repetitions. The statistics of the
+    uid are the sums of the statistics of its resources (assuming they are independent).
+
+    :param Profile profile: profile aggregated across the repetitions
+    :return: map of uids to the mean and the variance of their amounts per repetition and the
+        number of repetitions (empty if the profile is not aggregated across repetitions)
+    """
+    group_by = ("uid", "repetitions")
+    means, _ = convert.resources_to_aggregated_amounts(profile, group_by)
+    variances, _ = convert.resources_to_aggregated_amounts(profile, group_by, amount_key="variance")
+    return {
+        uid: (mean, variances.get((uid, repetitions), 0.0), repetitions)
+        for (uid, repetitions), mean in means.items()
+    }
+
+
+def repetition_means_differ(
+    baseline_statistics: tuple[float, float, int], target_statistics: tuple[float, float, int]
+) -> tuple[bool, float]:
+    """Tests whether the means of the amounts per repetition differ using the Welch's t-test
+
+    :param tuple baseline_statistics: mean, variance and number of repetitions of baseline
+    :param tuple target_statistics: mean, variance and number of repetitions of target
+    :return: pair of flag whether the means significantly differ and the confidence of the
+        test (i.e. one minus its p-value)
+    """
+    baseline_mean, baseline_variance, baseline_repetitions = baseline_statistics
+    target_mean, target_variance, target_repetitions = target_statistics
+    if baseline_repetitions < 2 or target_repetitions < 2:
+        # There is no estimate of the noise, hence we cannot reject any change
+        return True, 0.0
+    if baseline_variance == 0 and target_variance == 0:
+        p_value = float(baseline_mean == target_mean)
+    else:
+        p_value = stats.ttest_ind_from_stats(
+            baseline_mean,
+            np.sqrt(baseline_variance),
+            baseline_repetitions,
+            target_mean,
+            np.sqrt(target_variance),
+            target_repetitions,
+            equal_var=False,
+        ).pvalue
+    return p_value <= SIGNIFICANCE_LEVEL, 1.0 - float(p_value)
+
+
 def get_function_values(model: ModelRecord) -> tuple[list[float], list[float]]:
     """Obtains the relevant values of dependent and independent variables according to
     the given profile, respectively its coefficients. On the base of the count of samples
@@ -6,15 +6,16 @@ from __future__ import annotations
 # Standard Imports
 import contextlib
 import distutils.util as dutils
+import multiprocessing
 import os
 import re
 
-from typing import Any, Iterable, Protocol, TYPE_CHECKING
+from typing import Any, Iterable, Optional, Protocol, TYPE_CHECKING
 
 # Third-Party Imports
 
 # Perun Imports
-from perun.logic import config, pcs, runner, store
+from perun.logic import cache, config, pcs, runner, store
 from perun.select.abstract_base_selection import AbstractBaseSelection
 from perun.check.methods import (
     average_amount_threshold,
@@ -26,6 +27,7 @@ from perun.check.methods import (
     local_statistics,
     polynomial_regression,
 )
+from perun.check.methods.abstract_base_checker import AbstractBaseChecker
 from perun.utils import decorators, log
 from perun.utils.structs import (
     DetectionChangeResult,
@@ -44,6 +46,21 @@ if TYPE_CHECKING:
 # Minimal confidence rate from both models to perform the detection
 _MIN_CONFIDENCE_RATE = 0.15
 
+# Profiles loaded for the running check; forked workers inherit them instead of unpickling them
+_LOADED_PROFILES: dict[str, Profile] = {}
+
+# Checkers of the supported detection methods
+DEGRADATION_CHECKERS: dict[str, type[AbstractBaseChecker]] = {
+    "average_amount_threshold": average_amount_threshold.AverageAmountThreshold,
+    "best_model_order_equality": best_model_order_equality.BestModelOrderEquality,
+    "exclusive_time_outliers": exclusive_time_outliers.ExclusiveTimeOutliers,
+    "fast_check": fast_check.FastCheck,
+    "integral_comparison": integral_comparison.IntegralComparison,
+    "linear_regression": linear_regression.LinearRegression,
+    "local_statistics": local_statistics.LocalStatistics,
+    "polynomial_regression": polynomial_regression.PolynomialRegression,
+}
+
 
 class CallableDetectionMethod(Protocol):
     """Protocol for Callable detection method"""
@@ -135,18 +152,154 @@ def pre_collect_profiles(minor_version: MinorVersion) -> None:
         pre_collect_profiles.minor_version_cache.add(minor_version.checksum)
 
 
+def get_number_of_check_workers() -> int:
+    """Returns the number of worker processes used for checking the pairs of profiles.
+
+    The number is set by :ckey:`degradation.workers`; by default the checks are run sequentially.
+
+    :return: number of workers (at least 1)
+    """
+    try:
+        return max(int(config.lookup_key_recursively("degradation.workers", "1")), 1)
+    except ValueError:
+        log.warn("'degradation.workers' is not a number: running checks sequentially")
+        return 1
+
+
+def load_profile_once(profile_path: str, loaded_profiles: dict[str, Profile]) -> Profile:
+    """Loads the profile from the object store, unless it was already loaded
+
+    :param str profile_path: path to the profile in the object store
+    :param dict loaded_profiles: map of paths to already loaded profiles
+    :return: loaded profile
+    """
+    if profile_path not in loaded_profiles:
+        loaded_profiles[profile_path] = store.load_profile_from_file(profile_path, False, True)
+    return loaded_profiles[profile_path]
+
+
+def load_profile_header_once(
+    profile_path: str, loaded_profiles: dict[str, Profile], loaded_headers: dict[str, Profile]
+) -> Profile:
+    """Loads the profile without its resources, unless the profile or its header was already loaded
+
+    The header suffices to select the baselines and the strategies of checks. Profiles, whose
+    header cannot be loaded separately, are loaded whole by :func:`load_profile_once`.
+
+    :param str profile_path: path to the profile in the object store
+    :param dict loaded_profiles: map of paths to already loaded profiles
+    :param dict loaded_headers: map of paths to already loaded headers of profiles
+    :return: loaded profile, possibly without resources
+    """
+    if profile_path in loaded_profiles:
+        return loaded_profiles[profile_path]
+    if profile_path not in loaded_headers:
+        header = store.load_profile_header(profile_path)
+        if header is None:
+            return load_profile_once(profile_path, loaded_profiles)
+        loaded_headers[profile_path] = header
+    return loaded_headers[profile_path]
+
+
+def run_degradation_task(task: tuple[str, str, str, str]) -> list[DegradationInfo]:
+    """Runs one check between the pair of already loaded profiles
+
+    :param tuple task: path to baseline profile, path to target profile, name of the degradation
+        method and name of the detection models strategy
+    :return: list of all degradation infos found by the method
+    """
+    baseline_path, target_path, degradation_method, models_strategy = task
+    return list(
+        run_degradation_check(
+            degradation_method,
+            _LOADED_PROFILES[baseline_path],
+            _LOADED_PROFILES[target_path],
+            models_strategy=models_strategy,
+        )
+    )
+
+
+def run_degradation_tasks(
+    tasks: list[tuple[str, str, str, str]], loaded_profiles: Optional[dict[str, Profile]] = None
+) -> list[list[DegradationInfo]]:
+    """Runs the checks between the pairs of profiles, possibly in the pool of workers
+
+    If :ckey:`degradation.cache` is enabled, the results of checks, that were already run for the
+    same pair of profile objects, are taken from the cache, and only the remaining checks are run.
+    Only the profiles of the remaining checks are loaded (in ``_LOADED_PROFILES``, so the forked
+    workers inherit them). The results are returned in the order of the tasks, regardless of the
+    order in which the workers finish them.
+
+    :param list tasks: list of checks, see :func:`run_degradation_task`
+    :param dict loaded_profiles: map of paths to already loaded profiles, which is updated by
+        the profiles loaded for the checks
+    :return: list of results for each of the tasks
+    """
+    loaded_profiles = {} if loaded_profiles is None else loaded_profiles
+    use_cache = dutils.strtobool(str(config.lookup_key_recursively("degradation.cache", "true")))
+    perun_dir = pcs.get_path()
+    cache_keys: list[Optional[str]] = []
+    task_results: list[Optional[list[DegradationInfo]]] = []
+    for baseline_path, target_path, degradation_method, models_strategy in tasks:
+        baseline_checksum = store.version_path_to_sha(baseline_path)
+        target_checksum = store.version_path_to_sha(target_path)
+        cache_key = None
+        if use_cache and baseline_checksum and target_checksum:
+            cache_key = cache.degradation_cache_key(
+                baseline_checksum,
+                target_checksum,
+                degradation_method,
+                get_degradation_check_parameters(degradation_method, models_strategy),
+            )
+        cache_keys.append(cache_key)
+        task_results.append(
+            cache.load_cached_degradations(perun_dir, cache_key) if cache_key else None
+        )
+
+    uncached_tasks = [i for (i, result) in enumerate(task_results) if result is None]
+    for i in uncached_tasks:
+        for profile_path in tasks[i][:2]:
+            _LOADED_PROFILES[profile_path] = load_profile_once(profile_path, loaded_profiles)
+    workers = min(get_number_of_check_workers(), len(uncached_tasks))
+    try:
+        if workers <= 1 or "fork" not in multiprocessing.get_all_start_methods():
+            computed_results = [run_degradation_task(tasks[i]) for i in uncached_tasks]
+        else:
+            with multiprocessing.get_context("fork").Pool(workers) as pool:
+                computed_results = pool.map(
+                    run_degradation_task, [tasks[i] for i in uncached_tasks], chunksize=1
+                )
+    finally:
+        _LOADED_PROFILES.clear()
+
+    for i, result in zip(uncached_tasks, computed_results):
+        task_results[i] = result
+        if (cache_key := cache_keys[i]) is not None:
+            cache.store_cached_degradations(perun_dir, cache_key, result)
+    return [result or [] for result in task_results]
+
+
 def degradation_in_minor(
-    minor_version: str, quiet: bool = False
+    minor_version: str, quiet: bool = False, loaded_profiles: Optional[dict[str, Profile]] = None
 ) -> list[tuple[DegradationInfo, str, str]]:
     """Checks for degradation according to the profiles stored for the given minor version.
 
+    The checks of all (baseline, target, method) triples are derived from the headers of
+    profiles; each profile is then loaded at most once and only if some of its checks are not
+    cached. The checks are run, possibly concurrently (see :ckey:`degradation.workers`), and their
+    results are merged in a deterministic order.
+
     :param str minor_version: representation of head point of degradation checking
     :param bool quiet: if set to true then nothing will be printed
+    :param dict loaded_profiles: map of paths to already loaded profiles; after the check it
+        contains only the profiles used by this check (baselines of this version are the targets
+        of its parents)
     :returns: list of found changes
     """
     log.major_info(f"Checking Version {minor_version}")
     selection: AbstractBaseSelection = pcs.selection()
     minor_version_info = pcs.vcs().get_minor_version_info(minor_version)
+    loaded_profiles = {} if loaded_profiles is None else loaded_profiles
 
     # Precollect profiles for all near versions
     pre_collect_profiles(minor_version_info)
@@ -154,22 +307,47 @@ def degradation_in_minor(
         pre_collect_profiles(parent_version)
 
     profile_queue = profiles_to_queue(minor_version)
-    detected_changes = []
+    tasks = []
+    task_sources = []
+    loaded_headers: dict[str, Profile] = {}
 
     for target_config, target_profile_info in profile_queue.items():
         # Iterate through the profiles and check degradation between those of same configuration
-        target_prof = store.load_profile_from_file(target_profile_info.realpath, False, True)
+        target_prof = load_profile_header_once(
+            target_profile_info.realpath, loaded_profiles, loaded_headers
+        )
         cmdstr = profiles.config_tuple_to_cmdstr(target_config)
 
         for baseline_info, baseline_profile_info in selection.get_profiles(
             minor_version_info, target_prof
         ):
-            baseline_prof = store.load_profile_from_file(
-                baseline_profile_info.realpath, False, True
+            baseline_prof = load_profile_header_once(
+                baseline_profile_info.realpath, loaded_profiles, loaded_headers
             )
-            for deg in degradation_between_profiles(baseline_prof, target_prof, "best-model"):
-                if deg.result != PerformanceChange.NoChange:
-                    detected_changes.append((deg, cmdstr, baseline_info.checksum))
+            for degradation_method in get_strategies_for(baseline_prof):
+                tasks.append(
+                    (
+                        baseline_profile_info.realpath,
+                        target_profile_info.realpath,
+                        degradation_method,
+                        "best-model",
+                    )
+                )
+                task_sources.append((cmdstr, baseline_info.checksum))
+
+    used_profiles = {path for task in tasks for path in task[:2]}
+    used_profiles.update(info.realpath for info in profile_queue.values())
+    for unused_profile in set(loaded_profiles.keys()) - used_profiles:
+        del loaded_profiles[unused_profile]
+
+    task_results = run_degradation_tasks(tasks, loaded_profiles)
+
+    detected_changes = [
+        (deg, cmdstr, baseline_checksum)
+        for (cmdstr, baseline_checksum), results in zip(task_sources, task_results)
+        for deg in results
+        if deg.result != PerformanceChange.NoChange
+    ]
 
     # Store the detected degradation
     store.save_degradation_list_for(pcs.get_object_directory(), minor_version, detected_changes)
@@ -189,12 +367,15 @@ def degradation_in_history(head: str) -> list[tuple[DegradationInfo, str, str]]:
     log.minor_info("This might take a while")
     detected_changes = []
     version_selection: AbstractBaseSelection = pcs.selection()
+    loaded_profiles: dict[str, Profile] = {}
     with log.History(head) as history:
         for minor_version in pcs.vcs().walk_minor_versions(head):
             history.progress_to_next_minor_version(minor_version)
             newly_detected_changes = []
             if version_selection.should_check_version(minor_version):
-                newly_detected_changes = degradation_in_minor(minor_version.checksum, True)
+                newly_detected_changes = degradation_in_minor(
+                    minor_version.checksum, True, loaded_profiles
+                )
                 log.print_short_change_string(
                     log.count_degradations_per_group(newly_detected_changes)
                 )
@@ -236,38 +417,32 @@ def run_degradation_check(
 
     Constructs from string an Checker object and runs the check method
     """
-    if degradation_method == "average_amount_threshold":
-        yield from average_amount_threshold.AverageAmountThreshold().check(
-            baseline_profile, target_profile, **kwargs
-        )
-    elif degradation_method == "best_model_order_equality":
-        yield from best_model_order_equality.BestModelOrderEquality().check(
-            baseline_profile, target_profile, **kwargs
-        )
-    elif degradation_method == "exclusive_time_outliers":
-        yield from exclusive_time_outliers.ExclusiveTimeOutliers().check(
-            baseline_profile, target_profile, **kwargs
-        )
-    elif degradation_method == "fast_check":
-        yield from fast_check.FastCheck().check(baseline_profile, target_profile, **kwargs)
-    elif degradation_method == "integral_comparison":
-        yield from integral_comparison.IntegralComparison().check(
-            baseline_profile, target_profile, **kwargs
-        )
-    elif degradation_method == "linear_regression":
-        yield from linear_regression.LinearRegression().check(
-            baseline_profile, target_profile, **kwargs
-        )
-    elif degradation_method == "local_statistics":
-        yield from local_statistics.LocalStatistics().check(
-            baseline_profile, target_profile, **kwargs
-        )
-    elif degradation_method == "polynomial_regression":
-        yield from polynomial_regression.PolynomialRegression().check(
-            baseline_profile, target_profile, **kwargs
-        )
-    else:
+    if degradation_method not in DEGRADATION_CHECKERS:
         raise UnsupportedModuleException(f"{degradation_method}")
+    yield from DEGRADATION_CHECKERS[degradation_method]().check(
+        baseline_profile, target_profile, **kwargs
+    )
+
+
+def get_degradation_check_parameters(
+    degradation_method: str, models_strategy: str
+) -> dict[str, Any]:
+    """Retrieves the parameters, which affect the results of the check (e.g. to identify its
+    cached results)
+
+    :param str degradation_method: name of the detection method
+    :param str models_strategy: name of the detection models strategy
+    :return: the models strategy, the version of the method and its configuration
+    """
+    checker = DEGRADATION_CHECKERS.get(degradation_method, AbstractBaseChecker)
+    return {
+        "models_strategy": models_strategy,
+        "version": checker.version,
+        "configuration": {
+            key: str(config.lookup_key_recursively(key, default))
+            for (key, default) in checker.configuration.items()
+        },
+    }
 
 
 @log.print_elapsed_time
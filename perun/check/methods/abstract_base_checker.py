@@ -8,7 +8,7 @@ from __future__ import annotations
 
 # Standard Imports
 from abc import abstractmethod, ABC
-from typing import TYPE_CHECKING, Any, Iterable
+from typing import TYPE_CHECKING, Any, ClassVar, Iterable
 
 # Third-Party Imports
 
@@ -19,7 +19,15 @@ if TYPE_CHECKING:
 
 
 class AbstractBaseChecker(ABC):
-    """Abstract Base Class for all checkers to implement"""
+    """Abstract Base Class for all checkers to implement
+
+    :cvar int version: version of the method, which has to be increased whenever its results
+        change, so the cached results of the older versions are not used
+    :cvar dict configuration: configuration keys read by the method with their default values
+    """
+
+    version: ClassVar[int] = 1
+    configuration: ClassVar[dict[str, str]] = {}
 
     @abstractmethod
     def check(
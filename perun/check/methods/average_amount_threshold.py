@@ -6,7 +6,8 @@ according to the set threshold the checker detects either ``Optimization`` or ``
 optimization, i.e. the threshold is two times speed-up or speed-down)
 
   - **Detects**: `Ratio` changes; ``Optimization`` and ``Degradation``
-  - **Confidence**: `None`
+  - **Confidence**: `t-test` of the means per repetition, if both profiles are aggregated across
+    at least two repetitions (e.g. by ``kperf``); otherwise `None`
   - **Limitations**: `None`
 
 The example of output generated by `AAT` method is as follows::
@@ -32,7 +33,9 @@ The example of output generated by `AAT` method is as follows::
 In the output above, we detected the ``Optimization`` between commits ``1eb3d6`` (target) and
 ``7813e3`` (baseline), where the average amount of running time for ``SLList_search`` function
 changed from about six seconds to a hundred milliseconds. For these detected changes we report no
-confidence at all.
+confidence at all, unless the profiles contain the variances of amounts across the repetitions of
+the profiling: then the means per repetition are compared by the Welch's t-test, and changes that
+are not significant (i.e. they are within the noise of the repetitions) are not reported.
 """
 from __future__ import annotations
 
@@ -42,6 +45,7 @@ from typing import Any, Iterable, TYPE_CHECKING
 # Third-Party Imports
 
 # Perun Imports
+from perun.check import detection_kit as detect
 from perun.check.methods.abstract_base_checker import AbstractBaseChecker
 from perun.profile import convert
 from perun.utils.common import common_kit
@@ -68,6 +72,8 @@ def get_averages(profile: Profile) -> dict[str, float]:
 
 
 class AverageAmountThreshold(AbstractBaseChecker):
+    version = 2
+
     def check(
         self, baseline_profile: Profile, target_profile: Profile, **_: Any
     ) -> Iterable[DegradationInfo]:
@@ -83,6 +89,8 @@ class AverageAmountThreshold(AbstractBaseChecker):
         """
         baseline_averages = get_averages(baseline_profile)
         target_averages = get_averages(target_profile)
+        baseline_statistics = detect.get_repetition_statistics(baseline_profile)
+        target_statistics = detect.get_repetition_statistics(target_profile)
 
         # Fixme: Temporary solution ;)
         unit = list(baseline_profile["header"]["units"].values())[0]
@@ -98,6 +106,18 @@ class AverageAmountThreshold(AbstractBaseChecker):
                 else:
                     change = PerformanceChange.NoChange
 
+                confidence_type, confidence = "no", 0.0
+                baseline_statistic = baseline_statistics.get(target_uid, (0.0, 0.0, 0))
+                target_statistic = target_statistics.get(target_uid, (0.0, 0.0, 0))
+                # The t-test needs at least two repetitions in each profile to estimate the noise
+                if baseline_statistic[2] >= 2 and target_statistic[2] >= 2:
+                    differ, confidence = detect.repetition_means_differ(
+                        baseline_statistic, target_statistic
+                    )
+                    confidence_type = "t-test"
+                    if not differ:
+                        change = PerformanceChange.NoChange
+
                 yield DegradationInfo(
                     res=change,
                     t=resource_type,
@@ -105,4 +125,6 @@ class AverageAmountThreshold(AbstractBaseChecker):
                     fb=f"{round(baseline_average, 2)}{unit}",
                     tt=f"{round(target_average, 2)}{unit}",
                     rd=difference_ratio,
+                    ct=confidence_type,
+                    cr=confidence,
                 )
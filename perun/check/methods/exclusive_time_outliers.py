@@ -95,6 +95,8 @@ NS_TO_MS = 1000000
 
 
 class ExclusiveTimeOutliers(AbstractBaseChecker):
+    configuration = {"degradation.location_filter": "*", "degradation.cutoff": "0.0"}
+
     def check(
         self, baseline_profile: Profile, target_profile: Profile, **_: Any
     ) -> Iterable[DegradationInfo]:
@@ -150,12 +152,15 @@ class DiffProfile:
         :param baseline_profile: baseline against which we are checking the degradation
         :param target_profile: profile corresponding to the checked minor version
         """
+        configuration = ExclusiveTimeOutliers.configuration
         self.location_filter: Optional[str] = config.lookup_key_recursively(
-            "degradation.location_filter", "*"
+            "degradation.location_filter", configuration["degradation.location_filter"]
         )
         if self.location_filter == "*":
             self.location_filter = None
-        self.cut_off: float = float(config.lookup_key_recursively("degradation.cutoff", "0.0"))
+        self.cut_off: float = float(
+            config.lookup_key_recursively("degradation.cutoff", configuration["degradation.cutoff"])
+        )
         self.df: pd.DataFrame = self._merge_and_diff(
             self._prepare_profile(baseline_profile),
             self._prepare_profile(target_profile),
@@ -29,6 +29,17 @@ from perun.utils.structs import CollectStatus
         " details about the format of the template."
     ),
 )
+@click.option(
+    "--workers",
+    "-j",
+    type=click.INT,
+    default=None,
+    callback=cli_kit.set_config_option_from_flag(perun_config.runtime, "execute.workers", str),
+    help=(
+        "Runs the independent jobs concurrently by the given number of workers. Refer to"
+        " :ckey:`execute.workers` for more details."
+    ),
+)
 @click.option(
     "--minor-version",
     "-m",
@@ -60,6 +60,9 @@ _COLLECTOR_SUBTYPES = {"delta": "time delta"}
 # The time conversion constant
 _MICRO_TO_SECONDS = 1000000.0
 
+# The collected data are stored in the fixed file next to the profiled binary
+EXCLUSIVE_RESOURCES = ["complexity-data"]
+
 
 def before(executable: Executable, **kwargs: Any) -> tuple[CollectStatus, str, dict[str, Any]]:
     """Builds, links and configures the complexity collector executable
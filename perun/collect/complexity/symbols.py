@@ -16,13 +16,9 @@ import dataclasses
 # Third-Party Imports
 
 # Perun Imports
-from perun.utils.external import commands
+from perun.utils.external import commands, symbolization
 from perun.utils import exceptions
 
-# Symbol table columns constants
-_SYMTABLE_NAME_COLUMN = 8
-_SYMTABLE_ADDR_COLUMN = 2
-
 
 @dataclasses.dataclass(frozen=True)
 class PrototypeParts:
@@ -51,7 +47,7 @@ def extract_symbols(executable_path: str) -> list[str]:
 
     :return list: function symbol names
     """
-    return _get_symbols(executable_path, [_SYMTABLE_NAME_COLUMN])
+    return [name for (_, _, name) in _get_symbols(executable_path)]
 
 
 def extract_symbol_map(executable_path: str) -> dict[str, str]:
@@ -61,13 +57,8 @@ def extract_symbol_map(executable_path: str) -> dict[str, str]:
 
     :return dict: function symbols map in form 'mangled name: hex address'
     """
-    # Get the mangled function names and addresses
-    symbols = _get_symbols(executable_path, [_SYMTABLE_ADDR_COLUMN, _SYMTABLE_NAME_COLUMN])
     # Create symbol map as name: address in hex format
-    symbol_map = {
-        symbols[i + 1]: ("0x" + symbols[i].lstrip("0")) for i in range(0, len(symbols), 2)
-    }
-    return symbol_map
+    return {name: f"{address:#x}" for (address, _, name) in _get_symbols(executable_path)}
 
 
 def extract_symbol_address_map(executable_path: str) -> dict[str, str]:
@@ -77,16 +68,12 @@ def extract_symbol_address_map(executable_path: str) -> dict[str, str]:
 
     :return dict: function symbols map in form 'hex address: demangled name'
     """
-    # Get the mangled function names and addresses
-    symbols = _get_symbols(executable_path, [_SYMTABLE_ADDR_COLUMN, _SYMTABLE_NAME_COLUMN])
     # Create address map as hex address: mangled name
-    address_map = {
-        ("0x" + symbols[i].lstrip("0")): symbols[i + 1] for i in range(0, len(symbols), 2)
-    }
-    # Translate the mangled names
+    address_map = {f"{address:#x}": name for (address, _, name) in _get_symbols(executable_path)}
+    # Translate the mangled names (keeping the names, which c++filt did not translate)
     name_map = translate_mangled_symbols(list(address_map.values()))
     for record in address_map:
-        address_map[record] = name_map[address_map[record]]
+        address_map[record] = name_map.get(address_map[record], address_map[record])
     return address_map
 
 
@@ -142,34 +129,19 @@ def unify_sample_func(func: str) -> str:
     return body + args
 
 
-def _get_symbols(executable_path: str, columns: list[int]) -> list[str]:
-    """Creates the pipe of linux utils to access and filter executable symbol table
+def _get_symbols(executable_path: str) -> list[tuple[int, int, str]]:
+    """Reads the defined function symbols from the executable symbol table
+
+    The symbols are shared (and cached on disk) with other collectors by
+    :mod:`perun.utils.external.symbolization`.
 
     :param str executable_path: path to the executable
-    :param list columns: symbol table column numbers which should be captured
 
-    :return list: sequential symbol table values [column1, column2, column1, ...]
+    :return list: function symbols as triples of address, size and mangled name (empty if the
+        executable is not a readable ELF file)
     """
-    # Convert the columns list to string parameter
-    columns_str = ",".join(str(column) for column in columns)
-
-    cmd = (
-        "readelf -sW "
-        + executable_path
-        + " | awk '$4 == \"FUNC\" && $7 != \"UND\"' | awk '{$2=$2};1' | cut -d' ' -f "
-        + columns_str
-    )
-
-    # Run the command to obtain function symbols
-    symbols_bytes, _ = commands.run_safely_external_command(cmd)
-
-    # Decode the bytes and create list
-    symbols = symbols_bytes.decode("utf-8").replace(" ", "\n").split("\n")
-    # Remove the redundant element
-    if "" in symbols:
-        symbols.remove("")
-
-    return symbols
+    binary = symbolization.load(executable_path)
+    return binary.symbols if binary is not None else []
 
 
 def _finalize_exclude_lists(
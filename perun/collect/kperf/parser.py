@@ -4,36 +4,181 @@ Contains helper functions for parsing information from perf
 from __future__ import annotations
 
 # Standard Imports
-from typing import Any
+from typing import Any, Iterable, Optional
+import array
 
 # Third-Party Imports
-import progressbar
 
 # Perun Imports
+from perun.profile.folding import StackTrie
 
 
-def parse_events(perf_events: list[str]) -> list[dict[str, Any]]:
+# Metrics derived from the counts of the events as pairs of the numerator and the denominator,
+# and the scale of their ratio; the miss rates are per thousand of instructions (MPKI)
+DERIVED_METRICS: dict[str, tuple[str, str, float]] = {
+    "ipc": ("instructions", "cycles", 1.0),
+    "cache-mpki": ("cache-misses", "instructions", 1000.0),
+    "branch-mpki": ("branch-misses", "instructions", 1000.0),
+}
+
+
+def fold_events(perf_events: Iterable[str], trie: Optional[StackTrie] = None) -> StackTrie:
+    """Folds perf events in the folded format of stackcollapse-perf.pl into the trie
+
+    :param perf_events: lines with folded stacks and their numbers of samples
+    :param trie: trie, into which the events are folded (new trie is created if None)
+    :return: trie of the folded stacks
+    """
+    trie = StackTrie() if trie is None else trie
+    for event in perf_events:
+        if event.strip():
+            record, samples = event.rsplit(" ", 1)
+            trie.add(record.split(";"), int(samples))
+    return trie
+
+
+class StackStatistics:
+    """Statistics of the folded stacks aggregated across the repetitions of the profiling
+
+    The stacks of each repetition are merged into the single trie as soon as they are collected,
+    hence the memory is bounded by the number of unique stacks regardless of the number of
+    repetitions. For each stack, the sum and the sum of squares of its amounts are kept, so the
+    mean and the variance of its amount per repetition can be computed (the repetitions, in
+    which the stack was not sampled, count as zeros).
+
+    If further events were sampled together with the primary one (whose counts are the amounts
+    of the stacks), only the sums of their counts are kept for each stack.
+
+    :ivar StackTrie trie: merged stacks with the sums of their amounts across the repetitions
+    :ivar array squares: sums of squares of the amounts of the stacks
+    :ivar array runs: numbers of repetitions, in which the stacks were sampled
+    :ivar dict event_counts: map of further events to the sums of their counts of the stacks
+    :ivar str event: name of the primary event (None if unknown)
+    :ivar int repetitions: number of aggregated repetitions
+    """
+
+    __slots__ = ["trie", "squares", "runs", "event_counts", "event", "repetitions"]
+
+    def __init__(self, event: Optional[str] = None) -> None:
+        """Initializes empty statistics
+
+        :param str event: name of the primary event, if it is known
+        """
+        self.trie = StackTrie()
+        self.squares: array.array[float] = array.array("d", [0])
+        self.runs: array.array[int] = array.array("q", [0])
+        self.event_counts: dict[str, array.array[float]] = {}
+        self.event = event
+        self.repetitions: int = 0
+
+    def add(self, run: StackTrie, events: Optional[dict[str, StackTrie]] = None) -> None:
+        """Merges the stacks of one repetition into the statistics
+
+        :param StackTrie run: stacks folded in one repetition
+        :param dict events: stacks of further events folded in the same repetition
+        """
+        node_map = self.trie.graft(run)
+        event_maps = [
+            (event, trie, self.trie.graft(trie)) for (event, trie) in (events or {}).items()
+        ]
+        grown = len(self.trie) - len(self.squares)
+        self.squares.extend(array.array("d", bytes(grown * self.squares.itemsize)))
+        self.runs.extend(array.array("q", bytes(grown * self.runs.itemsize)))
+        for event_counts in self.event_counts.values():
+            event_counts.extend(array.array("d", bytes(grown * event_counts.itemsize)))
+        for event, event_trie, event_map in event_maps:
+            if event not in self.event_counts:
+                self.event_counts[event] = array.array(
+                    "d", bytes(len(self.trie) * self.squares.itemsize)
+                )
+            event_counts = self.event_counts[event]
+            for node, merged_node in enumerate(event_map):
+                event_counts[merged_node] += event_trie.counts[node]
+        counts, squares, runs = self.trie.counts, self.squares, self.runs
+        for node, merged_node in enumerate(node_map):
+            count = run.counts[node]
+            if count:
+                counts[merged_node] += count
+                squares[merged_node] += count * count
+                runs[merged_node] += 1
+        self.repetitions += 1
+
+    def mean(self, node: int) -> float:
+        """
+        :param int node: node, where the stack ends
+        :return: mean amount of the stack per repetition
+        """
+        return self.trie.counts[node] / self.repetitions if self.repetitions else 0.0
+
+    def variance(self, node: int) -> float:
+        """
+        :param int node: node, where the stack ends
+        :return: sample variance of the amount of the stack across the repetitions
+        """
+        if self.repetitions < 2:
+            return 0.0
+        total = self.trie.counts[node]
+        variance = (self.squares[node] - total * total / self.repetitions) / (self.repetitions - 1)
+        return max(variance, 0.0)
+
+    def metrics(self, node: int) -> dict[str, float]:
+        """
+        :param int node: node, where the stack ends
+        :return: mean counts of further events of the stack per repetition and the metrics
+            derived from the counts of all events (the metrics with zero denominators are omitted)
+        """
+        counts = {event: event_counts[node] for (event, event_counts) in self.event_counts.items()}
+        metrics: dict[str, float] = {
+            event: count / self.repetitions if self.repetitions else 0.0
+            for (event, count) in counts.items()
+        }
+        if self.event is not None:
+            counts[self.event] = self.trie.counts[node]
+        for metric, (numerator, denominator, scale) in DERIVED_METRICS.items():
+            if counts.get(denominator) and numerator in counts:
+                metrics[metric] = scale * counts[numerator] / counts[denominator]
+        return metrics
+
+
+def parse_events(perf_events: StackStatistics) -> list[dict[str, Any]]:
     """Parses perf events into a list of resources
 
     Each resource is identified by its topmost called function (uid),
     and contains traces and unit (the bottom function). For each
-    function we count the number of samples.
+    function we count the number of samples. Since the events are already
+    folded and aggregated across the repetitions, there is exactly one
+    resource for each unique stack, with the mean of samples per repetition
+    as its amount (so the profiles of different numbers of repetitions are
+    comparable), together with the variance of the samples per repetition,
+    the number of repetitions, in which the stack was sampled, and the number
+    of all repetitions. If further events were sampled, each resource further
+    contains the mean count of each event per repetition and the metrics
+    derived from them (see :data:`DERIVED_METRICS`), so the flame graphs can
+    be drawn for each of the metrics.
 
-    :param perf_events: string with perf events
+    Note that the amount is a float mean, not the total number of samples; the totals of the
+    flame graphs hence correspond to a single average repetition.
+
+    :param perf_events: statistics of the folded perf events (command followed by the frames)
     :return: list of resources
     """
     resources = []
-    for event in progressbar.progressbar(perf_events):
-        if event.strip():
-            record, samples = event.split(" ")
-            parts = record.split(";")
+    trie = perf_events.trie
+    event_counts = list(perf_events.event_counts.values())
+    for node in range(1, len(trie)):
+        if trie.counts[node] or any(counts[node] for counts in event_counts):
+            parts = trie.stack_of(node)
             command, trace, uid = parts[0], parts[1:-1], parts[-1]
             resources.append(
                 {
-                    "amount": int(samples),
+                    "amount": perf_events.mean(node),
+                    "variance": perf_events.variance(node),
+                    "runs": perf_events.runs[node],
+                    "repetitions": perf_events.repetitions,
                     "uid": uid,
                     "command": command,
                     "trace": [{"func": f} for f in trace],
+                    **perf_events.metrics(node),
                 }
             )
     return resources
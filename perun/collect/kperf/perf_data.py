@@ -0,0 +1,610 @@
+"""In-process reader of the data recorded by ``perf record``.
+
+The sample records and their callchains are parsed directly from the (memory mapped)
+``perf.data`` file, instead of converting the whole recording to text by ``perf script`` and
+folding it by ``stackcollapse-perf.pl``. While reading the records, only the names of the threads
+and the memory maps of the processes are tracked, and the samples are counted by their raw
+callchains in a single pass. Each unique address is then resolved to its function only once
+(using ``/proc/kallsyms`` for the kernel and the symbols of the mapped ELF binaries, shared with
+other collectors by :mod:`perun.utils.external.symbolization`, for the user space), and each
+unique callchain is folded into the :class:`StackTrie` with interned frames.
+
+The frames are named the same way as by ``stackcollapse-perf.pl``, hence the profiles are
+comparable regardless of how the data were read. If several events were sampled (e.g. the
+hardware counters recorded as a group), the stacks of each of them can be folded separately.
+"""
+from __future__ import annotations
+
+# Standard Imports
+from typing import Any, Callable, Iterator, NamedTuple, Optional
+import bisect
+import dataclasses
+import mmap
+import os
+import re
+import struct
+
+# Third-Party Imports
+
+# Perun Imports
+from perun.profile.folding import StackTrie
+from perun.utils import exceptions
+from perun.utils.external import symbolization
+
+
+PERF_MAGIC: bytes = b"PERFILE2"
+
+# Types of the records
+PERF_RECORD_MMAP: int = 1
+PERF_RECORD_COMM: int = 3
+PERF_RECORD_FORK: int = 7
+PERF_RECORD_SAMPLE: int = 9
+PERF_RECORD_MMAP2: int = 10
+PERF_RECORD_COMPRESSED: int = 81
+PERF_RECORD_MISC_CPUMODE_MASK: int = 0x7
+PERF_RECORD_MISC_KERNEL: int = 1
+PERF_RECORD_MISC_COMM_EXEC: int = 1 << 13
+
+# Fields of the samples
+PERF_SAMPLE_IP: int = 1 << 0
+PERF_SAMPLE_TID: int = 1 << 1
+PERF_SAMPLE_TIME: int = 1 << 2
+PERF_SAMPLE_ADDR: int = 1 << 3
+PERF_SAMPLE_READ: int = 1 << 4
+PERF_SAMPLE_CALLCHAIN: int = 1 << 5
+PERF_SAMPLE_ID: int = 1 << 6
+PERF_SAMPLE_CPU: int = 1 << 7
+PERF_SAMPLE_PERIOD: int = 1 << 8
+PERF_SAMPLE_STREAM_ID: int = 1 << 9
+PERF_SAMPLE_IDENTIFIER: int = 1 << 16
+
+# Format of the values of counters read in the samples
+PERF_FORMAT_TOTAL_TIME_ENABLED: int = 1 << 0
+PERF_FORMAT_TOTAL_TIME_RUNNING: int = 1 << 1
+PERF_FORMAT_ID: int = 1 << 2
+PERF_FORMAT_GROUP: int = 1 << 3
+PERF_FORMAT_LOST: int = 1 << 4
+
+# Entries of callchains greater or equal to this value mark the context of the following entries
+PERF_CONTEXT_MAX: int = 2**64 - 4095
+PERF_CONTEXT_KERNEL: int = 2**64 - 128
+PERF_CONTEXT_USER: int = 2**64 - 512
+# Pid of the maps of the kernel and its modules
+KERNEL_PID: int = 2**32 - 1
+KERNEL_MODULE: str = "[kernel.kallsyms]"
+UNKNOWN_MODULE: str = "[unknown]"
+
+# Names of the generic hardware and software events (as used by ``perf record -e``)
+PERF_TYPE_HARDWARE: int = 0
+PERF_TYPE_SOFTWARE: int = 1
+EVENT_NAMES: dict[tuple[int, int], str] = {
+    (PERF_TYPE_HARDWARE, 0): "cycles",
+    (PERF_TYPE_HARDWARE, 1): "instructions",
+    (PERF_TYPE_HARDWARE, 2): "cache-references",
+    (PERF_TYPE_HARDWARE, 3): "cache-misses",
+    (PERF_TYPE_HARDWARE, 4): "branch-instructions",
+    (PERF_TYPE_HARDWARE, 5): "branch-misses",
+    (PERF_TYPE_SOFTWARE, 0): "cpu-clock",
+    (PERF_TYPE_SOFTWARE, 1): "task-clock",
+    (PERF_TYPE_SOFTWARE, 2): "page-faults",
+    (PERF_TYPE_SOFTWARE, 3): "context-switches",
+    (PERF_TYPE_SOFTWARE, 4): "cpu-migrations",
+    (PERF_TYPE_SOFTWARE, 5): "minor-faults",
+    (PERF_TYPE_SOFTWARE, 6): "major-faults",
+}
+# The upper bits of the config of hardware events select the PMU on hybrid systems
+_EVENT_CONFIG_MASK: int = 0xFFFFFFFF
+
+# struct perf_file_header: magic, size, attr_size, attrs, data and event_types sections
+_FILE_HEADER = struct.Struct("<8sQQQQQQQQ")
+# struct perf_event_attr: type, size, config, sample_period, sample_type and read_format
+_EVENT_ATTR = struct.Struct("<IIQQQQ")
+_FILE_SECTION = struct.Struct("<QQ")
+# struct perf_event_header: type, misc and size
+_EVENT_HEADER = struct.Struct("<IHH")
+_U64 = struct.Struct("<Q")
+_PID_TID = struct.Struct("<II")
+# pid, tid, start, length and page offset of mmap records
+_MMAP = struct.Struct("<IIQQQ")
+# maj, min, ino and ino_generation (or build id), prot and flags of mmap2 records
+_MMAP2_EXTRA_SIZE: int = 32
+# pid, ppid, tid and ptid of fork records
+_FORK = struct.Struct("<IIII")
+
+
+@dataclasses.dataclass(frozen=True)
+class EventAttr:
+    """Attributes of one recorded event
+
+    :ivar int type: type of the event (hardware, software, tracepoint, ...)
+    :ivar int config: the event of the given type
+    :ivar int sample_type: fields recorded in the samples of the event
+    :ivar int read_format: format of the counter values read in the samples
+    :ivar tuple ids: identifiers of the event in the samples
+    """
+
+    __slots__ = ["type", "config", "sample_type", "read_format", "ids"]
+
+    type: int
+    config: int
+    sample_type: int
+    read_format: int
+    ids: tuple[int, ...]
+
+    @property
+    def name(self) -> str:
+        """
+        :return: name of the event as used by perf, or its type and config if it is not generic
+        """
+        config = self.config & _EVENT_CONFIG_MASK
+        return EVENT_NAMES.get((self.type, config), f"{self.type}:{self.config}")
+
+
+class Sample(NamedTuple):
+    """One sample of the recorded event
+
+    :ivar int event: index of the attributes of the sampled event
+    :ivar int misc: miscellaneous flags of the sample (e.g. the cpu mode)
+    :ivar int ip: the sampled instruction pointer
+    :ivar int pid: sampled process
+    :ivar int tid: sampled thread
+    :ivar int period: number of events represented by the sample
+    :ivar tuple values: counter values read in the sample as pairs of identifiers and values
+    :ivar tuple callchain: the sampled callchain, from the innermost call
+    """
+
+    event: int
+    misc: int
+    ip: int
+    pid: int
+    tid: int
+    period: int
+    values: tuple[tuple[int, int], ...]
+    callchain: tuple[int, ...]
+
+
+class PerfData:
+    """Memory mapped data recorded by ``perf record``
+
+    Only the data recorded into the file (not the piped data) are supported.
+
+    :ivar str path: path to the perf data
+    :ivar list attrs: attributes of the recorded events
+    :ivar dict events: map of identifiers of events to indices of their attributes
+    """
+
+    __slots__ = ["path", "attrs", "events", "_file", "_buffer", "_view", "_data", "_id_offset"]
+
+    def __init__(self, path: str) -> None:
+        """Maps the file to the memory and reads the attributes of the recorded events
+
+        :param str path: path to the perf data
+        :raises InvalidPerfDataException: if the data are missing or malformed
+        """
+        self.path = path
+        try:
+            self._file = open(path, "rb")
+        except OSError as exc:
+            raise exceptions.InvalidPerfDataException(path, exc.strerror or str(exc))
+        try:
+            self._buffer = mmap.mmap(self._file.fileno(), 0, access=mmap.ACCESS_READ)
+            self._view = memoryview(self._buffer)
+            self._read_header()
+        except (OSError, ValueError, struct.error) as exc:
+            self.close()
+            raise exceptions.InvalidPerfDataException(path, str(exc) or "malformed data")
+
+    def _read_header(self) -> None:
+        """Reads the header of the file and the attributes of the recorded events"""
+        (
+            magic,
+            _,
+            attr_size,
+            attrs_offset,
+            attrs_size,
+            data_offset,
+            data_size,
+            _,
+            _,
+        ) = _FILE_HEADER.unpack_from(self._buffer)
+        if magic != PERF_MAGIC:
+            raise ValueError("not a perf data file (or the data were recorded into pipe)")
+        if data_offset + data_size > len(self._buffer) or attr_size < _FILE_SECTION.size:
+            raise ValueError("truncated data")
+        self._data = (data_offset, data_offset + data_size)
+        self.attrs: list[EventAttr] = []
+        self.events: dict[int, int] = {}
+        for attr_offset in range(attrs_offset, attrs_offset + attrs_size, attr_size):
+            event_type, _, config, _, sample_type, read_format = _EVENT_ATTR.unpack_from(
+                self._buffer, attr_offset
+            )
+            ids_offset, ids_size = _FILE_SECTION.unpack_from(
+                self._buffer, attr_offset + attr_size - _FILE_SECTION.size
+            )
+            ids = tuple(self._view[ids_offset : ids_offset + ids_size].cast("Q"))
+            self.events.update((event_id, len(self.attrs)) for event_id in ids)
+            self.attrs.append(EventAttr(event_type, config, sample_type, read_format, ids))
+        if not self.attrs:
+            raise ValueError("no recorded events")
+
+        # The samples of different events are told apart by the identifier, which is either at
+        # the beginning of the sample, or after the fixed fields, which all the events share
+        sample_type = self.attrs[0].sample_type
+        self._id_offset: Optional[int] = None
+        if len(self.attrs) > 1 and sample_type & PERF_SAMPLE_IDENTIFIER:
+            self._id_offset = 0
+        elif len(self.attrs) > 1 and sample_type & PERF_SAMPLE_ID:
+            preceding = PERF_SAMPLE_IP | PERF_SAMPLE_TID | PERF_SAMPLE_TIME | PERF_SAMPLE_ADDR
+            self._id_offset = 8 * bin(sample_type & preceding).count("1")
+
+    def close(self) -> None:
+        """Unmaps and closes the file"""
+        if getattr(self, "_view", None) is not None:
+            self._view.release()
+        if getattr(self, "_buffer", None) is not None:
+            self._buffer.close()
+        self._file.close()
+
+    def __enter__(self) -> PerfData:
+        """
+        :return: the opened perf data
+        """
+        return self
+
+    def __exit__(self, *_: Any) -> None:
+        """Closes the data"""
+        self.close()
+
+    def records(self) -> Iterator[tuple[int, int, int, int]]:
+        """Iterates through the records of the data
+
+        :return: iterator of types, misc flags, offsets of the bodies and ends of the records
+        """
+        offset, end = self._data
+        buffer, header_size = self._buffer, _EVENT_HEADER.size
+        while offset + header_size <= end:
+            record_type, misc, size = _EVENT_HEADER.unpack_from(buffer, offset)
+            if size < header_size or offset + size > end:
+                raise exceptions.InvalidPerfDataException(self.path, "truncated record")
+            yield record_type, misc, offset + header_size, offset + size
+            offset += size
+
+    def unpack(self, fields: struct.Struct, offset: int) -> tuple[Any, ...]:
+        """
+        :param struct.Struct fields: format of the unpacked fields
+        :param int offset: offset of the fields
+        :return: the unpacked fields
+        """
+        return fields.unpack_from(self._buffer, offset)
+
+    def string_at(self, offset: int, end: int) -> str:
+        """
+        :param int offset: offset of the null-terminated string
+        :param int end: end of the record containing the string
+        :return: the decoded string
+        """
+        terminator = self._buffer.find(b"\0", offset, end)
+        return self._buffer[offset : end if terminator == -1 else terminator].decode(
+            errors="replace"
+        )
+
+    def sample_at(self, misc: int, offset: int) -> Sample:
+        """Parses the sample record
+
+        :param int misc: misc flags of the record
+        :param int offset: offset of the body of the record
+        :return: the parsed sample
+        """
+        buffer, unpack = self._buffer, _U64.unpack_from
+        event = 0
+        if self._id_offset is not None:
+            event = self.events.get(unpack(buffer, offset + self._id_offset)[0], 0)
+        sample_type = self.attrs[event].sample_type
+
+        if sample_type & PERF_SAMPLE_IDENTIFIER:
+            offset += 8
+        ip = 0
+        if sample_type & PERF_SAMPLE_IP:
+            (ip,) = unpack(buffer, offset)
+            offset += 8
+        pid = tid = 0
+        if sample_type & PERF_SAMPLE_TID:
+            pid, tid = _PID_TID.unpack_from(buffer, offset)
+            offset += 8
+        for skipped in (PERF_SAMPLE_TIME, PERF_SAMPLE_ADDR, PERF_SAMPLE_ID, PERF_SAMPLE_STREAM_ID):
+            if sample_type & skipped:
+                offset += 8
+        if sample_type & PERF_SAMPLE_CPU:
+            offset += 8
+        period = 1
+        if sample_type & PERF_SAMPLE_PERIOD:
+            (period,) = unpack(buffer, offset)
+            offset += 8
+        values: tuple[tuple[int, int], ...] = ()
+        if sample_type & PERF_SAMPLE_READ:
+            values, offset = self._read_values(self.attrs[event].read_format, offset)
+        callchain: tuple[int, ...] = ()
+        if sample_type & PERF_SAMPLE_CALLCHAIN:
+            (length,) = unpack(buffer, offset)
+            callchain = tuple(self._view[offset + 8 : offset + 8 * (length + 1)].cast("Q"))
+        return Sample(event, misc, ip, pid, tid, period, values, callchain)
+
+    def _read_values(
+        self, read_format: int, offset: int
+    ) -> tuple[tuple[tuple[int, int], ...], int]:
+        """Parses the counter values read in the sample
+
+        :param int read_format: format of the read values
+        :param int offset: offset of the read values
+        :return: pairs of identifiers of the events and their values, and offset after the values
+        """
+        buffer, unpack = self._buffer, _U64.unpack_from
+        has_id, has_lost = read_format & PERF_FORMAT_ID, read_format & PERF_FORMAT_LOST
+        times = bin(
+            read_format & (PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING)
+        ).count("1")
+        values = []
+        if read_format & PERF_FORMAT_GROUP:
+            (count,) = unpack(buffer, offset)
+            offset += 8 * (1 + times)
+            for _ in range(count):
+                (value,) = unpack(buffer, offset)
+                event_id = unpack(buffer, offset + 8)[0] if has_id else 0
+                values.append((event_id, value))
+                offset += 8 * (1 + bool(has_id) + bool(has_lost))
+        else:
+            (value,) = unpack(buffer, offset)
+            offset += 8 * (1 + times)
+            event_id = unpack(buffer, offset)[0] if has_id else 0
+            values.append((event_id, value))
+            offset += 8 * (bool(has_id) + bool(has_lost))
+        return tuple(values), offset
+
+
+class Symbolizer:
+    """Resolves the sampled addresses to the names of the frames
+
+    The names of functions are demangled (once for each binary) as by ``perf script``, and
+    tidied the same way as by ``stackcollapse-perf.pl``: unknown functions are named by their
+    module, the separators of the frames are replaced and the arguments are stripped from the
+    signatures.
+
+    :ivar str kallsyms: path to the symbols of the kernel
+    :ivar list kernel_addresses: sorted addresses of the kernel symbols
+    :ivar list kernel_names: names of the kernel symbols
+    :ivar dict binaries: map of paths of the binaries to their symbols (or None if unreadable)
+    """
+
+    __slots__ = ["kallsyms", "kernel_addresses", "kernel_names", "binaries"]
+
+    def __init__(self, kallsyms: str = "/proc/kallsyms") -> None:
+        """
+        :param str kallsyms: path to the symbols of the kernel
+        """
+        self.kallsyms = kallsyms
+        self.kernel_addresses: Optional[list[int]] = None
+        self.kernel_names: list[str] = []
+        self.binaries: dict[str, Optional[symbolization.BinarySymbols]] = {}
+
+    def _load_kernel_symbols(self) -> list[int]:
+        """Loads the text symbols of the kernel and its modules
+
+        :return: sorted addresses of the symbols (empty if the addresses are not available)
+        """
+        symbols = []
+        try:
+            with open(self.kallsyms, "r") as kallsyms:
+                for line in kallsyms:
+                    address, symbol_type, name = line.split()[:3]
+                    if symbol_type in "tTwW" and int(address, 16):
+                        symbols.append((int(address, 16), name))
+        except (OSError, ValueError):
+            symbols = []
+        symbols.sort()
+        self.kernel_names = [name for (_, name) in symbols]
+        self.kernel_addresses = [address for (address, _) in symbols]
+        return self.kernel_addresses
+
+    def kernel_frame(self, address: int) -> str:
+        """
+        :param int address: address in the kernel
+        :return: name of the frame
+        """
+        addresses = self.kernel_addresses
+        if addresses is None:
+            addresses = self._load_kernel_symbols()
+        i = bisect.bisect_right(addresses, address) - 1
+        return tidy_frame(self.kernel_names[i]) if i >= 0 else unknown_frame(KERNEL_MODULE)
+
+    def user_frame(self, path: str, offset: int) -> str:
+        """
+        :param str path: path to the mapped binary
+        :param int offset: offset of the address in the binary
+        :return: name of the frame
+        """
+        if path not in self.binaries:
+            self.binaries[path] = symbolization.load(path)
+        binary = self.binaries[path]
+        function = binary.function_at(offset, demangled=True) if binary is not None else None
+        return tidy_frame(function) if function is not None else unknown_frame(path)
+
+
+def tidy_frame(function: str) -> str:
+    """Cleans the name of the function the same way as ``stackcollapse-perf.pl``
+
+    :param str function: name of the function
+    :return: the name of the frame
+    """
+    function = function.replace(";", ":")
+    if not re.search(r"\.\(.*\)\.", function):
+        function = re.sub(r"\((?!anonymous namespace\)).*", "", function)
+    return function.replace('"', "").replace("'", "")
+
+
+def unknown_frame(module: str) -> str:
+    """
+    :param str module: the module (binary) of the unknown function
+    :return: the name of the frame of the unknown function
+    """
+    return f"[{os.path.basename(module)}]" if module != UNKNOWN_MODULE else "[unknown]"
+
+
+def fold_perf_data(
+    path: str, trie: Optional[StackTrie] = None, symbolizer: Optional[Symbolizer] = None
+) -> StackTrie:
+    """Folds the stacks sampled in the perf data into the trie
+
+    Each stack starts with the name of the sampled thread followed by the frames of its
+    callchain from the outermost one, and is weighted by the period of the sample (as in
+    ``stackcollapse-perf.pl``). Only the samples of the first sampled event are folded.
+
+    :param str path: path to the perf data
+    :param StackTrie trie: trie, into which the stacks are folded (new trie is created if None)
+    :param Symbolizer symbolizer: resolver of the names of frames
+    :return: trie of the folded stacks
+    :raises InvalidPerfDataException: if the data are missing, malformed or unsupported
+    """
+    trie = StackTrie() if trie is None else trie
+    folded: list[StackTrie] = []
+
+    def first_event_trie(_: EventAttr) -> Optional[StackTrie]:
+        """Folds the first sampled event into the trie and skips the others"""
+        if folded:
+            return None
+        folded.append(trie)
+        return trie
+
+    _fold_samples(path, first_event_trie, symbolizer)
+    return trie
+
+
+def fold_perf_events(path: str, symbolizer: Optional[Symbolizer] = None) -> dict[str, StackTrie]:
+    """Folds the stacks sampled in the perf data into separate tries for each sampled event
+
+    The stacks are folded the same way as in :func:`fold_perf_data`, but the samples of each
+    event (e.g. of the events recorded as a group by ``perf record -e '{cycles,instructions}'``)
+    are weighted by their own periods, i.e. by the counts of the event, and folded into their
+    own trie. The addresses shared by the callchains of different events are resolved only once.
+
+    :param str path: path to the perf data
+    :param Symbolizer symbolizer: resolver of the names of frames
+    :return: map of names of the events to the tries of their folded stacks, in the order of
+        their first samples
+    :raises InvalidPerfDataException: if the data are missing, malformed or unsupported
+    """
+    tries: dict[str, StackTrie] = {}
+    _fold_samples(path, lambda attr: tries.setdefault(attr.name, StackTrie()), symbolizer)
+    return tries
+
+
+def _fold_samples(
+    path: str,
+    trie_for: Callable[[EventAttr], Optional[StackTrie]],
+    symbolizer: Optional[Symbolizer] = None,
+) -> None:
+    """Folds the sampled stacks into the tries of the sampled events
+
+    :param str path: path to the perf data
+    :param callable trie_for: returns the trie, into which the samples of the event are folded
+        (or None if they are skipped); it is called once for each event at its first sample
+    :param Symbolizer symbolizer: resolver of the names of frames
+    :raises InvalidPerfDataException: if the data are missing, malformed or unsupported
+    """
+    symbolizer = Symbolizer() if symbolizer is None else symbolizer
+    # Names of threads and address spaces of processes; the maps are only appended (the newer
+    # maps shadow the older ones), hence the state of the space at the time of the sample is
+    # given by the number of its maps
+    comms: dict[int, str] = {}
+    spaces: list[list[tuple[int, int, int, str]]] = []
+    space_of: dict[int, int] = {}
+    chains: dict[tuple[int, str, int, int, tuple[int, ...]], int] = {}
+    event_tries: dict[int, Optional[StackTrie]] = {}
+
+    def space_for(pid: int, new: bool = False) -> int:
+        """Returns the index of the address space of the process, creating one if needed"""
+        if new or pid not in space_of:
+            space_of[pid] = len(spaces)
+            spaces.append([])
+        return space_of[pid]
+
+    with PerfData(path) as data:
+        for record_type, misc, offset, end in data.records():
+            if record_type == PERF_RECORD_SAMPLE:
+                sample = data.sample_at(misc, offset)
+                if sample.event not in event_tries:
+                    event_tries[sample.event] = trie_for(data.attrs[sample.event])
+                if event_tries[sample.event] is None:
+                    continue
+                callchain = sample.callchain
+                if not callchain:
+                    kernel = misc & PERF_RECORD_MISC_CPUMODE_MASK == PERF_RECORD_MISC_KERNEL
+                    context = PERF_CONTEXT_KERNEL if kernel else PERF_CONTEXT_USER
+                    callchain = (context, sample.ip)
+                space = space_for(sample.pid)
+                key = (
+                    sample.event,
+                    comms.get(sample.tid, f":{sample.tid}"),
+                    space,
+                    len(spaces[space]),
+                    callchain,
+                )
+                chains[key] = chains.get(key, 0) + sample.period
+            elif record_type in (PERF_RECORD_MMAP, PERF_RECORD_MMAP2):
+                pid, _, start, length, page_offset = data.unpack(_MMAP, offset)
+                if pid != KERNEL_PID:
+                    name_offset = offset + _MMAP.size
+                    if record_type == PERF_RECORD_MMAP2:
+                        name_offset += _MMAP2_EXTRA_SIZE
+                    spaces[space_for(pid)].append(
+                        (start, start + length, page_offset, data.string_at(name_offset, end))
+                    )
+            elif record_type == PERF_RECORD_COMM:
+                pid, tid = data.unpack(_PID_TID, offset)
+                comms[tid] = data.string_at(offset + _PID_TID.size, end).replace(" ", "_")
+                if misc & PERF_RECORD_MISC_COMM_EXEC:
+                    space_for(pid, new=True)
+            elif record_type == PERF_RECORD_FORK:
+                pid, ppid, tid, ptid = data.unpack(_FORK, offset)
+                if ptid in comms:
+                    comms[tid] = comms[ptid]
+                if pid != ppid and ppid in space_of:
+                    spaces[space_for(pid, new=True)].extend(spaces[space_of[ppid]])
+            elif record_type == PERF_RECORD_COMPRESSED:
+                raise exceptions.InvalidPerfDataException(path, "compressed data are unsupported")
+
+    frames: dict[tuple[int, int, int], str] = {}
+    for (event, comm, space, maps_count, callchain), count in chains.items():
+        stack, in_kernel = [], False
+        for address in callchain:
+            if address >= PERF_CONTEXT_MAX:
+                in_kernel = address == PERF_CONTEXT_KERNEL
+                continue
+            # Kernel addresses are shared by all the spaces
+            frame_key = (-1, 0, address) if in_kernel else (space, maps_count, address)
+            frame = frames.get(frame_key)
+            if frame is None:
+                if in_kernel:
+                    frame = symbolizer.kernel_frame(address)
+                else:
+                    frame = _resolve_user_frame(symbolizer, spaces[space][:maps_count], address)
+                frames[frame_key] = frame
+            stack.append(frame)
+        stack.append(comm)
+        event_trie = event_tries[event]
+        assert event_trie is not None
+        event_trie.add(reversed(stack), count)
+
+
+def _resolve_user_frame(
+    symbolizer: Symbolizer, maps: list[tuple[int, int, int, str]], address: int
+) -> str:
+    """
+    :param Symbolizer symbolizer: resolver of the names of frames
+    :param list maps: maps of the address space, from the oldest one
+    :param int address: the resolved address
+    :return: name of the frame
+    """
+    for start, end, page_offset, path in reversed(maps):
+        if start <= address < end:
+            return symbolizer.user_frame(path, address - start + page_offset)
+    return unknown_frame(UNKNOWN_MODULE)
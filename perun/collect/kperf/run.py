@@ -2,7 +2,8 @@
 from __future__ import annotations
 
 # Standard Imports
-from typing import Any
+from typing import Any, Optional, Sequence
+import os
 import subprocess
 import time
 
@@ -11,12 +12,21 @@ import click
 import progressbar
 
 # Perun Imports
-from perun.collect.kperf import parser
+from perun.collect.kperf import parser, perf_data
 from perun.logic import runner
-from perun.utils import log
+from perun.profile.folding import StackTrie
+from perun.utils import exceptions, log
 from perun.utils.common import script_kit
 from perun.utils.structs import Executable, CollectStatus
-from perun.utils.external import commands
+from perun.utils.external import commands, isolation, processes
+
+
+# Events sampled as a group with the --counters option; the first one is the primary event
+HARDWARE_EVENTS: list[str] = ["cycles", "instructions", "cache-misses", "branch-misses"]
+# Fallback events for machines without accessible PMU (e.g. most of the virtual machines)
+SOFTWARE_EVENTS: list[str] = ["cpu-clock", "page-faults", "context-switches"]
+# The perf data are recorded into the fixed files in the current working directory
+EXCLUSIVE_RESOURCES = ["kperf-data"]
 
 
 def before(**_: Any) -> tuple[CollectStatus, str, dict[str, Any]]:
@@ -30,13 +40,16 @@ def before(**_: Any) -> tuple[CollectStatus, str, dict[str, Any]]:
         all_found = False
         log.minor_fail(f"{log.cmd_style('perf')}", "not-executable")
 
-    # Check that helper script can be run
+    # Check that helper script can be run; it is needed only as the fallback for perf data,
+    # that cannot be read natively
     parse_script = script_kit.get_script("stackcollapse-perf.pl")
-    if commands.is_executable(f'echo "" | {parse_script}'):
+    if stackcollapse_available():
         log.minor_success(f"{log.cmd_style(parse_script)}", "executable")
     else:
-        all_found = False
-        log.minor_fail(f"{log.cmd_style(parse_script)}", "not-executable")
+        log.warn(
+            f"{log.cmd_style(parse_script)} is not executable: perf data that cannot be read"
+            f" natively (e.g. compressed ones) cannot be collected"
+        )
 
     if not all_found:
         log.minor_fail("Checking dependencies")
@@ -47,29 +60,110 @@ def before(**_: Any) -> tuple[CollectStatus, str, dict[str, Any]]:
     return CollectStatus.OK, "", {}
 
 
-def run_perf(executable: Executable, run_with_sudo: bool = False) -> str:
-    """Runs perf and obtains the output
+def stackcollapse_available() -> bool:
+    """Checks that the stackcollapse-perf.pl script (used for folding the output of perf script)
+    can be run
+
+    :return: true if the script is executable
+    """
+    return commands.is_executable(f'echo "" | {script_kit.get_script("stackcollapse-perf.pl")}')
+
+
+def hardware_counters_available(run_with_sudo: bool = False) -> bool:
+    """Checks that all hardware events can be counted, i.e. that the PMU is accessible
 
-    :param executable: run executable profiled by perf
     :param run_with_sudo: if the command should be run with sudo
-    :return: parsed output of perf
+    :return: true if all hardware events are supported
     """
-    parse_script = script_kit.get_script("stackcollapse-perf.pl")
+    sudo = "sudo " if run_with_sudo else ""
+    perf_stat_command = f"{sudo}perf stat -x, -e {','.join(HARDWARE_EVENTS)} true"
+    try:
+        _, err = commands.run_safely_external_command(perf_stat_command)
+    except (subprocess.CalledProcessError, OSError):
+        return False
+    output = err.decode("utf-8")
+    return "<not supported>" not in output and "<not counted>" not in output
 
-    if run_with_sudo:
-        perf_record_command = f"sudo perf record -q -g -o collected.data {executable}"
-        perf_script_command = f"sudo perf script -i collected.data | {parse_script}"
-    else:
-        perf_record_command = f"perf record -q -g -o collected.data {executable}"
-        perf_script_command = f"perf script -i collected.data | {parse_script}"
+
+def select_events(run_with_sudo: bool = False) -> list[str]:
+    """Selects the events sampled by the --counters option
+
+    :param run_with_sudo: if the command should be run with sudo
+    :return: hardware events, or the software events if the hardware ones cannot be counted
+    """
+    if hardware_counters_available(run_with_sudo):
+        log.minor_success("hardware counters", "available")
+        return HARDWARE_EVENTS
+    log.warn(
+        "hardware counters are not available (e.g. in virtual machine), "
+        f"sampling software events {', '.join(SOFTWARE_EVENTS)} instead"
+    )
+    return SOFTWARE_EVENTS
+
+
+def run_perf(
+    executable: Executable,
+    run_with_sudo: bool = False,
+    events: Sequence[str] = (),
+    output_file: str = "collected.data",
+    cgroup: Optional[isolation.CGroup] = None,
+) -> tuple[StackTrie, dict[str, StackTrie]]:
+    """Runs perf and folds the sampled stacks
+
+    The recorded data are read natively (see :mod:`perun.collect.kperf.perf_data`); only if they
+    cannot be read (e.g. they are owned by root or in unsupported format), they are converted by
+    perf script and folded by stackcollapse-perf.pl. If the events are given, they are sampled as
+    a single group and the stacks of each event are folded separately; the fallback through perf
+    script folds only the first sampled event (as the primary one).
+
+    :param executable: run executable profiled by perf
+    :param run_with_sudo: if the command should be run with sudo
+    :param events: sampled events (the default event of perf is sampled if empty)
+    :param output_file: file, into which perf records the data
+    :param cgroup: cgroup limiting the resources of perf and the profiled executable
+    :return: trie of stacks folded from the output of perf for the primary event, and the tries
+        of the further events
+    :raises MissingDependencyException: if the data cannot be read natively and the fallback
+        stackcollapse-perf.pl script is not executable
+    """
+    sudo = "sudo " if run_with_sudo else ""
+    event_group = f"-e {{{','.join(events)}}} " if events else ""
+    perf_record_command = f"{sudo}perf record -q -g {event_group}-o {output_file} {executable}"
 
     try:
-        commands.run_safely_external_command(perf_record_command)
-        out, _ = commands.run_safely_external_command(perf_script_command)
+        if cgroup is not None and cgroup.path is not None:
+            processes.run_measured(perf_record_command, cgroup=cgroup.path)
+        else:
+            commands.run_safely_external_command(perf_record_command)
+        try:
+            if events:
+                tries = perf_data.fold_perf_events(output_file)
+                trie = tries.pop(events[0], StackTrie())
+            else:
+                trie, tries = perf_data.fold_perf_data(output_file), {}
+        except exceptions.InvalidPerfDataException as exc:
+            if not stackcollapse_available():
+                raise exceptions.MissingDependencyException("stackcollapse-perf.pl") from exc
+            log.minor_info(f"{exc}, falling back to {log.cmd_style('perf script')}")
+            trie = parser.fold_events(run_perf_script(sudo, output_file).splitlines())
+            tries = {}
         log.minor_success(f"Raw data from {log.cmd_style(str(executable))}", "collected")
     except subprocess.CalledProcessError:
         log.minor_fail(f"Raw data from {log.cmd_style(str(executable))}", "not collected")
-        return ""
+        return StackTrie(), {}
+    return trie, tries
+
+
+def run_perf_script(sudo: str = "", input_file: str = "collected.data") -> str:
+    """Converts the recorded data by perf script and folds them by stackcollapse-perf.pl
+
+    :param sudo: prefix of the command, if it should be run with sudo
+    :param input_file: file with the data recorded by perf
+    :return: folded stacks in the format of stackcollapse-perf.pl
+    """
+    parse_script = script_kit.get_script("stackcollapse-perf.pl")
+    perf_script_command = f"{sudo}perf script -i {input_file} | {parse_script}"
+    out, _ = commands.run_safely_external_command(perf_script_command)
     return out.decode("utf-8")
 
 
@@ -78,22 +172,75 @@ def collect(executable: Executable, **kwargs: Any) -> tuple[CollectStatus, str,
     log.major_info("Collecting performance data")
     warmups = kwargs["warmup"]
     repeats = kwargs["repeat"]
+    with_sudo = kwargs.get("with_sudo", False)
+    events = select_events(with_sudo) if kwargs.get("counters", False) else []
+    limits = (kwargs.get("memory_limit"), kwargs.get("cpu_limit"))
+    if kwargs.get("parallel", 1) > 1 or limits != (None, None):
+        return collect_isolated(executable, events, **kwargs)
 
     log.minor_info(f"Running {log.highlight(warmups)} warmup iterations")
     for _ in progressbar.progressbar(range(0, warmups)):
-        run_perf(executable, kwargs.get("with_sudo", False))
+        run_perf(executable, with_sudo, events)
 
     log.minor_info(f"Running {log.highlight(repeats)} iterations")
     before_time = time.time()
-    kwargs["raw_data"] = []
+    # The stacks of each repetition are merged as soon as they are collected
+    kwargs["raw_data"] = parser.StackStatistics(events[0] if events else None)
     for _ in progressbar.progressbar(range(0, repeats)):
-        output = run_perf(executable, kwargs.get("with_sudo", False))
-        kwargs["raw_data"].extend(output.splitlines())
+        kwargs["raw_data"].add(*run_perf(executable, with_sudo, events))
     kwargs["time"] = time.time() - before_time
 
     return CollectStatus.OK, "", kwargs
 
 
+def collect_isolated(
+    executable: Executable, events: list[str], **kwargs: Any
+) -> tuple[CollectStatus, str, dict[str, Any]]:
+    """Runs the repetitions concurrently, isolated on disjoint cpus and in their own cgroups
+
+    Since the stacks are aggregated across the repetitions, the placements of the repetitions
+    are stored in the header of the profile.
+    """
+    with_sudo = kwargs.get("with_sudo", False)
+    placements = isolation.split_to_placements(kwargs.get("parallel", 1))
+    for placement in placements:
+        log.minor_status(
+            f"Slot {placement.slot}",
+            status=log.highlight(isolation.format_cpu_list(placement.cpus)),
+        )
+
+    with isolation.slot_cgroups(
+        f"perun-kperf-{os.getpid()}",
+        len(placements),
+        kwargs.get("memory_limit"),
+        kwargs.get("cpu_limit"),
+    ) as cgroups:
+
+        def run(placement: isolation.Placement, _: int) -> tuple[StackTrie, dict[str, StackTrie]]:
+            """Runs perf in the cgroup of its slot, recording into the file of the slot"""
+            output_file = f"collected-{placement.slot}.data"
+            return run_perf(executable, with_sudo, events, output_file, cgroups[placement.slot])
+
+        # Each slot is warmed up, so none of them starts the measured runs cold
+        log.minor_info(f"Running {log.highlight(kwargs['warmup'])} warmup iterations per slot")
+        isolation.run_in_placements(placements, kwargs["warmup"] * len(placements), run)
+        log.minor_info(f"Running {log.highlight(kwargs['repeat'])} iterations")
+        before_time = time.time()
+        runs = isolation.run_in_placements(placements, kwargs["repeat"], run)
+        kwargs["time"] = time.time() - before_time
+        # The repetitions are assigned to the slots in the round-robin fashion
+        slots = [order % len(placements) for order in range(len(runs))]
+        kwargs["placements"] = [
+            {"repetition": order} | placements[slot].to_resource(cgroups[slot])
+            for order, slot in enumerate(slots, 1)
+        ]
+
+    kwargs["raw_data"] = parser.StackStatistics(events[0] if events else None)
+    for run_trie, event_tries in runs:
+        kwargs["raw_data"].add(run_trie, event_tries)
+    return CollectStatus.OK, "", kwargs
+
+
 def after(**kwargs: Any) -> tuple[CollectStatus, str, dict[str, Any]]:
     """Parses the raw data into performance profile"""
     log.major_info("Creating performance profile")
@@ -111,6 +258,8 @@ def after(**kwargs: Any) -> tuple[CollectStatus, str, dict[str, Any]]:
             "resources": resources,
         }
     }
+    if "placements" in kwargs:
+        kwargs["profile"]["header"] = {"placements": kwargs["placements"]}
     return CollectStatus.OK, "", kwargs
 
 
@@ -124,7 +273,7 @@ def after(**kwargs: Any) -> tuple[CollectStatus, str, dict[str, Any]]:
     "-w",
     default=3,
     type=click.INT,
-    help="Runs [INT] warm up iterations of profiled command.",
+    help="Runs [INT] warm up iterations of profiled command (in each of the parallel slots).",
 )
 @click.option(
     "--repeat",
@@ -133,6 +282,48 @@ def after(**kwargs: Any) -> tuple[CollectStatus, str, dict[str, Any]]:
     type=click.INT,
     help="Runs [INT] samplings of the profiled command.",
 )
+@click.option(
+    "--counters",
+    "-c",
+    is_flag=True,
+    default=False,
+    help=(
+        f"Samples the hardware events {', '.join(HARDWARE_EVENTS)} as a group and derives the"
+        " IPC and miss rates of the stacks from their counts. If the hardware counters are not"
+        f" available, samples the software events {', '.join(SOFTWARE_EVENTS)} instead."
+    ),
+)
+@click.option(
+    "--parallel",
+    "-P",
+    default=1,
+    type=click.IntRange(min=1),
+    metavar="<int>",
+    help=(
+        "Runs <int> repetitions concurrently, each pinned to its own disjoint set of cpus (from"
+        " distinct NUMA nodes, if possible)."
+    ),
+)
+@click.option(
+    "--memory-limit",
+    "-ml",
+    default=None,
+    metavar="<size>",
+    help="Limits the memory of each run (e.g. 512M) by its own cgroup (requires cgroup v2).",
+)
+@click.option(
+    "--cpu-limit",
+    "-cpl",
+    default=None,
+    type=click.FloatRange(min=0, min_open=True),
+    metavar="<float>",
+    help="Limits the number of cpus used by each run by its own cgroup (requires cgroup v2).",
+)
 def kperf(ctx: click.Context, **kwargs: Any) -> None:
-    """Generates kernel sampled traces for specific commands based on perf."""
+    """Generates kernel sampled traces for specific commands based on perf.
+
+    The samples are aggregated across the repetitions: the `amount` of each resource is the mean
+    number of samples per repetition (a float), accompanied by their `variance` and the number of
+    `runs`. Hence, the totals of the flame graphs are the samples of an average run.
+    """
     runner.run_collector_from_cli_context(ctx, "kperf", kwargs)
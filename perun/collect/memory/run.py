@@ -18,6 +18,8 @@ from perun.utils.structs import CollectStatus, Executable
 _lib_name: str = "malloc.so"
 _tmp_log_filename: str = "MemoryLog"
 DEFAULT_SAMPLING: float = 0.001
+# The allocations are logged into the fixed temporary file
+EXCLUSIVE_RESOURCES: list[str] = ["memory-log"]
 
 
 def before(executable: Executable, **_: Any) -> tuple[CollectStatus, str, dict[str, Any]]:
@@ -11,6 +11,7 @@ import subprocess
 # Perun Imports
 
 from perun.utils.exceptions import SuppressedExceptions
+from perun.utils.external import symbolization
 
 if TYPE_CHECKING:
     from perun.utils.structs import Executable
@@ -50,8 +51,9 @@ def demangle(name: str) -> str:
 def build_address_to_line_cache(addresses: set[tuple[str, str]], binary_name: str) -> None:
     """Builds global cache for address_to_line() function calls.
 
-    Instead of continuous calls to subprocess, this takes all of collected
-    names and calls the addr2line just once.
+    The addresses are resolved by the line table of the binary shared (and cached on disk) by
+    :mod:`perun.utils.external.symbolization`. Only if the binary has no readable line table,
+    all of the collected addresses are translated by the single call of addr2line.
 
     :param set addresses: set of addresses that will be translated to line info
     :param str binary_name: name of the binary which will be parsed for info
@@ -60,6 +62,14 @@ def build_address_to_line_cache(addresses: set[tuple[str, str]], binary_name: st
 
     list_of_addresses = [a[0] for a in addresses if PATTERN_HEXADECIMAL.match(a[0])]
 
+    binary = symbolization.load(binary_name)
+    if binary is not None and binary.line_starts:
+        address_to_line_cache = {}
+        for address in list_of_addresses:
+            line = binary.line_at(int(address, 16))
+            address_to_line_cache[address] = [line[0], str(line[1])] if line else ["??", "0"]
+        return
+
     sys_call = ["addr2line", "-e", binary_name] + list_of_addresses
     output = subprocess.check_output(sys_call).decode("utf-8").strip()
     address_to_line_cache = dict(
@@ -1,4 +1,4 @@
-"""Time collector collects is a simple wrapper over the time utility. There is
+"""Time collector is a simple native replacement of the time utility. There is
 nothing special about this, the profiles are simple, and no visualization is
 especially suitable for this mode.
 """
@@ -0,0 +1,150 @@
+"""Adaptive warm-up and repetition of the timing with statistical stopping.
+
+Instead of running the fixed number of warm-ups and repetitions, the command is warmed up until
+its running times reach the steady state, i.e. until the mean of the last few runs no longer
+drifts from the mean of the runs before them (more than their own noise), and then it is timed
+until the confidence interval of the mean (or the median) of its running times is narrower than
+the target width relative to the estimate. Both phases are bounded by the time budget, hence the
+stable benchmarks are timed only as many times as needed, while the noisy ones are timed as long
+as the budget allows.
+"""
+from __future__ import annotations
+
+# Standard Imports
+from typing import Any, Callable
+import math
+import statistics
+import time
+
+# Third-Party Imports
+from scipy import stats
+
+# Perun Imports
+from perun.utils.external import processes
+
+
+# Number of runs, whose mean is compared with the mean of the preceding runs in the warm-up
+STEADY_STATE_WINDOW: int = 3
+# Share of the time budget, which can be spent in the warm-up
+WARMUP_BUDGET_SHARE: float = 0.5
+STATISTICS: tuple[str, ...] = ("mean", "median")
+
+
+def confidence_interval(
+    values: list[float], level: float = 0.95, statistic: str = "mean"
+) -> tuple[float, float]:
+    """Computes the two-sided confidence interval of the mean or the median of the values
+
+    The interval of the mean is based on the Student's t-distribution, while the interval of the
+    median is distribution-free, given by the order statistics of the values.
+
+    :param list values: measured values
+    :param float level: confidence level of the interval
+    :param str statistic: estimated statistic (mean or median)
+    :return: the lower and upper bound of the interval (infinite if there are too few values)
+    """
+    count = len(values)
+    if statistic == "median":
+        # The ranks of the bounds follow from the binomial distribution of values under median
+        rank = int(stats.binom.ppf((1 - level) / 2, count, 0.5)) if count else 0
+        if rank < 1:
+            return -math.inf, math.inf
+        ordered = sorted(values)
+        return ordered[rank - 1], ordered[count - rank]
+    if count < 2:
+        return -math.inf, math.inf
+    mean = statistics.fmean(values)
+    half_width = stats.t.ppf((1 + level) / 2, count - 1) * statistics.stdev(values, mean)
+    half_width /= math.sqrt(count)
+    return mean - half_width, mean + half_width
+
+
+def relative_width(values: list[float], level: float = 0.95, statistic: str = "mean") -> float:
+    """
+    :param list values: measured values
+    :param float level: confidence level of the interval
+    :param str statistic: estimated statistic (mean or median)
+    :return: width of the confidence interval relative to the estimated statistic
+    """
+    lower, upper = confidence_interval(values, level, statistic)
+    estimate = statistics.median(values) if statistic == "median" else statistics.fmean(values)
+    return (
+        (upper - lower) / abs(estimate) if estimate and math.isfinite(upper - lower) else math.inf
+    )
+
+
+def is_steady(values: list[float], tolerance: float) -> bool:
+    """Checks that the values reached the steady state
+
+    The values are steady, if the mean of the last runs differs from the mean of the runs
+    preceding them by at most the tolerance, or by at most the standard deviation of the last
+    runs (i.e. the drift is hidden in the noise of the runs).
+
+    :param list values: values measured in the order of the runs
+    :param float tolerance: maximal relative difference of the means
+    :return: true if the last values no longer drift
+    """
+    if len(values) < 2 * STEADY_STATE_WINDOW:
+        return False
+    last = values[-STEADY_STATE_WINDOW:]
+    preceding = statistics.fmean(values[-2 * STEADY_STATE_WINDOW : -STEADY_STATE_WINDOW])
+    drift = abs(statistics.fmean(last) - preceding)
+    return drift <= tolerance * abs(preceding) or drift <= statistics.stdev(last)
+
+
+def time_adaptively(
+    measure: Callable[[], processes.ProcessUsage],
+    warmup: int = 3,
+    repeat: int = 10,
+    target_width: float = 0.02,
+    level: float = 0.95,
+    statistic: str = "mean",
+    time_budget: float = 60.0,
+) -> tuple[list[processes.ProcessUsage], dict[str, Any]]:
+    """Warms up and times the measured runs until the estimate of their wall time is confident
+
+    The warm-up runs at least @p warmup times and stops at the steady state (with the target
+    width as the tolerance of the drift) or when it used its share of the time budget. The timing
+    runs at least @p repeat times (but at least twice) and stops, when the confidence interval
+    is narrower than the target width, or when the time budget is exhausted.
+
+    :param callable measure: runs the command once and returns its measured usage
+    :param int warmup: minimal number of warm-up runs
+    :param int repeat: minimal number of timed runs
+    :param float target_width: target width of the confidence interval relative to the estimate
+    :param float level: confidence level of the interval
+    :param str statistic: estimated statistic of the wall time (mean or median)
+    :param float time_budget: maximal time in seconds spent by warming up and timing
+    :return: measured usages of the timed runs and the achieved confidence of the estimate
+    """
+    start = time.monotonic()
+    warmup_times: list[float] = []
+    while len(warmup_times) < warmup or not is_steady(warmup_times, target_width):
+        if time.monotonic() - start >= WARMUP_BUDGET_SHARE * time_budget:
+            break
+        warmup_times.append(measure().wall_time / 1e9)
+
+    runs: list[processes.ProcessUsage] = []
+    times: list[float] = []
+    width = math.inf
+    while len(runs) < max(repeat, 2) or width > target_width:
+        if len(runs) >= 2 and time.monotonic() - start >= time_budget:
+            break
+        runs.append(measure())
+        times.append(runs[-1].wall_time / 1e9)
+        width = relative_width(times, level, statistic)
+
+    # The unbounded intervals (of too few runs) are not representable in the profile
+    lower, upper = confidence_interval(times, level, statistic)
+    return runs, {
+        "statistic": statistic,
+        "level": level,
+        "lower": lower if math.isfinite(lower) else None,
+        "upper": upper if math.isfinite(upper) else None,
+        "relative_width": width if math.isfinite(width) else None,
+        "target_width": target_width,
+        "converged": width <= target_width,
+        "steady_state": is_steady(warmup_times, target_width),
+        "warmups": len(warmup_times),
+        "repetitions": len(runs),
+    }
@@ -1,12 +1,15 @@
-"""A wrapper of the classical time linux utility.
+"""A native replacement of the classical time linux utility.
 
 Time collects the runtime of given commands with repetition of the measurements. First we do a
-several warm-up executions, followed by the actual timing.
+several warm-up executions, followed by the actual timing. Each run is spawned directly (without
+any shell or wrapper) and its resource usage is collected from the kernel, hence the wall time
+has a nanosecond resolution and even short benchmarks can be measured.
 """
 from __future__ import annotations
 
 # Standard Imports
-from typing import Any
+from typing import Any, Optional
+import os
 import time as systime
 
 # Third-Party Imports
@@ -14,51 +17,112 @@ import click
 import progressbar
 
 # Perun Imports
+from perun.collect.time import adaptive as adaptive_timing
 from perun.logic import runner
 from perun.utils import log
 from perun.utils.common import common_kit
-from perun.utils.external import commands
+from perun.utils.external import isolation, processes
 from perun.utils.structs import CollectStatus, Executable
 
 
 TIME_TYPES = ("real", "user", "sys")
+# Resources used by each run, which are stored in its `real` resource
+USAGE_KEYS: dict[str, str] = {
+    "max-rss": "max_rss",
+    "voluntary-switches": "voluntary_switches",
+    "involuntary-switches": "involuntary_switches",
+    "minor-faults": "minor_faults",
+    "major-faults": "major_faults",
+}
 
 
 def collect(
-    executable: Executable, repeat: int = 10, warmup: int = 3, **_: Any
+    executable: Executable,
+    repeat: int = 10,
+    warmup: int = 3,
+    pin_cpus: Optional[str] = None,
+    adaptive: bool = False,
+    target_width: float = 0.02,
+    confidence_level: float = 0.95,
+    statistic: str = "mean",
+    time_budget: float = 60.0,
+    parallel: int = 1,
+    memory_limit: Optional[str] = None,
+    cpu_limit: Optional[float] = None,
+    **_: Any,
 ) -> tuple[CollectStatus, str, dict[str, Any]]:
     """Times the runtime of the given command, with stated repeats.
 
+    In the adaptive mode, the warm-up and repeats are only the minimal numbers of runs (see
+    :func:`perun.collect.time.adaptive.time_adaptively`) and the achieved confidence of the
+    estimated wall time is stored in the header of the profile. Otherwise, the runs can be
+    isolated (see :func:`time_isolated`), and their placements are stored in their resources.
+    The runs are limited by their cgroup (see :func:`perun.utils.external.isolation.slot_cgroups`)
+    in both modes.
+
     :param Executable executable: executed command, with arguments and workloads
     :param int warmup: number of warm-up phases, i.e. number of times the binary will be run, but
         the resulting collection will not be stored
     :param int repeat: number of repeats of the timing, by default 10
+    :param str pin_cpus: list of cpus (e.g. 0-3,8), to which the command is pinned
+    :param bool adaptive: if set to true, then the numbers of runs are chosen adaptively
+    :param float target_width: target width of the confidence interval relative to the estimate
+    :param float confidence_level: confidence level of the interval
+    :param str statistic: estimated statistic of the wall time (mean or median)
+    :param float time_budget: maximal time in seconds spent by the adaptive timing
+    :param int parallel: number of runs running concurrently on disjoint cpus
+    :param str memory_limit: maximal memory of each run limited by cgroup (e.g. 512M)
+    :param float cpu_limit: maximal number of cpus used by each run limited by cgroup
     :param dict _: dictionary with key, value options
     :return:
     """
     log.major_info("Running time collector")
-    log.minor_info("Warming up")
-    for _ in progressbar.progressbar(range(0, warmup)):
-        command = " ".join(["time -p", str(executable)]).split(" ")
-        commands.get_stdout_from_external_command(command).split("\n")
-    log.newline()
-
-    log.minor_info(f"Timing {executable.cmd} {common_kit.str_to_plural(repeat, 'time')}")
-    times = []
-
+    cpus = processes.parse_cpu_list(pin_cpus) if pin_cpus else None
+    header: dict[str, Any] = {}
+    placements: list[dict[str, Any]] = []
     before_timing = systime.time()
-    for timing in progressbar.progressbar(range(1, repeat + 1)):
-        command = " ".join(["time -p", str(executable)]).split(" ")
-        collected_data = commands.get_stdout_from_external_command(command).split("\n")
-
-        times.extend(
-            [
-                (timing, t[0], t[1])
-                for t in map(lambda x: x.split(" "), collected_data)
-                if len(t) == 2 and t[0] in TIME_TYPES
-            ]
+    if adaptive and parallel > 1:
+        log.warn("the adaptive timing is sequential, ignoring the parallel runs")
+    if adaptive:
+        log.minor_info(f"Timing {executable.cmd} adaptively")
+        with isolation.slot_cgroups(
+            f"perun-time-{os.getpid()}", 1, memory_limit, cpu_limit
+        ) as cgroups:
+            usages, confidence = adaptive_timing.time_adaptively(
+                lambda: processes.run_measured(str(executable), cpus, cgroup=cgroups[0].path),
+                warmup,
+                repeat,
+                target_width,
+                confidence_level,
+                statistic,
+                time_budget,
+            )
+        header["confidence"] = confidence
+        log.minor_status("Warm-up runs", status=log.highlight(confidence["warmups"]))
+        log.minor_status("Timed runs", status=log.highlight(confidence["repetitions"]))
+        if confidence["converged"]:
+            log.minor_success(f"Confidence interval of {statistic}", "converged")
+        else:
+            log.minor_fail(f"Confidence interval of {statistic}", "not converged")
+    elif parallel > 1 or memory_limit is not None or cpu_limit is not None:
+        log.minor_info(f"Timing {executable.cmd} {common_kit.str_to_plural(repeat, 'time')}")
+        runs = time_isolated(
+            str(executable), warmup, repeat, cpus, parallel, memory_limit, cpu_limit
         )
-    log.newline()
+        usages, placements = [usage for (usage, _) in runs], [placement for (_, placement) in runs]
+    else:
+        log.minor_info("Warming up")
+        for _ in progressbar.progressbar(range(0, warmup)):
+            processes.run_measured(str(executable), cpus)
+        log.newline()
+
+        log.minor_info(f"Timing {executable.cmd} {common_kit.str_to_plural(repeat, 'time')}")
+        before_timing = systime.time()
+        usages = [
+            processes.run_measured(str(executable), cpus)
+            for _ in progressbar.progressbar(range(0, repeat))
+        ]
+        log.newline()
     overall_time = systime.time() - before_timing
 
     return (
@@ -66,24 +130,103 @@ def collect(
         "",
         {
             "profile": {
+                "header": header,
                 "global": {
                     "timestamp": overall_time,
                     "resources": [
-                        {
-                            "amount": float(timing),
-                            "uid": executable.cmd,
-                            "order": order,
-                            "subtype": key,
-                            "type": "time",
-                        }
-                        for (order, key, timing) in times
+                        resource
+                        for (order, usage) in enumerate(usages, 1)
+                        for resource in usage_to_resources(
+                            executable.cmd,
+                            order,
+                            usage,
+                            placements[order - 1] if placements else None,
+                        )
                     ],
-                }
+                },
             }
         },
     )
 
 
+def time_isolated(
+    command: str,
+    warmup: int,
+    repeat: int,
+    cpus: Optional[set[int]] = None,
+    parallel: int = 1,
+    memory_limit: Optional[str] = None,
+    cpu_limit: Optional[float] = None,
+) -> list[tuple[processes.ProcessUsage, dict[str, Any]]]:
+    """Times the command in concurrent slots isolated on disjoint cpus and in their own cgroups
+
+    See :func:`perun.utils.external.isolation.split_to_placements` for how the cpus are split to
+    the slots.
+
+    :param str command: timed command
+    :param int warmup: number of warm-up runs of each slot
+    :param int repeat: number of timed runs
+    :param set cpus: cpus split among the slots (the affinity of the collector if None)
+    :param int parallel: number of concurrent slots
+    :param str memory_limit: maximal memory of each run limited by cgroup (e.g. 512M)
+    :param float cpu_limit: maximal number of cpus used by each run limited by cgroup
+    :return: used resources and placement of each timed run
+    """
+    placements = isolation.split_to_placements(parallel, cpus)
+    for placement in placements:
+        log.minor_status(
+            f"Slot {placement.slot}",
+            status=log.highlight(isolation.format_cpu_list(placement.cpus)),
+        )
+
+    with isolation.slot_cgroups(
+        f"perun-time-{os.getpid()}", len(placements), memory_limit, cpu_limit
+    ) as cgroups:
+
+        def run(placement: isolation.Placement, _: int) -> processes.ProcessUsage:
+            """Runs the command in the cgroup of its slot"""
+            return processes.run_measured(command, cgroup=cgroups[placement.slot].path)
+
+        # Each slot is warmed up, so none of them starts the timed runs cold
+        isolation.run_in_placements(placements, warmup * len(placements), run)
+        return isolation.run_in_placements(
+            placements,
+            repeat,
+            lambda placement, order: (
+                run(placement, order),
+                placement.to_resource(cgroups[placement.slot]),
+            ),
+        )
+
+
+def usage_to_resources(
+    uid: str,
+    order: int,
+    usage: processes.ProcessUsage,
+    placement: Optional[dict[str, Any]] = None,
+) -> list[dict[str, Any]]:
+    """Converts the resources used by one run of the command to the resources of the profile
+
+    :param str uid: uid of the resources
+    :param int order: order of the run
+    :param ProcessUsage usage: resources used by the run
+    :param dict placement: placement of the run, if it was isolated
+    :return: the real, user and sys time resources; the real time resource further contains the
+        memory, context switches, page faults and placement of the run (the unknown usages of the
+        run are omitted)
+    """
+    amounts = (usage.wall_time / 1e9, usage.user_time, usage.system_time)
+    resources = [
+        {"amount": amount, "uid": uid, "order": order, "subtype": key, "type": "time"}
+        for (key, amount) in zip(TIME_TYPES, amounts)
+    ]
+    for key, attribute in USAGE_KEYS.items():
+        if (value := getattr(usage, attribute)) is not None:
+            resources[0][key] = value
+    resources[0].update(placement or {})
+    return resources
+
+
 @click.command()
 @click.option(
     "--warmup",
@@ -93,7 +236,10 @@ def collect(
     nargs=1,
     type=click.INT,
     metavar="<int>",
-    help="Before the actual timing, the collector will execute <int> warm-up executions.",
+    help=(
+        "Before the actual timing, the collector will execute <int> warm-up executions"
+        " (in each of the slots, if run in parallel)."
+    ),
 )
 @click.option(
     "--repeat",
@@ -104,6 +250,82 @@ def collect(
     metavar="<int>",
     help="The timing of the given binaries will be repeated <int> times.",
 )
+@click.option(
+    "--pin-cpus",
+    "-p",
+    default=None,
+    nargs=1,
+    metavar="<list>",
+    help="Pins the timed command to the given cpus (e.g. 0-3,8).",
+)
+@click.option(
+    "--adaptive",
+    "-a",
+    is_flag=True,
+    default=False,
+    help=(
+        "Warms up until the running times are steady and repeats the timing until the"
+        " confidence interval is narrower than the target width, or until the time budget is"
+        " exhausted. The --warmup and --repeat then set the minimal numbers of runs."
+    ),
+)
+@click.option(
+    "--target-width",
+    "-tw",
+    default=0.02,
+    type=click.FloatRange(min=0, min_open=True),
+    metavar="<float>",
+    help="Target width of the confidence interval relative to the estimate (default=0.02).",
+)
+@click.option(
+    "--confidence-level",
+    "-cl",
+    default=0.95,
+    type=click.FloatRange(min=0, max=1, min_open=True, max_open=True),
+    metavar="<float>",
+    help="Confidence level of the interval (default=0.95).",
+)
+@click.option(
+    "--statistic",
+    "-s",
+    default="mean",
+    type=click.Choice(adaptive_timing.STATISTICS),
+    help="Statistic of the running times estimated in the adaptive mode (default=mean).",
+)
+@click.option(
+    "--time-budget",
+    "-tb",
+    default=60.0,
+    type=click.FloatRange(min=0),
+    metavar="<float>",
+    help="Maximal time in seconds spent by the adaptive timing (default=60).",
+)
+@click.option(
+    "--parallel",
+    "-P",
+    default=1,
+    type=click.IntRange(min=1),
+    metavar="<int>",
+    help=(
+        "Runs <int> repetitions concurrently, each pinned to its own disjoint set of cpus (from"
+        " distinct NUMA nodes, if possible)."
+    ),
+)
+@click.option(
+    "--memory-limit",
+    "-ml",
+    default=None,
+    metavar="<size>",
+    help="Limits the memory of each run (e.g. 512M) by its own cgroup (requires cgroup v2).",
+)
+@click.option(
+    "--cpu-limit",
+    "-cpl",
+    default=None,
+    type=click.FloatRange(min=0, min_open=True),
+    metavar="<float>",
+    help="Limits the number of cpus used by each run by its own cgroup (requires cgroup v2).",
+)
 @click.pass_context
 def time(ctx: click.Context, **kwargs: Any) -> None:
     """Generates `time` performance profile, capturing overall running times of
@@ -115,8 +337,8 @@ def time(ctx: click.Context, **kwargs: Any) -> None:
       * **Dependencies**: `none`
       * **Default units**: `s`
 
-    This is a wrapper over the ``time`` linux utility and captures resources
-    in the following form:
+    This is a native replacement of the ``time`` linux utility and captures
+    resources in the following form:
 
     .. code-block:: json
 
@@ -129,6 +351,20 @@ def time(ctx: click.Context, **kwargs: Any) -> None:
             "order": 1
         }
 
+    In the adaptive mode, the header of the profile further contains the
+    achieved `confidence` of the estimated statistic of the running times. The
+    adaptive runs are limited by their cgroup as well, but never run concurrently.
+
+    The resources of the `real` subtype further contain the maximum resident
+    set size (`max-rss`, in kilobytes), the numbers of `voluntary-switches`
+    and `involuntary-switches` of the context and the numbers of `minor-faults`
+    and `major-faults` of the pages of the run. The `max-rss` of the run is
+    omitted, if it does not exceed the peak memory of the small process spawning
+    the runs (a few megabytes), since its memory is accounted to the runs as
+    well. If the runs are
+    isolated, then it also contains the `slot`, the `cpus`, the `numa-node` (if
+    known) and the `cgroup` of the run.
+
     Refer to :ref:`collectors-time` for more thorough description and examples
     of `trace` collector.
     """
@@ -27,6 +27,9 @@ import perun.utils.metrics as metrics
 from perun.profile.factory import Profile
 from perun.utils.structs import CollectStatus
 
+# The engines load kernel modules and lock the profiled binaries, hence they cannot run concurrently
+EXCLUSIVE_RESOURCES = ["systemtap"]
+
 
 def before(executable, **kwargs):
     """Validates, initializes and normalizes the collection configuration.
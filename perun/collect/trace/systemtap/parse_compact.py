@@ -31,6 +31,8 @@ class ThreadContext:
 
     :ivar dict start: the thread starting record
     :ivar list func_stack: keeps track of the function call stack
+    :ivar dict func_positions: maps probe ID to a stack of positions of its open frames in the
+        function call stack
     :ivar dict usdt_stack: stores stack of USDT probe hits for each probe
     :ivar dict seq_map: tracks sequence number for each probe that identifies the order of records
     :ivar bool bottom_flag: flag used to identify records that have no more callees
@@ -40,6 +42,7 @@ class ThreadContext:
     def __init__(self):
         self.start = {}
         self.func_stack = []
+        self.func_positions = collections.defaultdict(list)
         self.usdt_stack = collections.defaultdict(list)
         self.seq_map = collections.defaultdict(int)
         self.bottom_flag = False
@@ -57,6 +60,9 @@ class TransformContext:
     :ivar ThreadContext per_thread: per-thread context for function / usdt stacks, sequence maps etc
     :ivar dict bottom: summary of total elapsed time per bottom functions per thread
     :ivar dict level_times_exclusive: summary of exclusive times per trace depth
+    :ivar dict stack_mismatches: number of recovered exit records per probe that did not match
+        the top of the function call stack
+    :ivar dict lost_frames: number of frames per probe discarded due to lost exit records
     """
 
     def __init__(self, probes, binaries, verbose_trace, workload):
@@ -79,6 +85,10 @@ class TransformContext:
         # Thread -> level -> total exclusive time
         self.level_times_exclusive = collections.defaultdict(lambda: collections.defaultdict(int))
 
+        # Probe -> number of recovered mismatches / discarded frames, tracks the data quality
+        self.stack_mismatches = collections.defaultdict(int)
+        self.lost_frames = collections.defaultdict(int)
+
         # ID Map is used to map probe ID -> function name in non-verbose mode
         # and function name -> function name in verbose mode (basically a no-op)
         # TODO: temporary, solve dynamic call graph properly
@@ -209,6 +219,8 @@ def process_records(data_file, config, probes):
             },
         )
         metrics.add_metric("trace_level_times_exclusive", dict(ctx.level_times_exclusive))
+        metrics.add_metric("stack_mismatches", dict(ctx.stack_mismatches))
+        metrics.add_metric("lost_frames", dict(ctx.lost_frames))
         all_probes = set(probes.func.keys()) | set(probes.usdt.keys())
         metrics.add_metric("collected_probes", len(ctx.probes_hit & all_probes))
         config.stats_data = {"p": ctx.processes, "t": ctx.threads, "f": ctx.funcs}
@@ -419,6 +431,7 @@ def _record_func_begin(record, ctx):
     # Add the record to the trace stack
     tid_ctx.bottom_flag = True
     tid_ctx.depth += 1
+    tid_ctx.func_positions[record["id"]].append(len(tid_ctx.func_stack))
     tid_ctx.func_stack.append(record)
     return {}
 
@@ -435,18 +448,22 @@ def _record_func_end(record, ctx):
     record_tid = record["tid"]
     thread_ctx = ctx.per_thread[record_tid]
     stack = thread_ctx.func_stack
+    positions = thread_ctx.func_positions[record["id"]]
     matching_record = {}
     # In most cases, the record matches the top record in the stack
     depth_diff = 1
     if stack and record["id"] == stack[-1]["id"] and record["timestamp"] > stack[-1]["timestamp"]:
         matching_record = stack.pop()
-    # However, if not, then traverse the whole stack and attempt to find matching record
+        positions.pop()
+    # However, if not, then look up the open frames of the same probe, starting from the top
     else:
-        for idx, stack_item in enumerate(reversed(stack)):
-            if record["id"] == stack_item["id"] and record["timestamp"] > stack_item["timestamp"]:
-                depth_diff = idx
-                stack[:] = stack[: len(stack) - idx]
+        for pos in reversed(positions):
+            if record["timestamp"] > stack[pos]["timestamp"]:
+                depth_diff = len(stack) - pos - 1
+                _unwind_func_stack(ctx, thread_ctx, pos + 1)
                 matching_record = stack.pop()
+                positions.pop()
+                ctx.stack_mismatches[record["id"]] += 1
                 break
     if matching_record:
         # Compute the exclusive time
@@ -471,6 +488,21 @@ def _record_func_end(record, ctx):
     return resource
 
 
+def _unwind_func_stack(ctx, thread_ctx, stack_size):
+    """Discards the frames on top of the function call stack (i.e., frames whose exit records
+    were lost) until the stack has the given size.
+
+    :param TransformContext ctx: the parsing context object
+    :param ThreadContext thread_ctx: the context of the thread that owns the call stack
+    :param int stack_size: the resulting size of the call stack
+    """
+    stack = thread_ctx.func_stack
+    while len(stack) > stack_size:
+        lost_record = stack.pop()
+        thread_ctx.func_positions[lost_record["id"]].pop()
+        ctx.lost_frames[lost_record["id"]] += 1
+
+
 def _record_usdt_single(record, ctx):
     """Handler for the single USDT probes (not paired).
 
@@ -0,0 +1,276 @@
+"""Persistent caches of decoded profiles and of results of degradation checks.
+
+Objects in the object store are immutable and addressed by their SHA-1 checksum, hence the
+decoded profiles can be safely cached under the same checksum. Cached profiles are stored in
+the uncompressed binary columnar format (see :mod:`perun.profile.binary`), which is opened by
+memory mapping and requires no inflating nor parsing of the resources.
+
+The cache is stored in ``.perun/cache/profiles`` and is limited by the
+:ckey:`profiles.cache_size_limit` (in megabytes). When the limit is exceeded, the least recently
+used profiles are evicted. Each cached profile remembers the checksum and size of its source
+object and the version of the binary format, and is discarded if any of them does not match.
+
+Results of degradation checks are stored in ``.perun/cache/degradations``. Since the profiles are
+immutable, the result of a check is fully determined by the checksums of the baseline and target
+profiles, the detection method, its parameters and the version of Perun. The hash of these is
+used as the address of the cached result (in the same layout as the object store), so the
+results are looked up without reading any index.
+"""
+from __future__ import annotations
+
+# Standard Imports
+from typing import Any, Optional
+import hashlib
+import json
+import mmap
+import os
+
+# Third-Party Imports
+
+# Perun Imports
+from perun.logic import config
+from perun.profile import binary
+from perun.profile.factory import Profile
+from perun.utils.exceptions import IncorrectProfileFormatException
+from perun.utils.structs import DegradationInfo, PerformanceChange
+import perun
+
+
+PROFILE_CACHE_DIRECTORY: str = os.path.join("cache", "profiles")
+PROFILE_CACHE_SUFFIX: str = f".v{binary.BINARY_PROFILE_VERSION}.pbin"
+DEFAULT_CACHE_SIZE_LIMIT: str = "1024"
+DEGRADATION_CACHE_DIRECTORY: str = os.path.join("cache", "degradations")
+
+
+def get_cache_directory_for(object_file: str) -> Optional[str]:
+    """Returns the cache directory for the object stored in the object directory.
+
+    :param str object_file: path to the object, i.e. ``.perun/objects/ab/cdef...``
+    :return: path to the cache directory, or None if the file is not in the object directory
+    """
+    object_dir = os.path.dirname(os.path.dirname(os.path.abspath(object_file)))
+    if os.path.basename(object_dir) != "objects":
+        return None
+    return os.path.join(os.path.dirname(object_dir), PROFILE_CACHE_DIRECTORY)
+
+
+def get_cache_size_limit() -> int:
+    """Returns the size limit of the profile cache in bytes.
+
+    :return: size limit in bytes, 0 if the cache is disabled
+    """
+    try:
+        limit = config.lookup_key_recursively("profiles.cache_size_limit", DEFAULT_CACHE_SIZE_LIMIT)
+        return max(int(float(limit) * 1024 * 1024), 0)
+    except (OSError, TypeError, ValueError):
+        return 0
+
+
+def _cached_profile_path(cache_dir: str, checksum: str) -> str:
+    """
+    :param str cache_dir: directory with cached profiles
+    :param str checksum: checksum of the object
+    :return: path to the cached profile
+    """
+    return os.path.join(cache_dir, checksum + PROFILE_CACHE_SUFFIX)
+
+
+def load_cached_profile(object_file: str, checksum: str) -> Optional[Profile]:
+    """Loads the decoded profile of the object from the cache.
+
+    Cached profiles that do not correspond to the object are removed from the cache.
+
+    :param str object_file: path to the object
+    :param str checksum: checksum of the object
+    :return: decoded profile or None if the profile is not cached
+    """
+    cache_dir = get_cache_directory_for(object_file)
+    if cache_dir is None or get_cache_size_limit() == 0:
+        return None
+    cached_file = _cached_profile_path(cache_dir, checksum)
+    try:
+        with open(cached_file, "rb") as cached_handle:
+            with mmap.mmap(cached_handle.fileno(), 0, access=mmap.ACCESS_READ) as cached_map:
+                reader = binary.BinaryProfileReader(cached_file, cached_map)
+                if reader.extra != {
+                    "checksum": checksum,
+                    "size": os.path.getsize(object_file),
+                }:
+                    raise IncorrectProfileFormatException(cached_file, "stale profile '{}'")
+                profile = reader.to_profile()
+        # Mark the profile as recently used
+        os.utime(cached_file)
+        return profile
+    except (OSError, ValueError, IncorrectProfileFormatException):
+        remove_cached_profile(object_file, checksum)
+        return None
+
+
+def store_cached_profile(object_file: str, checksum: str, profile: Profile) -> None:
+    """Stores the decoded profile of the object in the cache.
+
+    The profile is first written into temporary file, which is then atomically renamed, so
+    the concurrent readers never see partially written profiles.
+
+    :param str object_file: path to the object
+    :param str checksum: checksum of the object
+    :param Profile profile: decoded profile
+    """
+    cache_dir = get_cache_directory_for(object_file)
+    size_limit = get_cache_size_limit()
+    if cache_dir is None or size_limit == 0:
+        return
+    try:
+        content = binary.pack_profile(
+            profile,
+            compress=False,
+            extra={"checksum": checksum, "size": os.path.getsize(object_file)},
+        )
+        if len(content) > size_limit:
+            return
+        os.makedirs(cache_dir, exist_ok=True)
+        cached_file = _cached_profile_path(cache_dir, checksum)
+        tmp_file = f"{cached_file}.{os.getpid()}.tmp"
+        with open(tmp_file, "wb") as tmp_handle:
+            tmp_handle.write(content)
+        os.replace(tmp_file, cached_file)
+        evict_profiles(cache_dir, size_limit)
+    except (OSError, TypeError, ValueError):
+        # Caching is only an optimization, hence we do not fail on any issue
+        pass
+
+
+def remove_cached_profile(object_file: str, checksum: str) -> None:
+    """Removes the cached profile of the object, if it exists.
+
+    :param str object_file: path to the object
+    :param str checksum: checksum of the object
+    """
+    cache_dir = get_cache_directory_for(object_file)
+    if cache_dir is not None:
+        try:
+            os.remove(_cached_profile_path(cache_dir, checksum))
+        except OSError:
+            pass
+
+
+def evict_profiles(cache_dir: str, size_limit: int) -> None:
+    """Removes the least recently used profiles, until the cache fits into the size limit.
+
+    :param str cache_dir: directory with cached profiles
+    :param int size_limit: size limit of the cache in bytes
+    """
+    cached_profiles = []
+    for cached_file in os.scandir(cache_dir):
+        if cached_file.is_file():
+            stat = cached_file.stat()
+            cached_profiles.append((stat.st_mtime, stat.st_size, cached_file.path))
+    cache_size = sum(size for (_, size, _) in cached_profiles)
+    cached_profiles.sort()
+    for _, size, cached_file_path in cached_profiles:
+        if cache_size <= size_limit:
+            break
+        try:
+            os.remove(cached_file_path)
+            cache_size -= size
+        except OSError:
+            pass
+
+
+def degradation_cache_key(
+    baseline_checksum: str, target_checksum: str, method: str, params: dict[str, Any]
+) -> str:
+    """Computes the address of the result of one degradation check
+
+    :param str baseline_checksum: checksum of the baseline profile object
+    :param str target_checksum: checksum of the target profile object
+    :param str method: name of the detection method
+    :param dict params: parameters of the detection method
+    :return: hex digest identifying the result of the check
+    """
+    key = json.dumps(
+        [perun.__version__, baseline_checksum, target_checksum, method, params], sort_keys=True
+    )
+    return hashlib.sha1(key.encode("utf-8")).hexdigest()
+
+
+def _cached_degradations_path(perun_dir: str, key: str) -> str:
+    """
+    :param str perun_dir: path to the perun directory
+    :param str key: address of the cached result
+    :return: path to the file with cached result
+    """
+    return os.path.join(perun_dir, DEGRADATION_CACHE_DIRECTORY, key[:2], key[2:] + ".json")
+
+
+def _degradation_to_dict(deg: DegradationInfo) -> dict[str, Any]:
+    """
+    :param DegradationInfo deg: serialized degradation info
+    :return: JSON serializable representation of the degradation info
+    """
+    return {
+        "res": deg.result.name,
+        "loc": deg.location,
+        "fb": deg.from_baseline,
+        "tt": deg.to_target,
+        "t": deg.type,
+        "rd": deg.rate_degradation,
+        "ct": deg.confidence_type,
+        "cr": deg.confidence_rate,
+        "pi": [[change.name, *rest] for (change, *rest) in deg.partial_intervals],
+        "rdr": deg.rate_degradation_relative,
+    }
+
+
+def _degradation_from_dict(record: dict[str, Any]) -> DegradationInfo:
+    """
+    :param dict record: JSON representation of the degradation info
+    :return: deserialized degradation info
+    """
+    return DegradationInfo(
+        res=PerformanceChange[record["res"]],
+        loc=record["loc"],
+        fb=record["fb"],
+        tt=record["tt"],
+        t=record["t"],
+        rd=record["rd"],
+        ct=record["ct"],
+        cr=record["cr"],
+        pi=[(PerformanceChange[change], *rest) for (change, *rest) in record["pi"]],
+        rdr=record["rdr"],
+    )
+
+
+def load_cached_degradations(perun_dir: str, key: str) -> Optional[list[DegradationInfo]]:
+    """Loads the cached result of the degradation check
+
+    :param str perun_dir: path to the perun directory
+    :param str key: address of the result (see :func:`degradation_cache_key`)
+    :return: list of degradation infos or None if the result is not cached
+    """
+    try:
+        with open(_cached_degradations_path(perun_dir, key), "r") as cached_handle:
+            return [_degradation_from_dict(record) for record in json.load(cached_handle)]
+    except (OSError, ValueError, TypeError, KeyError):
+        return None
+
+
+def store_cached_degradations(
+    perun_dir: str, key: str, degradations: list[DegradationInfo]
+) -> None:
+    """Stores the result of the degradation check into the cache
+
+    :param str perun_dir: path to the perun directory
+    :param str key: address of the result (see :func:`degradation_cache_key`)
+    :param list degradations: list of degradation infos found by the check
+    """
+    cached_file = _cached_degradations_path(perun_dir, key)
+    try:
+        os.makedirs(os.path.dirname(cached_file), exist_ok=True)
+        tmp_file = f"{cached_file}.{os.getpid()}.tmp"
+        with open(tmp_file, "w") as tmp_handle:
+            json.dump([_degradation_to_dict(deg) for deg in degradations], tmp_handle)
+        os.replace(tmp_file, cached_file)
+    except (OSError, TypeError, ValueError):
+        # Caching is only an optimization, hence we do not fail on any issue
+        pass
@@ -294,15 +294,8 @@ def add(
 
         # Remove origin from file
         unpacked_profile.pop("origin")
-        str_profile_content = profile.to_string(unpacked_profile)
-
-        # Append header to the content of the file
-        header = f"profile {unpacked_profile['header']['type']} {len(str_profile_content)}\0"
-        profile_content = (header + str_profile_content).encode("utf-8")
-
-        # Transform to internal representation - file as sha1 checksum and content packed with zlib
-        profile_sum = store.compute_checksum(profile_content)
-        compressed_content = store.pack_content(profile_content)
+        object_format = perun_config.lookup_key_recursively("profiles.object_format", "binary")
+        profile_sum, compressed_content = store.pack_profile_object(unpacked_profile, object_format)
 
         # Add to control
         object_dir = pcs.get_object_directory()
@@ -1206,7 +1199,11 @@ def load_profile_from_args(profile_name: str, minor_version: str) -> Optional[Pr
         if os.path.exists(minor_index_file):
             with open(minor_index_file, "rb") as minor_handle:
                 lookup_pred = lambda entry: entry.path == profile_name
-                profiles.extend(index.lookup_all_entries_within_index(minor_handle, lookup_pred))
+                profiles.extend(
+                    index.lookup_all_entries_within_index(
+                        minor_handle, lookup_pred, ("path", profile_name)
+                    )
+                )
 
     # If there are more profiles we should choose
     if not profiles:
@@ -7,7 +7,7 @@ from __future__ import annotations
 
 # Standard Imports
 from enum import Enum
-from typing import Callable, BinaryIO, Any, Iterable, Collection, TYPE_CHECKING
+from typing import Callable, BinaryIO, Any, Iterable, Collection, Optional, TYPE_CHECKING
 import binascii
 import json
 import os
@@ -33,14 +33,21 @@ if TYPE_CHECKING:
 # List of current versions of format and magic constants
 INDEX_ENTRIES_START_OFFSET: int = 12
 INDEX_NUMBER_OF_ENTRIES_OFFSET: int = 8
+INDEX_FOOTER_OFFSET_OFFSET: int = 12
+INDEX_COMPACTED_ENTRIES_START_OFFSET: int = 24
 INDEX_MAGIC_PREFIX: bytes = b"pidx"
-# Index Version 2.0 FastSloth
-INDEX_VERSION: int = 2
+# Minimal number of appended entries, after which the log-structured index is compacted
+INDEX_COMPACTION_THRESHOLD: int = 64
+# Attributes of entries, which can be looked up by binary search in log-structured index
+INDEX_LOOKUP_TABLES: tuple[str, ...] = ("path", "checksum")
+# Index Version 3.0 NimbleGecko
+INDEX_VERSION: int = 3
 
 
 class IndexVersion(Enum):
     SlowLorris = 1
     FastSloth = 2
+    NimbleGecko = 3
 
 
 class BasicIndexEntry:
@@ -224,7 +231,7 @@ class ExtendedIndexEntry(BasicIndexEntry):
         :param index_handle:
         :return:
         """
-        basic_entry = BasicIndexEntry.read_from(index_handle, get_older_version(index_version))
+        basic_entry = BasicIndexEntry.read_from(index_handle, BasicIndexEntry.version)
         profile: dict[str, Any] = {
             "header": {},
             "collector_info": {},
@@ -286,21 +293,12 @@ def get_older_version(index_version: IndexVersion) -> IndexVersion:
     return IndexVersion(index_version.value - 1)
 
 
-def walk_index(index_handle: BinaryIO) -> Iterable[BasicIndexEntry]:
-    """Iterator through index entries
-
-    Reads the beginning of the file, verifying the version and type of the index. Then it iterates
-    through index entries and returns them as a BasicIndexEntry structure for further
-    processing.
+def read_index_prefix(index_handle: BinaryIO) -> tuple[int, int]:
+    """Reads the beginning of the index, verifying the version and type of the index.
 
     :param file index_handle: handle to file containing index
-    :returns BasicIndexEntry: entry from the index
+    :returns (int, int): version of the index and number of entries in the index
     """
-    # Get end of file position
-    index_handle.seek(0, 2)
-    last_position = index_handle.tell()
-
-    # Move to the begging of the handle
     index_handle.seek(0)
     magic_bytes = index_handle.read(4)
     if magic_bytes != INDEX_MAGIC_PREFIX:
@@ -312,16 +310,108 @@ def walk_index(index_handle: BinaryIO) -> Iterable[BasicIndexEntry]:
             "read index file is in format of different index version "
             f"(read index file = {index_version}, supported = {INDEX_VERSION})"
         )
+    return index_version, store.read_int_from_handle(index_handle)
 
-    number_of_objects = store.read_int_from_handle(index_handle)
-    loaded_objects = 0
+
+def read_index_layout(index_handle: BinaryIO) -> tuple[int, int]:
+    """Reads the layout of the log-structured index (version 3 and newer)
+
+    :param file index_handle: handle to file containing index
+    :returns (int, int): offset of the footer and number of compacted entries
+    """
+    index_handle.seek(INDEX_FOOTER_OFFSET_OFFSET)
+    footer_offset = struct.unpack("Q", index_handle.read(8))[0]
+    return footer_offset, store.read_int_from_handle(index_handle)
+
+
+def _entry_key(entry: BasicIndexEntry) -> tuple[str, str]:
+    """
+    :param BasicIndexEntry entry: index entry
+    :return: key by which the entries are sorted in the index
+    """
+    return entry.path, entry.time
+
+
+def _read_log_of_entries(
+    index_handle: BinaryIO, index_version: IndexVersion
+) -> list[BasicIndexEntry]:
+    """Reads the entries appended after the footer of the log-structured index
+
+    :param file index_handle: handle to file containing index
+    :param IndexVersion index_version: version of the opened index
+    :returns list: list of appended entries sorted by their path and time
+    """
+    index_handle.seek(0, 2)
+    last_position = index_handle.tell()
+    footer_offset, compacted_entries = read_index_layout(index_handle)
+    index_handle.seek(footer_offset + 8 * len(INDEX_LOOKUP_TABLES) * compacted_entries)
+
+    entry_constructor = INDEX_ENTRY_CONSTRUCTORS[INDEX_VERSION - 1]
+    appended_entries = []
+    while index_handle.tell() < last_position:
+        appended_entries.append(entry_constructor.read_from(index_handle, index_version))
+    return sorted(appended_entries, key=_entry_key)
+
+
+def _walk_log_structured_index(
+    index_handle: BinaryIO, index_version: IndexVersion
+) -> Iterable[BasicIndexEntry]:
+    """Iterator through entries of log-structured index (version 3 and newer)
+
+    The compacted entries are read sequentially and merged with the (sorted) appended entries,
+    so the entries are returned ordered by their path and time.
+
+    :param file index_handle: handle to file containing index
+    :param IndexVersion index_version: version of the opened index
+    :returns BasicIndexEntry: entry from the index
+    """
+    appended_entries = _read_log_of_entries(index_handle, index_version)
+    _, compacted_entries = read_index_layout(index_handle)
     entry_constructor = INDEX_ENTRY_CONSTRUCTORS[INDEX_VERSION - 1]
 
-    while index_handle.tell() + 24 < last_position and loaded_objects < number_of_objects:
-        entry = entry_constructor.read_from(index_handle, IndexVersion(index_version))  # type: ignore
-        # Fixme: ^--- there is an issue with mypy, that type has no attribute read_from, but it is syntactically correct
-        loaded_objects += 1
+    appended_position = 0
+    index_handle.seek(INDEX_COMPACTED_ENTRIES_START_OFFSET)
+    for _ in range(compacted_entries):
+        entry = entry_constructor.read_from(index_handle, index_version)
+        next_position = index_handle.tell()
+        while appended_position < len(appended_entries) and _entry_key(
+            appended_entries[appended_position]
+        ) < _entry_key(entry):
+            yield appended_entries[appended_position]
+            appended_position += 1
         yield entry
+        index_handle.seek(next_position)
+    yield from appended_entries[appended_position:]
+
+
+def walk_index(index_handle: BinaryIO) -> Iterable[BasicIndexEntry]:
+    """Iterator through index entries
+
+    Reads the beginning of the file, verifying the version and type of the index. Then it iterates
+    through index entries and returns them as a BasicIndexEntry structure for further
+    processing.
+
+    :param file index_handle: handle to file containing index
+    :returns BasicIndexEntry: entry from the index
+    """
+    # Get end of file position
+    index_handle.seek(0, 2)
+    last_position = index_handle.tell()
+
+    index_version, number_of_objects = read_index_prefix(index_handle)
+    loaded_objects = 0
+    entry_constructor = INDEX_ENTRY_CONSTRUCTORS[INDEX_VERSION - 1]
+
+    if index_version >= IndexVersion.NimbleGecko.value:
+        for entry in _walk_log_structured_index(index_handle, IndexVersion(index_version)):
+            loaded_objects += 1
+            yield entry
+    else:
+        while index_handle.tell() + 24 < last_position and loaded_objects < number_of_objects:
+            entry = entry_constructor.read_from(index_handle, IndexVersion(index_version))
+            # Fixme: ^--- there is an issue with mypy, that type has no attribute read_from, but it is syntactically correct
+            loaded_objects += 1
+            yield entry
 
     if loaded_objects != number_of_objects:
         perun_log.error(
@@ -369,6 +459,15 @@ def touch_index(index_path: str) -> None:
       -  ?B Variable length path
       -  ?B zero byte padding
 
+    The Version 3 index is log-structured and continues after the number of entries with:
+      -  8B offset of the footer
+      -  4B number of compacted entries
+
+    Followed by the compacted entries sorted by their path and time, the footer and the log of
+    appended entries. The footer consists of fixed-width tables of 8B offsets of the compacted
+    entries ordered by path and time, and by checksum respectively, so the entries can be looked up
+    by binary search.
+
     :param str index_path: path to the index
     """
     if not os.path.exists(index_path):
@@ -391,6 +490,9 @@ def initialize_index_in_handle(index_handle: BinaryIO) -> None:
     index_handle.write(INDEX_MAGIC_PREFIX)
     index_handle.write(struct.pack("i", INDEX_VERSION))
     index_handle.write(struct.pack("i", 0))
+    if INDEX_VERSION >= IndexVersion.NimbleGecko.value:
+        index_handle.write(struct.pack("Q", INDEX_COMPACTED_ENTRIES_START_OFFSET))
+        index_handle.write(struct.pack("i", 0))
 
 
 def update_index_version(index_handle: BinaryIO) -> None:
@@ -419,6 +521,73 @@ def modify_number_of_entries_in_index(index_handle: BinaryIO, modify: Callable[[
 def write_entry_to_index(index_file: str, file_entry: BasicIndexEntry) -> None:
     """Writes the file_entry to its appropriate position within the index.
 
+    In log-structured index, the entry is appended to the end of the index, unless it is already
+    registered. Older indexes are converted to the log-structured index.
+
+    :param str index_file: path to the index file
+    :param BasicIndexEntry file_entry: index entry that will be written to the file
+    """
+    if INDEX_VERSION < IndexVersion.NimbleGecko.value:
+        insert_entry_to_sorted_index(index_file, file_entry)
+        return
+
+    with open(index_file, "rb+") as index_handle:
+        index_version, _ = read_index_prefix(index_handle)
+        try:
+            lookup_entry_within_index(
+                index_handle,
+                lambda entry: entry.time == file_entry.time,
+                file_entry.path,
+                indexed_by=("path", file_entry.path),
+            )
+            perun_log.warn(
+                f"{file_entry.path} ({file_entry.time}) already registered in {index_file}",
+            )
+            return
+        except EntryNotFoundException:
+            pass
+
+        if index_version >= IndexVersion.NimbleGecko.value:
+            append_entry_to_index(index_handle, file_entry)
+            return
+        entry_list = list(walk_index(index_handle)) + [file_entry]
+    write_list_of_entries(index_file, entry_list)
+
+
+def append_entry_to_index(index_handle: BinaryIO, file_entry: BasicIndexEntry) -> None:
+    """Appends the file_entry to the log of the log-structured index.
+
+    Once the log is longer than INDEX_COMPACTION_THRESHOLD and half of the compacted entries, the
+    index is compacted. The log grows with the index, so the appending stays amortized constant.
+
+    :param file index_handle: handle of the opened index
+    :param BasicIndexEntry file_entry: index entry that will be appended to the index
+    """
+    index_handle.seek(0, 2)
+    file_entry.write_to(index_handle)
+    modify_number_of_entries_in_index(index_handle, lambda x: x + 1)
+
+    _, number_of_entries = read_index_prefix(index_handle)
+    _, compacted_entries = read_index_layout(index_handle)
+    if number_of_entries - compacted_entries > max(
+        INDEX_COMPACTION_THRESHOLD, compacted_entries // 2
+    ):
+        compact_index(index_handle)
+
+
+def compact_index(index_handle: BinaryIO) -> None:
+    """Compacts the log-structured index, i.e. merges the log of appended entries into the sorted
+    compacted entries and rebuilds the footer.
+
+    :param file index_handle: handle of the opened index
+    """
+    entry_list = list(walk_index(index_handle))
+    write_list_of_entries_to_handle(index_handle, entry_list)
+
+
+def insert_entry_to_sorted_index(index_file: str, file_entry: BasicIndexEntry) -> None:
+    """Writes the file_entry to its appropriate position within the older versions of index.
+
     Given the file entry, writes the entry within the file, moving everything by the given offset
     and then incrementing the number of entries within the index.
 
@@ -481,27 +650,137 @@ def write_list_of_entries(index_file: str, entry_list: list[BasicIndexEntry]) ->
     """
     # First delete the index
     with open(index_file, "wb+") as index_handle:
-        index_handle.truncate(0)
-        initialize_index_in_handle(index_handle)
-        modify_number_of_entries_in_index(index_handle, lambda x: len(entry_list))
+        write_list_of_entries_to_handle(index_handle, entry_list)
+
+
+def write_list_of_entries_to_handle(
+    index_handle: BinaryIO, entry_list: list[BasicIndexEntry]
+) -> None:
+    """Rewrites the opened index to contain the list of entries only
+
+    The log-structured index is written compacted, i.e. with entries sorted by their path and time
+    followed by the footer with lookup tables.
+
+    :param file index_handle: handle of the opened index
+    :param list of ExtendedIndexEntry entry_list:
+    """
+    index_handle.seek(0)
+    index_handle.truncate(0)
+    initialize_index_in_handle(index_handle)
+    modify_number_of_entries_in_index(index_handle, lambda x: len(entry_list))
+    if INDEX_VERSION < IndexVersion.NimbleGecko.value:
         index_handle.seek(INDEX_ENTRIES_START_OFFSET)
         for entry in entry_list:
             entry.write_to(index_handle)
+        return
+
+    sorted_entries = sorted(entry_list, key=_entry_key)
+    index_handle.seek(INDEX_COMPACTED_ENTRIES_START_OFFSET)
+    entry_offsets = []
+    for entry in sorted_entries:
+        entry_offsets.append(index_handle.tell())
+        entry.write_to(index_handle)
+    footer_offset = index_handle.tell()
+    for attribute in INDEX_LOOKUP_TABLES:
+        table_order = sorted(
+            range(len(sorted_entries)), key=lambda i: getattr(sorted_entries[i], attribute)
+        )
+        index_handle.write(
+            struct.pack(f"{len(table_order)}Q", *[entry_offsets[i] for i in table_order])
+        )
+    index_handle.seek(INDEX_FOOTER_OFFSET_OFFSET)
+    index_handle.write(struct.pack("Q", footer_offset))
+    index_handle.write(struct.pack("i", len(sorted_entries)))
+
+
+def _bisect_compacted_entries(
+    index_handle: BinaryIO, index_version: IndexVersion, attribute: str, value: str
+) -> list[BasicIndexEntry]:
+    """Looks up the compacted entries with the given value of attribute by binary search
+
+    :param file index_handle: file handle of the log-structured index
+    :param IndexVersion index_version: version of the opened index
+    :param str attribute: looked up attribute of entries (one of INDEX_LOOKUP_TABLES)
+    :param str value: looked up value of the attribute
+    :returns [BasicIndexEntry]: list of compacted entries with the given value of attribute
+    """
+    footer_offset, compacted_entries = read_index_layout(index_handle)
+    table_offset = footer_offset + 8 * INDEX_LOOKUP_TABLES.index(attribute) * compacted_entries
+    entry_constructor = INDEX_ENTRY_CONSTRUCTORS[INDEX_VERSION - 1]
+
+    def entry_at(position: int) -> BasicIndexEntry:
+        """Reads the entry at the given position of the lookup table"""
+        index_handle.seek(table_offset + 8 * position)
+        index_handle.seek(struct.unpack("Q", index_handle.read(8))[0])
+        return entry_constructor.read_from(index_handle, index_version)
+
+    low, high = 0, compacted_entries
+    while low < high:
+        middle = (low + high) // 2
+        if getattr(entry_at(middle), attribute) < value:
+            low = middle + 1
+        else:
+            high = middle
+
+    found_entries = []
+    while low < compacted_entries:
+        entry = entry_at(low)
+        if getattr(entry, attribute) != value:
+            break
+        found_entries.append(entry)
+        low += 1
+    return found_entries
+
+
+def lookup_indexed_entries(
+    index_handle: BinaryIO, attribute: str, value: str
+) -> list[BasicIndexEntry]:
+    """Looks up all entries with the given value of attribute ordered by their path and time
+
+    In log-structured index, the compacted entries are looked up by binary search in the footer,
+    and only the log of appended entries is read sequentially. Older indexes are walked.
+
+    :param file index_handle: file handle of the index
+    :param str attribute: looked up attribute of entries (one of INDEX_LOOKUP_TABLES)
+    :param str value: looked up value of the attribute
+    :returns [BasicIndexEntry]: list of index entries with the given value of attribute
+    """
+    index_version, _ = read_index_prefix(index_handle)
+    if index_version < IndexVersion.NimbleGecko.value:
+        return [entry for entry in walk_index(index_handle) if getattr(entry, attribute) == value]
+
+    found_entries = _bisect_compacted_entries(
+        index_handle, IndexVersion(index_version), attribute, value
+    )
+    found_entries.extend(
+        entry
+        for entry in _read_log_of_entries(index_handle, IndexVersion(index_version))
+        if getattr(entry, attribute) == value
+    )
+    return sorted(found_entries, key=_entry_key)
 
 
 def lookup_entry_within_index(
     index_handle: BinaryIO,
     predicate: Callable[[BasicIndexEntry], bool],
     looked_up_entry_name: str,
+    indexed_by: Optional[tuple[str, str]] = None,
 ) -> BasicIndexEntry:
     """Looks up the first entry within index that satisfies the predicate
 
     :param file index_handle: file handle of the index
     :param function predicate: predicate that tests given entry in index BasicIndexEntry -> bool
     :param str looked_up_entry_name: name of the entry we are looking up (for exception)
+    :param tuple indexed_by: pair of attribute (path or checksum) and its value; if set, then
+        only entries with the given value are tested, and these are looked up by binary search
     :returns BasicIndexEntry: index entry satisfying the given predicate
     """
-    for entry in walk_index(index_handle):
+    entries = (
+        walk_index(index_handle)
+        if indexed_by is None
+        else lookup_indexed_entries(index_handle, *indexed_by)
+    )
+    for entry in entries:
         if predicate(entry):
             return entry
 
@@ -509,15 +788,24 @@ def lookup_entry_within_index(
 
 
 def lookup_all_entries_within_index(
-    index_handle: BinaryIO, predicate: Callable[[BasicIndexEntry], bool]
+    index_handle: BinaryIO,
+    predicate: Callable[[BasicIndexEntry], bool],
+    indexed_by: Optional[tuple[str, str]] = None,
 ) -> list[BasicIndexEntry]:
     """
     :param file index_handle: file handle of the index
     :param function predicate: predicate that tests given entry in index BasicIndexEntry -> bool
+    :param tuple indexed_by: pair of attribute (path or checksum) and its value; if set, then
+        only entries with the given value are tested, and these are looked up by binary search
 
     :returns [BasicIndexEntry]: list of index entries satisfying given predicate
     """
-    return [entry for entry in walk_index(index_handle) if predicate(entry)]
+    entries = (
+        walk_index(index_handle)
+        if indexed_by is None
+        else lookup_indexed_entries(index_handle, *indexed_by)
+    )
+    return [entry for entry in entries if predicate(entry)]
 
 
 def find_minor_index(minor_version: str) -> str:
@@ -633,17 +921,16 @@ def remove_from_index(
         removed_entries = []
 
         for i, removed_file in enumerate(removed_file_generator):
-
-            def lookup_function(looked_entry: BasicIndexEntry) -> bool:
-                """Helper lookup function according to the type of the removed file"""
-                if store.is_sha1(removed_file):
-                    return looked_entry.checksum == removed_file
-                else:
-                    return looked_entry.path == removed_file
+            looked_up_attribute = "checksum" if store.is_sha1(removed_file) else "path"
 
             count_status = f"{common_kit.format_counter_number(i + 1, removed_profile_number)}/{removed_profile_number}"
             try:
-                found_entry = lookup_entry_within_index(index_handle, lookup_function, removed_file)
+                found_entry = lookup_entry_within_index(
+                    index_handle,
+                    lambda _: True,
+                    removed_file,
+                    indexed_by=(looked_up_attribute, removed_file),
+                )
                 removed_entries.append(found_entry)
                 perun_log.minor_success(
                     f"{count_status} {perun_log.path_style(found_entry.path)}", "deregistered"
@@ -654,17 +941,10 @@ def remove_from_index(
                 )
                 removed_profile_number -= 1
 
-        # Update number of entries
-        index_handle.seek(INDEX_NUMBER_OF_ENTRIES_OFFSET)
-        index_handle.write(struct.pack("i", len(all_entries) - len(removed_entries)))
-
-        # For each entry remove from the index, starting from the greatest offset
-        for entry in all_entries:
-            if entry in removed_entries:
-                continue
-            entry.write_to(index_handle)
-
-        index_handle.truncate()
+        # Rewrite the index without the removed entries
+        write_list_of_entries_to_handle(
+            index_handle, [entry for entry in all_entries if entry not in removed_entries]
+        )
 
     perun_log.major_info("Summary")
     if removed_profile_number:
@@ -755,8 +1035,7 @@ def save_custom_index(index_path: str, records: list[Any] | dict[Any, Any]) -> N
     :param records: the index entries/records in a format that can be transformed to json
     """
     with open(index_path, "w+b") as index_handle:
-        compressed = store.pack_content(json.dumps(records, indent=2).encode("utf-8"))
-        index_handle.write(compressed)
+        store.write_packed_content(index_handle, json.dumps(records, indent=2).encode("utf-8"))
 
 
-INDEX_ENTRY_CONSTRUCTORS = [BasicIndexEntry, ExtendedIndexEntry]
+INDEX_ENTRY_CONSTRUCTORS = [BasicIndexEntry, ExtendedIndexEntry, ExtendedIndexEntry]
@@ -3,11 +3,16 @@ from __future__ import annotations
 
 # Standard Imports
 from typing import Any, Iterable, Optional, TYPE_CHECKING, cast, Callable, overload
+import collections
+import copy
 import distutils.util as dutils
+import multiprocessing
+import multiprocessing.connection
 import os
 import signal
 import time
 import subprocess
+import sys
 
 # Third-Party Imports
 import click
@@ -510,65 +515,272 @@ def run_prephase_commands(phase: str) -> None:
             )
 
 
+def get_number_of_workers() -> int:
+    """Returns the number of workers, which run the independent jobs concurrently.
+
+    The number is set by :ckey:`execute.workers`; by default the jobs are run sequentially.
+
+    :return: number of workers (at least 1)
+    """
+    try:
+        return max(int(config.lookup_key_recursively("execute.workers", "1")), 1)
+    except ValueError:
+        log.warn("'execute.workers' is not a number: running jobs sequentially")
+        return 1
+
+
+def get_exclusive_resources_of(job: Job) -> set[str]:
+    """Returns the resources, which cannot be shared by concurrently run jobs.
+
+    The collectors declare their exclusive resources (e.g. SystemTap modules or files with
+    collected data) in the ``EXCLUSIVE_RESOURCES`` list of their ``run`` module. Moreover, the
+    user can declare additional resources in the ``exclusive_resources`` parameter of collector.
+
+    :param Job job: job, which is going to be run
+    :return: set of exclusive resources of the job
+    """
+    try:
+        collector_module = common_kit.get_module(f"perun.collect.{job.collector.name}.run")
+        resources = set(getattr(collector_module, "EXCLUSIVE_RESOURCES", []))
+    except ImportError:
+        resources = set()
+    return resources | set(job.collector.params.get("exclusive_resources", []))
+
+
+def split_cpus_to_workers(workers: int) -> list[set[int]]:
+    """Splits the available cpus to disjoint sets of cpus, one for each worker.
+
+    If the cpus are not to be pinned (see :ckey:`execute.pin_cpus`) or the affinity of processes
+    cannot be set on the platform, the sets are empty, i.e. the workers are not pinned.
+
+    :param int workers: number of workers
+    :return: list of sets of cpus for each of the workers
+    """
+    pin_cpus = dutils.strtobool(str(config.lookup_key_recursively("execute.pin_cpus", "true")))
+    if not pin_cpus or not hasattr(os, "sched_getaffinity"):
+        return [set() for _ in range(workers)]
+    cpus = sorted(os.sched_getaffinity(0))
+    if workers >= len(cpus):
+        return [{cpus[i % len(cpus)]} for i in range(workers)]
+    return [
+        set(cpus[i * len(cpus) // workers : (i + 1) * len(cpus) // workers]) for i in range(workers)
+    ]
+
+
+def print_job_overview(job_counter: int, job: Job) -> None:
+    """Prints the overview of the job, which is going to be run
+
+    :param int job_counter: number of the job
+    :param Job job: job, which is going to be run
+    """
+    log.major_info(f"Job {job_counter} Overview")
+    log.minor_status("Command", status=log.cmd_style(job.executable.cmd))
+    log.minor_status("Workload", status=log.highlight(job.executable.workload))
+    log.minor_status("Collector", status=log.highlight(job.collector.name))
+    if job.postprocessors:
+        log.minor_status(
+            "Postprocessors",
+            status=log.highlight(", ".join(post.name for post in job.postprocessors)),
+        )
+
+
+def run_job_with_generator(
+    job: Job, generator_spec: GeneratorSpec, number_of_jobs: int
+) -> Iterable[tuple[CollectStatus, Profile]]:
+    """Runs the collector and postprocessors of the job for each workload of the generator
+
+    :param Job job: job, which is run
+    :param GeneratorSpec generator_spec: specification of the workload generator
+    :param int number_of_jobs: number of jobs that will be run
+    :return: status and profile for each of the generated workloads; the profile is empty, if
+        the collection or postprocessing failed
+    """
+    generator, params = generator_spec.constructor, generator_spec.params
+    for c_status, prof in generator(job, **params).generate(run_collector):
+        # Run the collector and check if the profile was successfully collected
+        # In case, the status was not OK, then we skip the postprocessing
+        if c_status != CollectStatus.OK or not prof:
+            yield CollectStatus.ERROR, prof
+            continue
+
+        # Temporary nasty hack
+        prof = profile.finalize_profile_for_job(prof, job)
+
+        for postprocessor in job.postprocessors:
+            log.print_job_progress(number_of_jobs)
+            # Run postprocess and check if the profile was successfully postprocessed
+            p_status, prof = run_postprocessor(postprocessor, job, prof)
+            if p_status != PostprocessStatus.OK or not prof:
+                yield CollectStatus.ERROR, prof
+                break
+        else:
+            yield CollectStatus.OK, prof
+
+
+def run_job_in_worker(
+    connection: multiprocessing.connection.Connection,
+    job: Job,
+    generator_spec: GeneratorSpec,
+    number_of_jobs: int,
+    cpu_set: set[int],
+) -> None:
+    """Runs the job in the worker process, pinned to the given set of cpus
+
+    The results are sent through the connection to the parent process. Since the workload
+    generators modify the executable of the job, the job is copied for each of the generated
+    profiles. If the job fails, the exception is sent instead of results.
+
+    :param Connection connection: writable end of pipe to the parent process
+    :param Job job: job, which is run
+    :param GeneratorSpec generator_spec: specification of the workload generator
+    :param int number_of_jobs: number of jobs that will be run
+    :param set cpu_set: set of cpus, to which the worker (and its children) is pinned
+    """
+    try:
+        if cpu_set:
+            os.sched_setaffinity(0, cpu_set)
+        connection.send(
+            [
+                (status, prof, copy.deepcopy(job) if status == CollectStatus.OK else job)
+                for (status, prof) in run_job_with_generator(job, generator_spec, number_of_jobs)
+            ]
+        )
+    except (Exception, SystemExit) as exc:
+        connection.send(exc)
+    finally:
+        connection.close()
+
+
+def collect_results_of_worker(
+    connection: multiprocessing.connection.Connection,
+) -> Optional[list[tuple[CollectStatus, Profile, Job]]]:
+    """Receives the results of the finished worker process
+
+    :param Connection connection: readable end of pipe from the worker process
+    :return: list of statuses, profiles and jobs for each of the generated workloads, or None
+        if the worker failed
+    """
+    try:
+        results = connection.recv()
+    except EOFError:
+        results = Exception("worker process terminated unexpectedly")
+    finally:
+        connection.close()
+    if isinstance(results, BaseException):
+        log.error(f"while running job: {results}", recoverable=True)
+        return None
+    return results
+
+
+def generate_jobs_in_parallel(
+    jobs: list[tuple[Job, GeneratorSpec]], number_of_jobs: int, workers: int
+) -> Iterable[tuple[CollectStatus, Profile, Job]]:
+    """Runs the independent jobs concurrently in separate worker processes.
+
+    Each job is run in its own forked process pinned to the set of cpus of a free worker slot.
+    The processes are always forked from the main thread, and they send their results back
+    through pipes. Jobs that share some exclusive resource are never run concurrently. The
+    profiles are yielded as soon as their jobs are finished.
+
+    :param list jobs: list of jobs together with their workload generators
+    :param int number_of_jobs: number of jobs that will be run
+    :param int workers: number of concurrently run worker processes
+    :return: status, generated profile, and associated job
+    """
+    context = multiprocessing.get_context("fork")
+    cpu_sets = split_cpus_to_workers(workers)
+    free_workers = list(reversed(range(workers)))
+    locked_resources: set[str] = set()
+    pending_jobs = collections.deque(enumerate(jobs, start=1))
+    running_jobs: dict[
+        multiprocessing.connection.Connection,
+        tuple[multiprocessing.process.BaseProcess, int, set[str]],
+    ] = {}
+    collective_status = CollectStatus.OK
+
+    while pending_jobs or running_jobs:
+        # Start all jobs, whose exclusive resources are not used by running jobs
+        for job_counter, (job, generator_spec) in list(pending_jobs):
+            if not free_workers:
+                break
+            resources = get_exclusive_resources_of(job)
+            if resources & locked_resources:
+                continue
+            pending_jobs.remove((job_counter, (job, generator_spec)))
+            worker = free_workers.pop()
+            locked_resources |= resources
+            print_job_overview(job_counter, job)
+            sys.stdout.flush()
+            sys.stderr.flush()
+            reader, writer = context.Pipe(duplex=False)
+            process = context.Process(
+                target=run_job_in_worker,
+                args=(writer, job, generator_spec, number_of_jobs, cpu_sets[worker]),
+            )
+            process.start()
+            writer.close()
+            running_jobs[reader] = (process, worker, resources)
+
+        for finished in multiprocessing.connection.wait(list(running_jobs.keys())):
+            assert isinstance(finished, multiprocessing.connection.Connection)
+            finished_process, finished_worker, released_resources = running_jobs.pop(finished)
+            results = collect_results_of_worker(finished)
+            finished_process.join()
+            free_workers.append(finished_worker)
+            locked_resources -= released_resources
+            if results is None:
+                collective_status = CollectStatus.ERROR
+                results = []
+            for status, prof, job in results:
+                if status != CollectStatus.OK or not prof:
+                    collective_status = CollectStatus.ERROR
+                else:
+                    yield collective_status, prof, job
+
+
 def generate_jobs_on_current_working_dir(
     job_matrix: dict[str, dict[str, list[Job]]], number_of_jobs: int
 ) -> Iterable[tuple[CollectStatus, Profile, Job]]:
     """Runs the batch of jobs on current state of the VCS.
 
     This function expects no changes not commited in the repo, it excepts correct version
-    checked out and just runs the matrix.
+    checked out and just runs the matrix. If more workers are configured (see
+    :ckey:`execute.workers`), the jobs are run concurrently.
 
     :param dict job_matrix: dictionary with jobs that will be run
     :param int number_of_jobs: number of jobs that will be run
     :return: status, generated profile, and associated job
     """
     workload_generators_specs: dict[str, GeneratorSpec] = workloads.load_generator_specifications()
+    jobs = [
+        (
+            job,
+            workload_generators_specs.get(
+                workload, GeneratorSpec(SingletonGenerator, {"value": workload})
+            ),
+        )
+        for workloads_per_cmd in job_matrix.values()
+        for workload, jobs_per_workload in workloads_per_cmd.items()
+        for job in jobs_per_workload
+    ]
 
     log.print_job_progress.current_job = 1
     collective_status = CollectStatus.OK
 
     log.major_info("Running Jobs")
     log.increase_indent()
-    job_counter = 1
-    for job_cmd, workloads_per_cmd in job_matrix.items():
-        for workload, jobs_per_workload in workloads_per_cmd.items():
-            # Prepare the specification
-            generator_spec = workload_generators_specs.get(
-                workload, GeneratorSpec(SingletonGenerator, {"value": workload})
-            )
-            generator, params = generator_spec.constructor, generator_spec.params
-            for job in jobs_per_workload:
-                log.major_info(f"Job {job_counter} Overview")
-                log.minor_status("Command", status=log.cmd_style(job_cmd))
-                log.minor_status("Workload", status=log.highlight(workload))
-                log.minor_status("Collector", status=log.highlight(job.collector.name))
-                if job.postprocessors:
-                    log.minor_status(
-                        "Postprocessors",
-                        status=log.highlight(", ".join(post.name for post in job.postprocessors)),
-                    )
-
-                for c_status, prof in generator(job, **params).generate(run_collector):
-                    # Run the collector and check if the profile was successfully collected
-                    # In case, the status was not OK, then we skip the postprocessing
-                    if c_status != CollectStatus.OK or not prof:
-                        collective_status = CollectStatus.ERROR
-                        continue
-
-                    # Temporary nasty hack
-                    prof = profile.finalize_profile_for_job(prof, job)
-
-                    for postprocessor in job.postprocessors:
-                        log.print_job_progress(number_of_jobs)
-                        # Run postprocess and check if the profile was successfully postprocessed
-                        p_status, prof = run_postprocessor(postprocessor, job, prof)
-                        if p_status != PostprocessStatus.OK or not prof:
-                            collective_status = CollectStatus.ERROR
-                            break
-                    else:
-                        # Store the computed profile inside the job directory
-                        yield collective_status, prof, job
-                job_counter += 1
+    workers = min(get_number_of_workers(), len(jobs))
+    if workers > 1 and "fork" in multiprocessing.get_all_start_methods():
+        yield from generate_jobs_in_parallel(jobs, number_of_jobs, workers)
+    else:
+        for job_counter, (job, generator_spec) in enumerate(jobs, start=1):
+            print_job_overview(job_counter, job)
+            for status, prof in run_job_with_generator(job, generator_spec, number_of_jobs):
+                if status != CollectStatus.OK or not prof:
+                    collective_status = CollectStatus.ERROR
+                else:
+                    # Store the computed profile inside the job directory
+                    yield collective_status, prof, job
 
     log.decrease_indent()
 
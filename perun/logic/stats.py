@@ -9,7 +9,7 @@ Stats files are located in the .perun/stats directory under a specific minor ver
 statistics are mostly related to some results or profiles acquired in a specific VCS version. For
 storing some temporary data that are unrelated to VCS version, use the 'temp' module.
 
-The format of the stats files is as follows:
+The logical content of the stats files is as follows:
 
 {
     'some_ID':
@@ -31,17 +31,40 @@ The format of the stats files is as follows:
 where the IDs uniquely represent stored statistics within the stats file and the ID is used to
 identify the data that should be manipulated by the functions.
 
-The contents of the stats file are stored in a compressed form to reduce the memory requirements.
-
+Physically, the stats file is a log of independently compressed records, so individual IDs can be
+read and modified without reading or rewriting the whole file (all integers are little-endian)::
+
+    magic            4B   b"psts"
+    version          1B   unsigned char
+    records          sequence of records, where each record consists of:
+                       kind             1B   unsigned char (0 = set, 1 = update, 2 = delete)
+                       ID length        2B   unsigned short
+                       content length   4B   unsigned int
+                       ID               utf-8 encoded
+                       content          JSON compressed by zlib (empty for deletes)
+
+The latest 'set' or 'delete' record of the ID supersedes all of its preceding records, while the
+'update' records extend the stats of the ID. Once the superseded records take more space than the
+current ones, the file is compacted. Stats files in the older format (the whole content as one
+compressed JSON) are still readable and are converted once they are modified.
+
+Modifications are not written immediately, but are collected in the in-process cache, which also
+remembers the locations of the records in the files, and are written in batches (at the latest at
+the exit of the process, or when the stats directory is listed or cleaned).
 """
 from __future__ import annotations
 
 # Standard Imports
-from typing import Optional, Iterable, BinaryIO, Callable, Any
+from typing import Optional, Iterable, Iterator, BinaryIO, Callable, Any
+import atexit
+import contextlib
+import fcntl
 import json
+import multiprocessing
 import os
 import re
 import shutil
+import struct
 import zlib
 
 # Third-Party Imports
@@ -60,6 +83,17 @@ PROFILE_TIMESTAMP_REGEX = re.compile(r"(-?\d{4}-\d{2}-\d{2}-\d{2}-\d{2}-\d{2})")
 # Default number of displayed records for listing stats objects
 DEFAULT_STATS_LIST_TOP = 20
 
+STATS_FILE_MAGIC: bytes = b"psts"
+STATS_FILE_VERSION: int = 1
+STATS_FILE_PREAMBLE: struct.Struct = struct.Struct("<4sB")
+STATS_RECORD_HEADER: struct.Struct = struct.Struct("<BHI")
+# Kinds of the records in the stats files
+RECORD_SET, RECORD_UPDATE, RECORD_DELETE = 0, 1, 2
+# Pending modifications of one stats file are written once their size exceeds the threshold
+FLUSH_THRESHOLD: int = 1 << 20
+# Stats files are compacted only if their superseded records are larger than the threshold
+COMPACTION_THRESHOLD: int = 1 << 16
+
 
 def build_stats_filename_as_profile_source(
     profile: str, ignore_timestamp: bool, minor_version: Optional[str] = None
@@ -162,8 +196,7 @@ def add_stats(
     """
 
     stats_file = get_stats_file_path(stats_filename, minor_version, create_dir=True)
-    # append: create the file if necessary, be able to read the whole file and write to the file
-    _modify_stats_file(stats_file, stats_ids, stats_contents, _add_to_dict)
+    _get_cached_stats_file(stats_file, create=True).modify(RECORD_SET, stats_ids, stats_contents)
 
     return stats_file
 
@@ -183,7 +216,7 @@ def update_stats(
     :param str minor_version: the minor version representation or None for HEAD
     """
     stats_file = get_stats_file_path(stats_filename, minor_version, create_dir=True)
-    _modify_stats_file(stats_file, stats_ids, extensions, _update_or_add_to_dict)
+    _get_cached_stats_file(stats_file, create=True).modify(RECORD_UPDATE, stats_ids, extensions)
 
 
 def get_stats_of(
@@ -203,14 +236,8 @@ def get_stats_of(
                   ID was not found in the stats file
     """
     stats_file = get_stats_file_path(stats_filename, minor_version, True)
-
-    # Load the whole stats content and filter the ID if present
-    with open(stats_file, "rb") as stats_handle:
-        stats_content = _load_stats_from(stats_handle)
-        if stats_ids is None:
-            return stats_content
-        # Extract the requested stats from the contents
-        return {sid: val for sid, val in stats_content.items() if sid in stats_ids}
+    # Only the requested records are loaded from the file
+    return _get_cached_stats_file(stats_file).read(stats_ids)
 
 
 def delete_stats(
@@ -224,13 +251,11 @@ def delete_stats(
     :param str minor_version: the minor version representation or None for HEAD
     """
     stats_file = get_stats_file_path(stats_filename, minor_version, True)
-    # We need to construct some dummy 'contents' variable
-    _modify_stats_file(
-        stats_file,
-        stats_ids,
-        [{} for _ in range(len(stats_ids))],
-        lambda d, sid, _: d.pop(sid, []),
-    )
+    cached_file = _get_cached_stats_file(stats_file)
+    # Deletion of IDs that are not in the file would only grow the file
+    stored_ids = set(cached_file.list_ids())
+    present_ids = [sid for sid in stats_ids if sid in stored_ids]
+    cached_file.modify(RECORD_DELETE, present_ids, [{} for _ in present_ids])
 
 
 def list_stats_for_minor(minor_version: Optional[str] = None) -> list[tuple[str, Any]]:
@@ -242,6 +267,8 @@ def list_stats_for_minor(minor_version: Optional[str] = None) -> list[tuple[str,
     """
     minor_exists, target_dir = find_minor_stats_directory(minor_version)
     if minor_exists:
+        # Make sure the sizes of the files correspond to their content
+        flush_stats()
         # We assume that all the files in the minor version stats directory are actually stats
         _, _, files = next(os.walk(target_dir))
         return [(file, os.stat(os.path.join(target_dir, file)).st_size) for file in files]
@@ -277,6 +304,7 @@ def delete_stats_file(
                                 version directory if set to True
     """
     stats_file = get_stats_file_path(stats_filename, minor_version, True)
+    _discard_cached_stats_files(stats_file)
     os.remove(stats_file)
     if not keep_directory:
         # Delete the minor version directory if it is empty
@@ -348,6 +376,9 @@ def delete_version_dirs(
     for version in minor_versions:
         try:
             version_dir = store.split_object_name(pcs.get_stats_directory(), version)[1]
+            if keep_directories or not only_empty:
+                # The pending modifications of the deleted files must not recreate them
+                _discard_cached_stats_files(version_dir)
             if keep_directories:
                 # Remove only the directories and files in the version directory
                 _, dirs, files = next(os.walk(version_dir))
@@ -386,6 +417,7 @@ def reset_stats(keep_directories: bool = False) -> None:
     else:
         # No need to keep the version directories, simply recreate the stats directory
         stats_dir = pcs.get_stats_directory()
+        _discard_cached_stats_files(stats_dir)
         shutil.rmtree(stats_dir)
         common_kit.touch_dir(stats_dir)
 
@@ -402,8 +434,9 @@ def clean_stats(keep_custom: bool = False, keep_empty: bool = False) -> None:
     :param bool keep_custom: the custom objects are kept in the stats directory if set to True
     :param bool keep_empty: the empty version directories are not deleted if set to True
     """
-    # First synchronize the index file
+    # First synchronize the index file and the stats files
     synchronize_index()
+    flush_stats()
     if not keep_custom:
         # Get the custom files and directories in the stats directory
         _, custom = _get_versions_in_stats_directory()
@@ -519,37 +552,329 @@ def _load_stats_from(stats_handle: BinaryIO) -> dict[str, Any]:
         return {}
 
 
-def _save_stats_to(stats_handle: BinaryIO, stats_records: dict[str, Any]) -> None:
-    """Saves and zips the stats contents (records) to the file.
+def _encode_record(kind: int, sid: str, content: dict[str, Any]) -> bytes:
+    """Encodes one record of the stats file
 
-    :param file stats_handle: the handle of the stats file
-    :param dict stats_records: the contents to save
+    :param int kind: kind of the record (set, update or delete)
+    :param str sid: a string that serves as a unique identification of the stats
+    :param dict content: the stats data of the record (ignored for deletes)
+
+    :return bytes: the encoded record
     """
-    # We need to rewrite the file contents, so move to the beginning and erase everything
-    stats_handle.seek(0)
-    stats_handle.truncate(0)
-    compressed = store.pack_content(json.dumps(stats_records, indent=2).encode("utf-8"))
-    stats_handle.write(compressed)
+    encoded_sid = sid.encode("utf-8")
+    payload = b"" if kind == RECORD_DELETE else zlib.compress(json.dumps(content).encode("utf-8"))
+    return STATS_RECORD_HEADER.pack(kind, len(encoded_sid), len(payload)) + encoded_sid + payload
 
 
-def _modify_stats_file(
-    stats_filepath: str,
-    stats_ids: list[str],
-    stats_contents: list[dict[str, dict[str, Any]]],
-    modify_function: Callable[[dict[str, Any], str, dict[str, Any]], None],
-) -> None:
-    """Modifies the contents of the given stats file by the provided modification function
-
-    :param str stats_filepath: the path to the stats file
-    :param list of str stats_ids: identifications of the stats block that are being modified
-    :param list of dict stats_contents: the data to modify (add, update, ...)
-    :param function modify_function: function that takes the stats contents as a parameter and modifies it accordingly
-    """
-    with open(stats_filepath, "a+b") as stats_handle:
-        stats_records = _load_stats_from(stats_handle)
-        for idx in range(min(len(stats_ids), len(stats_contents))):
-            modify_function(stats_records, stats_ids[idx], stats_contents[idx])
-        _save_stats_to(stats_handle, stats_records)
+# The modifications of stats content by the individual kinds of records
+_RECORD_MODIFICATIONS: dict[int, Callable[[dict[str, Any], str, dict[str, Any]], None]] = {
+    RECORD_SET: _add_to_dict,
+    RECORD_UPDATE: _update_or_add_to_dict,
+    RECORD_DELETE: lambda dictionary, sid, _: dictionary.pop(sid, None),
+}
+
+
+class CachedStatsFile:
+    """The stats file together with the locations of its records and the pending modifications.
+
+    :ivar str path: path to the stats file
+    :ivar tuple identity: device, inode, modification time and size of the file when it was last
+                          scanned
+    :ivar int scanned: number of scanned bytes of the file, i.e. the end of the last valid record
+    :ivar dict records: map of IDs to the (kind, offset, length) of the contents of their records,
+                        that are not superseded
+    :ivar int superseded: total size of the superseded records
+    :ivar list pending: the encoded records, which were not written to the file yet
+    :ivar int pending_size: total size of the pending records
+    :ivar dict legacy: the content of the file in the older format, which is to be converted
+    """
+
+    __slots__ = [
+        "path",
+        "identity",
+        "scanned",
+        "records",
+        "superseded",
+        "pending",
+        "pending_size",
+        "legacy",
+    ]
+
+    def __init__(self, path: str) -> None:
+        """
+        :param str path: path to the stats file
+        """
+        self.path = path
+        self.identity: Optional[tuple[int, int, int, int]] = None
+        self.scanned = 0
+        self.records: dict[str, list[tuple[int, int, int]]] = {}
+        self.superseded = 0
+        self.pending: list[tuple[int, str, bytes]] = []
+        self.pending_size = 0
+        self.legacy: Optional[dict[str, Any]] = None
+
+    def _reset(self) -> None:
+        """Forgets the scanned records of the file"""
+        self.identity, self.scanned, self.records, self.superseded = None, 0, {}, 0
+        self.legacy = None
+
+    def synchronize(self) -> None:
+        """Scans the records appended to the file since the last scan.
+
+        The whole file is scanned again, if it was replaced or truncated in the meantime.
+        """
+        try:
+            file_stat = os.stat(self.path)
+        except FileNotFoundError:
+            self._reset()
+            return
+        identity = (
+            file_stat.st_dev,
+            file_stat.st_ino,
+            file_stat.st_mtime_ns,
+            file_stat.st_size,
+        )
+        if identity[:2] != (self.identity or (None, None))[:2] or file_stat.st_size < self.scanned:
+            self._reset()
+        elif identity == self.identity:
+            return
+        self.identity = identity
+        with open(self.path, "rb") as stats_handle:
+            if self.scanned == 0:
+                preamble = stats_handle.read(STATS_FILE_PREAMBLE.size)
+                if len(preamble) < STATS_FILE_PREAMBLE.size or preamble[:4] != STATS_FILE_MAGIC:
+                    # Empty or older stats files are loaded at once
+                    self.legacy = _load_stats_from(stats_handle) if preamble else {}
+                    self.scanned = file_stat.st_size
+                    return
+                self.scanned = STATS_FILE_PREAMBLE.size
+            self._scan_records(stats_handle, file_stat.st_size)
+
+    def _scan_records(self, stats_handle: BinaryIO, file_size: int) -> None:
+        """Scans the headers of the records starting at the already scanned offset
+
+        :param file stats_handle: the handle of the stats file
+        :param int file_size: the size of the stats file
+        """
+        stats_handle.seek(self.scanned)
+        while True:
+            header = stats_handle.read(STATS_RECORD_HEADER.size)
+            if len(header) < STATS_RECORD_HEADER.size:
+                # The record may be still being written by another process
+                return
+            kind, sid_length, content_length = STATS_RECORD_HEADER.unpack(header)
+            sid = stats_handle.read(sid_length).decode("utf-8", errors="replace")
+            offset = stats_handle.tell()
+            if offset + content_length > file_size:
+                return
+            stats_handle.seek(content_length, os.SEEK_CUR)
+            record_size = STATS_RECORD_HEADER.size + sid_length + content_length
+            if kind == RECORD_UPDATE and sid in self.records:
+                self.records[sid].append((kind, offset, content_length))
+            else:
+                # Set and delete records supersede all the preceding records of the ID
+                self.superseded += sum(length for (_, _, length) in self.records.pop(sid, []))
+                if kind == RECORD_DELETE:
+                    self.superseded += record_size
+                else:
+                    self.records[sid] = [(kind, offset, content_length)]
+            self.scanned = offset + content_length
+
+    def list_ids(self) -> list[str]:
+        """
+        :return list: IDs of all the stats in the file (including the pending ones)
+        """
+        return list(self.read(None, with_contents=False))
+
+    def read(
+        self, stats_ids: Optional[list[str]], with_contents: bool = True
+    ) -> dict[str, dict[str, Any]]:
+        """Reads the stats of the given IDs, i.e. only the records of the IDs are loaded
+
+        :param list stats_ids: the IDs of the read stats or None for all the stats
+        :param bool with_contents: if set to False, the contents are not loaded (only the IDs)
+
+        :return dict: the stats of the IDs that are present in the file
+        """
+        self.synchronize()
+        stats_content: dict[str, Any] = {}
+        wanted = None if stats_ids is None else set(stats_ids)
+        if self.legacy is not None:
+            stats_content.update(
+                (sid, content)
+                for sid, content in self.legacy.items()
+                if wanted is None or sid in wanted
+            )
+        elif self.records:
+            with open(self.path, "rb") as stats_handle:
+                for sid, records in self.records.items():
+                    if wanted is not None and sid not in wanted:
+                        continue
+                    stats_content[sid] = {}
+                    for kind, offset, length in records if with_contents else []:
+                        stats_handle.seek(offset)
+                        content = json.loads(zlib.decompress(stats_handle.read(length)))
+                        _RECORD_MODIFICATIONS[kind](stats_content, sid, content)
+        for kind, sid, record in self.pending:
+            if wanted is None or sid in wanted:
+                content = {} if kind == RECORD_DELETE or not with_contents else _decode(record)
+                _RECORD_MODIFICATIONS[kind](stats_content, sid, content)
+        return stats_content
+
+    def modify(self, kind: int, stats_ids: list[str], stats_contents: list[dict[str, Any]]) -> None:
+        """Records the modification of the stats, which is written later in a batch
+
+        The contents are encoded immediately, hence the later changes of the passed objects do
+        not affect the stored stats.
+
+        :param int kind: kind of the modification (set, update or delete)
+        :param list of str stats_ids: identifications of the modified stats
+        :param list of dict stats_contents: the data of the modification
+        """
+        for sid, content in zip(stats_ids, stats_contents):
+            record = _encode_record(kind, sid, content)
+            self.pending.append((kind, sid, record))
+            self.pending_size += len(record)
+        if self.pending_size > FLUSH_THRESHOLD or _WRITE_THROUGH:
+            self.flush()
+
+    def flush(self) -> None:
+        """Writes the pending modifications to the file.
+
+        The records are appended to the file by a single write, unless the file needs to be
+        compacted or converted from the older format, in which case the whole file is rewritten.
+        The file is modified under the lock of its directory, so the records appended by other
+        processes are not lost by concurrent compaction.
+        """
+        if not self.pending:
+            return
+        with _locked_directory(os.path.dirname(self.path)):
+            self._flush_locked()
+
+    def _flush_locked(self) -> None:
+        """Writes the pending modifications to the file, while holding the lock of its directory"""
+        self.synchronize()
+        current_size = sum(
+            length for records in self.records.values() for (_, _, length) in records
+        )
+        if (
+            self.legacy is not None
+            or self.identity is None
+            or self.scanned != os.path.getsize(self.path)
+            or self.superseded > max(current_size, COMPACTION_THRESHOLD)
+        ):
+            self._compact()
+        else:
+            with open(self.path, "ab") as stats_handle:
+                stats_handle.write(b"".join(record for (_, _, record) in self.pending))
+        self.pending, self.pending_size = [], 0
+
+    def _compact(self) -> None:
+        """Rewrites the file with the current stats only.
+
+        The file is first written into temporary file, which is then atomically renamed, so
+        the concurrent readers never see partially written file.
+        """
+        stats_content = self.read(None)
+        tmp_file = f"{self.path}.{os.getpid()}.tmp"
+        with open(tmp_file, "wb") as tmp_handle:
+            tmp_handle.write(STATS_FILE_PREAMBLE.pack(STATS_FILE_MAGIC, STATS_FILE_VERSION))
+            for sid, content in stats_content.items():
+                tmp_handle.write(_encode_record(RECORD_SET, sid, content))
+        os.replace(tmp_file, self.path)
+        self._reset()
+
+
+def _decode(record: bytes) -> dict[str, Any]:
+    """Decodes the content of the encoded record
+
+    :param bytes record: the encoded record
+
+    :return dict: the stats data of the record
+    """
+    _, sid_length, _ = STATS_RECORD_HEADER.unpack_from(record)
+    return json.loads(zlib.decompress(record[STATS_RECORD_HEADER.size + sid_length :]))
+
+
+@contextlib.contextmanager
+def _locked_directory(path: str) -> Iterator[None]:
+    """Holds the exclusive lock of the directory for the duration of the context.
+
+    The directory is locked instead of the stats file itself, since the file is replaced during
+    the compaction.
+
+    :param str path: path to the locked directory
+    """
+    directory_fd = os.open(path, os.O_RDONLY)
+    try:
+        fcntl.flock(directory_fd, fcntl.LOCK_EX)
+        yield
+    finally:
+        os.close(directory_fd)
+
+
+# The stats files used by this process, identified by their absolute paths
+_CACHED_STATS_FILES: dict[str, CachedStatsFile] = {}
+# Workers (e.g. of the parallel jobs) may exit without running the exit handlers, hence they
+# write the modifications immediately
+_WRITE_THROUGH: bool = multiprocessing.parent_process() is not None
+
+
+def _get_cached_stats_file(stats_file: str, create: bool = False) -> CachedStatsFile:
+    """Obtains the cached stats file, i.e. the stats file with its pending modifications
+
+    :param str stats_file: the path to the stats file
+    :param bool create: the (empty) stats file is created if it does not exist yet
+
+    :return CachedStatsFile: the cached stats file
+    """
+    stats_file = os.path.abspath(stats_file)
+    if create and not os.path.exists(stats_file):
+        with open(stats_file, "wb") as stats_handle:
+            stats_handle.write(STATS_FILE_PREAMBLE.pack(STATS_FILE_MAGIC, STATS_FILE_VERSION))
+    if stats_file not in _CACHED_STATS_FILES:
+        _CACHED_STATS_FILES[stats_file] = CachedStatsFile(stats_file)
+    return _CACHED_STATS_FILES[stats_file]
+
+
+def _discard_cached_stats_files(path: str) -> None:
+    """Discards the cached stats files (including their pending modifications) in the path
+
+    :param str path: the path to the stats file or the directory with stats files
+    """
+    path = os.path.abspath(path)
+    for stats_file in list(_CACHED_STATS_FILES):
+        if stats_file == path or stats_file.startswith(path + os.sep):
+            del _CACHED_STATS_FILES[stats_file]
+
+
+def flush_stats() -> None:
+    """Writes the pending modifications of all the stats files used by this process.
+
+    Stats files that cannot be written (e.g. since they were removed) are discarded.
+    """
+    for stats_file, cached_file in list(_CACHED_STATS_FILES.items()):
+        try:
+            cached_file.flush()
+        except OSError as exc:
+            perun_log.msg_to_file(f"Stats file '{stats_file}' could not be written: {exc}", 0)
+            del _CACHED_STATS_FILES[stats_file]
+
+
+def _start_writing_through() -> None:
+    """Discards the modifications of the parent in the forked child and writes its own
+    modifications immediately (forked children usually exit without running the exit handlers)
+    """
+    global _WRITE_THROUGH
+    _CACHED_STATS_FILES.clear()
+    _WRITE_THROUGH = True
+
+
+# make sure that the pending modifications are written in the end; they are written before the
+# fork as well, so the forked children (e.g. workers) see them, but must not write them again
+atexit.register(flush_stats)
+if hasattr(os, "register_at_fork"):
+    os.register_at_fork(before=flush_stats, after_in_child=_start_writing_through)
 
 
 def _get_version_candidates(minor_checksum: str, minor_date: str) -> list[str]:
@@ -13,14 +13,15 @@ import os
 import re
 import string
 import struct
-import zlib
 
 # Third-Party Imports
 
 # Perun Imports
+from perun.logic import cache
+from perun.profile import binary
 from perun.profile.factory import Profile
 from perun.utils import log
-from perun.utils.common import common_kit
+from perun.utils.common import common_kit, compression_kit
 from perun.utils.exceptions import IncorrectProfileFormatException
 from perun.utils.structs import PerformanceChange, DegradationInfo
 
@@ -64,23 +65,58 @@ def version_path_to_sha(sha_path: str) -> Optional[str]:
 def pack_content(content: bytes) -> bytes:
     """Pack the given content with packing algorithm.
 
-    Uses the zlib compression algorithm, to deflate the content.
+    The content is split into blocks, which are independently deflated by the zlib compression
+    algorithm in parallel (see :mod:`perun.utils.common.compression_kit`).
 
     :param bytes content: content we are packing to bytes
     :returns bytes: packed content
     """
-    return zlib.compress(content)
+    return compression_kit.compress(content)
+
+
+def write_packed_content(handle: BinaryIO, content: bytes) -> None:
+    """Packs the given content directly into the opened handle.
+
+    Unlike :func:`pack_content`, the packed content is never held in the memory as a whole,
+    the blocks are written to the handle as soon as they are compressed.
+
+    :param file handle: opened binary handle, where the packed content is written
+    :param bytes content: content we are packing
+    """
+    with compression_kit.BlockWriter(handle) as writer:
+        writer.write(content)
+
+
+def pack_profile_object(profile: Profile, object_format: str = "binary") -> tuple[str, bytes]:
+    """Packs the profile into the content of the object stored in the object directory.
+
+    Profiles are either stored in the binary columnar format (see :mod:`perun.profile.binary`), or
+    as JSON, with header stating the type of the profile and length of the body, packed by zlib.
+
+    :param Profile profile: packed profile
+    :param str object_format: format of the object, either 'binary' or 'json'
+    :returns (str, bytes): checksum of the object and the packed content of the object
+    """
+    if object_format == "binary":
+        binary_content = binary.pack_profile(profile)
+        return compute_checksum(binary_content), binary_content
+
+    str_profile_content = json.dumps(profile.serialize())
+    header = f"profile {profile['header']['type']} {len(str_profile_content)}\0"
+    profile_content = (header + str_profile_content).encode("utf-8")
+    return compute_checksum(profile_content), pack_content(profile_content)
 
 
 def read_and_deflate_chunk(file_handle: BinaryIO) -> str:
     """
+    Both the block containers and the contents packed by plain zlib (used by older versions of
+    Perun) are supported.
+
     :param file file_handle: opened file handle
     :returns str: deflated chunk or whole file
+    :raises zlib.error: when the packed content is malformed
     """
-    packed_content = file_handle.read()
-
-    decompressor = zlib.decompressobj()
-    return decompressor.decompress(packed_content).decode("utf-8")
+    return compression_kit.decompress(file_handle).decode("utf-8")
 
 
 def split_object_name(base_dir: str, object_name: str, object_ext: str = "") -> tuple[str, str]:
@@ -306,13 +342,38 @@ def load_profile_from_file(
     :returns: JSON dictionary w.r.t. :ref:`profile-spec`
     :raises IncorrectProfileFormatException: raised, when **filename** contains
         data, which cannot be converted to valid :ref:`profile-spec`
-    Fixme: Add cache! Really badly!
     """
     if not unsafe_load and not os.path.exists(file_name):
         raise IncorrectProfileFormatException(file_name, "file '{}' not found")
 
+    # Profiles from the object store are immutable, hence their decoded form can be cached
+    checksum = None if is_raw_profile else version_path_to_sha(os.fspath(file_name))
+    if checksum is not None and (profile := cache.load_cached_profile(file_name, checksum)):
+        return profile
+
+    with open(file_name, "rb") as file_handle:
+        profile = load_profile_from_handle(file_name, file_handle, is_raw_profile)
+    if checksum is not None:
+        cache.store_cached_profile(file_name, checksum, profile)
+    return profile
+
+
+def load_profile_header(file_name: str) -> Optional[Profile]:
+    """Loads the profile from the object store without its resources, if it can be done cheaply
+
+    Only profiles in binary format (see :mod:`perun.profile.binary`) store their header separately
+    from the resources; profiles in other formats have to be loaded whole.
+
+    :param str file_name: file path, where the profile is stored
+    :returns: profile without resources, or None if the profile is not in binary format
+    :raises IncorrectProfileFormatException: when the header of the profile is malformed
+    """
     with open(file_name, "rb") as file_handle:
-        return load_profile_from_handle(file_name, file_handle, is_raw_profile)
+        if not binary.is_binary_profile(file_handle.read(4)):
+            return None
+        file_handle.seek(0)
+        reader = binary.BinaryProfileReader(file_name, file_handle)
+        return Profile({**reader.profile, "resource_type_map": reader.resource_type_map})
 
 
 def load_profile_from_handle(
@@ -329,6 +390,13 @@ def load_profile_from_handle(
     :raises IncorrectProfileFormatException: when the profile cannot be parsed by json.loads(body)
         or when the profile is not in correct supported format or when the profile is malformed
     """
+    # Profiles in binary format are detected by their prefix, regardless of being raw
+    start = file_handle.tell()
+    is_binary_profile = binary.is_binary_profile(file_handle.read(4))
+    file_handle.seek(start)
+    if is_binary_profile:
+        return binary.BinaryProfileReader(file_name, file_handle).to_profile()
+
     if is_raw_profile:
         body = file_handle.read().decode("utf-8")
     else:
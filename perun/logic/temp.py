@@ -582,16 +582,15 @@ def _write_to_temp(
     :param bool protect: if True, the file will have the protected status
     :param bool compress: if True, the content will be compressed
     """
-    # Optionally encode the content to json and compress it
-    file_mode = "w+"
+    # Optionally encode the content to json and compress it while writing it to the tmp file
     if json_format:
         content = json.dumps(content, indent=2)
     if compress:
-        file_mode = "w+b"
-        content = store.pack_content(content.encode("utf-8"))
-    # Write the content to the tmp file
-    with open(file_path, file_mode) as tmp_handle:
-        tmp_handle.write(content)
+        with open(file_path, "w+b") as tmp_handle:
+            store.write_packed_content(tmp_handle, content.encode("utf-8"))
+    else:
+        with open(file_path, "w+") as tmp_handle:
+            tmp_handle.write(content)
     # Save the properties to the index file if needed
     _add_to_index(file_path, json_format, protect, compress)
 
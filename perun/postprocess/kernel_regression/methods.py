@@ -15,10 +15,12 @@ from sklearn import metrics, base as sklearn
 import click.exceptions as click_exp
 import numpy as np
 import sklearn.metrics.pairwise as kernels
+from scipy import signal
 import statsmodels.nonparametric.api as nparam
 
 # Perun Imports
 from perun.postprocess.regression_analysis import tools
+from perun.utils.common import parallel_kit
 import perun.thirdparty.pyqt_fit_port as pyqt_fit
 
 if TYPE_CHECKING:
@@ -34,9 +36,16 @@ np.seterr(divide="ignore", invalid="ignore")
 # - scott: Scott's Rule of Thumb (default method)
 # - silverman: Silverman's Rule of Thumb
 BW_SELECTION_METHODS = ["scott", "silverman"]
+# Helper methods for determines the kernel bandwidth in `kernel-smoothing` mode
+# - cv_ls: least-squares leave-one-out cross-validation computed over the binned points
+SMOOTHING_BW_SELECTION_METHODS = BW_SELECTION_METHODS + ["cv_ls"]
 
 # Minimum points count to perform the regression
 _MIN_POINTS_COUNT = 3
+# Default number of the grid points of the binned kernel smoothing
+DEFAULT_GRID_SIZE = 2048
+# Number of the bandwidths examined by the cross-validation bandwidth selector
+_CV_BANDWIDTHS_COUNT = 32
 
 
 class KernelRidge(sklearn.BaseEstimator, sklearn.RegressorMixin):
@@ -124,8 +133,163 @@ class KernelRidge(sklearn.BaseEstimator, sklearn.RegressorMixin):
         return self.gamma
 
 
+class BinnedKernelSmoothing:
+    """
+    This class implements the binned approximation of the local-polynomial kernel
+    smoothing used by `kernel-smoothing` mode of this kernel regression postprocessor.
+
+    The points are linearly binned into the equidistant grid, i.e. each point splits its
+    weight between the two nearest grid points in proportion to its distance from them.
+    The weighted sums needed by the local-polynomial estimate at the grid points are then
+    discrete convolutions of the binned counts and values with the kernel sampled at the
+    grid offsets, which are computed at once by FFT. Hence, the estimate costs O(n) for the
+    binning and O(m log m) for the convolutions (where m is the size of the grid) instead of
+    O(n^2) of the exact evaluation. The estimates at the points are interpolated from the grid.
+
+    Since the binning does not depend on the bandwidth, the same instance can cheaply
+    evaluate many bandwidths, which is used by the leave-one-out cross-validation selector.
+
+    :ivar np.ndarray y_pts: the array of y points coordinates
+    :ivar np.ndarray lower_bins: index of the nearest lower grid point of each point
+    :ivar np.ndarray upper_weights: weight of each point assigned to the nearest upper grid point
+    :ivar object kernel: kernel of the smoothing (e.g. `pyqt_fit.Epanechnikov`)
+    :ivar int degree: degree of the local polynomials (0 stands for Nadaraya-Watson estimate)
+    :ivar np.ndarray grid: the equidistant grid of x coordinates
+    :ivar np.ndarray binned: linearly binned counts and sums of y points at the grid points
+    """
+
+    __slots__ = ["y_pts", "lower_bins", "upper_weights", "kernel", "degree", "grid", "binned"]
+
+    def __init__(
+        self,
+        x_pts: npt.NDArray[np.float64],
+        y_pts: npt.NDArray[np.float64],
+        kernel: Any,
+        degree: int,
+        grid_size: int = DEFAULT_GRID_SIZE,
+    ) -> None:
+        """
+        Initialization method for `BinnedKernelSmoothing` class, which bins the points.
+
+        :param np.ndarray x_pts: the array of x points coordinates
+        :param np.ndarray y_pts: the array of y points coordinates
+        :param object kernel: kernel of the smoothing
+        :param int degree: degree of the local polynomials
+        :param int grid_size: number of the grid points
+        """
+        self.y_pts = y_pts
+        self.kernel = kernel
+        self.degree = degree
+        self.grid = np.linspace(x_pts.min(), x_pts.max(), max(grid_size, 2))
+
+        # Split the weight of each point between the two nearest grid points
+        spacing = self.grid[1] - self.grid[0]
+        positions = (x_pts - self.grid[0]) / spacing if spacing > 0 else np.zeros_like(x_pts)
+        self.lower_bins = np.clip(np.floor(positions).astype(np.int64), 0, len(self.grid) - 2)
+        self.upper_weights = positions - self.lower_bins
+        self.binned = np.array(
+            [
+                np.bincount(self.lower_bins, weights * (1 - self.upper_weights), len(self.grid))
+                + np.bincount(self.lower_bins + 1, weights * self.upper_weights, len(self.grid))
+                for weights in (np.ones_like(y_pts), y_pts)
+            ]
+        )
+
+    def _interpolate(self, grid_values: npt.NDArray[np.float64]) -> npt.NDArray[np.float64]:
+        """
+        Linearly interpolates the values at the grid points to the points of the instance.
+
+        :param np.ndarray grid_values: values at the grid points
+        :return np.ndarray: interpolated values at the points
+        """
+        lower_values = grid_values[self.lower_bins]
+        return lower_values + (grid_values[self.lower_bins + 1] - lower_values) * self.upper_weights
+
+    def _fit_grid(
+        self, bandwidth: float
+    ) -> tuple[npt.NDArray[np.float64], npt.NDArray[np.float64]]:
+        """
+        Computes the local-polynomial estimate at the grid points.
+
+        :param float bandwidth: bandwidth of the kernel
+        :return: estimates at the grid points and the weights, that the estimates at the grid
+            points give to the value of the point located exactly at the grid point
+        """
+        grid_size, spacing = len(self.grid), self.grid[1] - self.grid[0]
+        # Kernels with infinite support are sampled on the whole range of the grid
+        support = self.kernel.upper if np.isfinite(self.kernel.upper) else np.inf
+        half_width = int(min(np.ceil(support * bandwidth / spacing), grid_size - 1))
+        offsets = np.arange(half_width, -half_width - 1, -1) * spacing / bandwidth
+        kernel_values = self.kernel(offsets)
+
+        # Moments s_r = sum_l K(z_l) z_l^r c_l and t_r = sum_l K(z_l) z_l^r y_l of binned points
+        # with z_l = (g_l - g_j) / h; all of them are computed by one batched FFT convolution
+        powers = np.concatenate(
+            [np.arange(2 * self.degree + 1), np.arange(self.degree + 1)]
+        ).reshape(-1, 1)
+        signals = np.repeat(self.binned, [2 * self.degree + 1, self.degree + 1], axis=0)
+        moments = signal.fftconvolve(signals, kernel_values * offsets**powers, axes=-1)
+        moments = moments[:, half_width : half_width + grid_size]
+        # FFT introduces tiny negative values in the regions without any points
+        moments[0] = np.maximum(moments[0], 0)
+        s_moments, t_moments = moments[: 2 * self.degree + 1], moments[2 * self.degree + 1 :]
+
+        # Solve the local weighted least squares at each grid point
+        indices = np.add.outer(np.arange(self.degree + 1), np.arange(self.degree + 1))
+        inverse = np.linalg.pinv(
+            np.moveaxis(s_moments[indices], -1, 0), rcond=1e-12, hermitian=True
+        )[:, 0, :]
+        estimates = np.einsum("ij,ji->i", inverse, t_moments)
+        return estimates, self.kernel(np.zeros(1))[0] * inverse[:, 0]
+
+    def predict(self, bandwidth: float) -> npt.NDArray[np.float64]:
+        """
+        Computes the estimate at the points of the instance.
+
+        :param float bandwidth: bandwidth of the kernel
+        :return np.ndarray: array with values of resulting kernel estimates
+        """
+        estimates, _ = self._fit_grid(bandwidth)
+        return self._interpolate(estimates)
+
+    def cross_validation_score(self, bandwidth: float) -> float:
+        """
+        Computes the mean squared error of the leave-one-out cross-validation.
+
+        Since the local-polynomial estimate is a linear smoother, the leave-one-out residual
+        of a point is its residual divided by (1 - L_ii), where L_ii is the weight of the point
+        in its own estimate. Hence, no estimate has to be recomputed.
+
+        :param float bandwidth: bandwidth of the kernel
+        :return float: the mean squared error or nan if no point can be left out
+        """
+        estimates, self_weights = self._fit_grid(bandwidth)
+        residuals = (self.y_pts - self._interpolate(estimates)) / (
+            1 - self._interpolate(self_weights)
+        )
+        residuals = residuals[np.isfinite(residuals)]
+        return float(np.mean(residuals**2)) if len(residuals) else np.nan
+
+    def select_bandwidth(self, candidates: int = _CV_BANDWIDTHS_COUNT) -> float:
+        """
+        Selects the bandwidth minimizing the error of the leave-one-out cross-validation.
+
+        The candidates are spread logarithmically between few grid spacings (below which the
+        binned estimate is not accurate) and half of the range of the points.
+
+        :param int candidates: number of the examined bandwidths
+        :return float: the selected bandwidth
+        """
+        spacing, x_range = self.grid[1] - self.grid[0], self.grid[-1] - self.grid[0]
+        if x_range == 0:
+            return 1.0
+        bandwidths = np.geomspace(min(3 * spacing, x_range / 20), x_range / 2, candidates)
+        scores = np.array([self.cross_validation_score(bandwidth) for bandwidth in bandwidths])
+        return float(bandwidths[np.nanargmin(scores) if not np.isnan(scores).all() else -1])
+
+
 def compute_kernel_regression(
-    data_gen: Iterator[tuple[list[float], list[float], str]], config: dict[str, Any]
+    data_gen: Iterator[tuple[Any, Any, str]], config: dict[str, Any]
 ) -> list[dict[str, Any]]:
     """
     This method represents the wrapper for all modes of kernel regression postprocessor.
@@ -146,16 +310,27 @@ def compute_kernel_regression(
         [],
     )
 
-    # list of resulting models computed by kernel analysis
-    kernel_models = []
-    for x_pts, y_pts, uid in data_gen:
-        # calling the method, that ensures the calling the relevant mode of kernel regression
-        kernel_model = execute_kernel_regression(x_pts, y_pts, config)
-        kernel_model["uid"] = uid
-        kernel_model["model"] = "kernel_regression"
-        # add partial result to the model result list - create output dictionary with kernel models
-        kernel_models.append(kernel_model)
-    return kernel_models
+    # list of resulting models computed by kernel analysis, possibly in parallel for each chunk
+    return parallel_kit.map_chunks(compute_chunk, data_gen, config)
+
+
+def compute_chunk(
+    x_pts: list[float], y_pts: list[float], uid: str, config: dict[str, Any]
+) -> dict[str, Any]:
+    """
+    Computes the kernel model for one chunk of resources (i.e. one uid).
+
+    :param list x_pts: the list of x points coordinates
+    :param list y_pts: the list of y points coordinates
+    :param str uid: uid of the chunk
+    :param dict config: the perun and option context contains the entered options and commands
+    :return dict: the output dictionary with the kernel model
+    """
+    # calling the method, that ensures the calling the relevant mode of kernel regression
+    kernel_model = execute_kernel_regression(x_pts, y_pts, config)
+    kernel_model["uid"] = uid
+    kernel_model["model"] = "kernel_regression"
+    return kernel_model
 
 
 def kernel_regression(
@@ -273,7 +448,8 @@ def kernel_smoothing(
     This method executing the computation of `kernel-smoothing` mode.
 
     Method computing the kernel regression using the `PyQt-Fit` non-parametric
-    kernel regression class: pyqt_fit.nonparam_regression.NonParamRegression
+    kernel regression class: pyqt_fit.nonparam_regression.NonParamRegression, or
+    its binned approximation `BinnedKernelSmoothing`, if the `binned` option is set.
 
     After the adaption coordinates list to the required type array are obtained the
     relevant instances of kernel and regression method according to the selected options
@@ -296,41 +472,69 @@ def kernel_smoothing(
     # Obtaining the method instance from supported regression methods according to the given name
     method = _SMOOTHING_METHODS_MAPS[config["smoothing_method"]](config["polynomial_order"])
 
-    # User entered the bandwidth value directly
-    if config["bandwidth_value"]:
-        # Perform the non-parametric kernel regression with user-selected kernel bandwidth
-        kernel_estimate = pyqt_fit.NonParamRegression(
+    binned_estimate = None
+    if config.get("binned") or config["bandwidth_method"] == "cv_ls":
+        binned_estimate = BinnedKernelSmoothing(
             x_pts,
             y_pts,
-            bandwidth=config["bandwidth_value"],
-            kernel=kernel,
-            method=method,
+            *_binned_kernel_and_degree(config),
+            grid_size=config.get("grid_size", DEFAULT_GRID_SIZE),
         )
-    else:  # User entered the method for bandwidth selection or did not choose any option
-        # Compute the optimal kernel bandwidth according to selected method
-        if config["bandwidth_method"] == "scott":
-            covariance = pyqt_fit.scotts_covariance(x_pts)
-        else:
-            covariance = pyqt_fit.silverman_covariance(x_pts)
-        # Perform the non-parametric kernel regression with method-computed kernel bandwidth
+
+    # Compute the optimal kernel bandwidth according to selected method
+    if config["bandwidth_value"]:
+        bandwidth = config["bandwidth_value"]
+    elif config["bandwidth_method"] == "cv_ls":
+        bandwidth = cast(BinnedKernelSmoothing, binned_estimate).select_bandwidth()
+    elif config["bandwidth_method"] == "scott":
+        bandwidth = np.sqrt(pyqt_fit.scotts_covariance(x_pts)[0][0])
+    else:
+        bandwidth = np.sqrt(pyqt_fit.silverman_covariance(x_pts)[0][0])
+
+    if config.get("binned"):
+        kernel_values = cast(BinnedKernelSmoothing, binned_estimate).predict(bandwidth)
+    else:
+        # Perform the non-parametric kernel regression with the kernel bandwidth
         kernel_estimate = pyqt_fit.NonParamRegression(
-            x_pts, y_pts, method=method, kernel=kernel, covariance=covariance
+            x_pts, y_pts, bandwidth=bandwidth, kernel=kernel, method=method
         )
-
-    # Call the method to fit the parameters of the fitting
-    kernel_estimate.fit()
-    # Ensuring the achievement of the desired outcome
-    kernel_estimate = iterative_computation(
-        x_pts, y_pts, kernel_estimate, method=method, kernel=kernel
-    )
+        # Call the method to fit the parameters of the fitting
+        kernel_estimate.fit()
+        # Ensuring the achievement of the desired outcome
+        kernel_estimate = iterative_computation(
+            x_pts, y_pts, kernel_estimate, method=method, kernel=kernel
+        )
+        bandwidth = kernel_estimate.bandwidth[0][0]
+        kernel_values = kernel_estimate(x_pts)
 
     # Set parameter for resulting kernel model
-    return {
-        "bandwidth": kernel_estimate.bandwidth[0][0],
-        "r_square": metrics.r2_score(y_pts, kernel_estimate(x_pts)),
-        "bucket_stats": list(kernel_estimate(x_pts)),
+    kernel_model = {
+        "bandwidth": bandwidth,
+        "r_square": metrics.r2_score(y_pts, kernel_values),
+        "bucket_stats": list(kernel_values),
         "kernel_mode": "smoothing",
     }
+    if config.get("binned"):
+        kernel_model["grid_size"] = len(cast(BinnedKernelSmoothing, binned_estimate).grid)
+    return kernel_model
+
+
+def _binned_kernel_and_degree(config: dict[str, Any]) -> tuple[Any, int]:
+    """
+    Obtains the kernel and the degree of local polynomials of the binned kernel smoothing,
+    which correspond to the exact methods of `kernel-smoothing` mode.
+
+    Note that the local-linear method (and the local-polynomial method of order 1) of the
+    `PyQt-Fit` always uses the normal kernel.
+
+    :param dict config: the perun and option context contains the entered options and commands
+    :return: the kernel and the degree of the local polynomials
+    """
+    if config["smoothing_method"] == "spatial-average":
+        return _KERNEL_TYPES_MAPS[config["kernel_type"]], 0
+    degree = 1 if config["smoothing_method"] == "local-linear" else config["polynomial_order"]
+    kernel = _KERNEL_TYPES_MAPS["normal" if degree == 1 else config["kernel_type"]]
+    return kernel, degree
 
 
 def kernel_ridge(
@@ -394,8 +598,9 @@ def execute_kernel_regression(
     :param dict config: the perun and option context contains the entered options and commands
     :return dict: the output dictionary with result of kernel regression
     """
-    # Sort the points to the right order for computation
-    x_pts, y_pts = cast(tuple[list[float], list[float]], zip(*sorted(zip(x_pts, y_pts))))
+    # Sort the points to the right order for computation (by x and then by y coordinates)
+    order = np.lexsort((y_pts, x_pts))
+    x_pts, y_pts = np.asarray(x_pts)[order].tolist(), np.asarray(y_pts)[order].tolist()
 
     # Create the initial dictionary, that contains the common items for all modes
     kernel_model = {
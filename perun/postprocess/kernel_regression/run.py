@@ -70,7 +70,7 @@ def postprocess(
     """
     # Perform the non-parametric analysis using the kernel regression
     kernel_models = methods.compute_kernel_regression(
-        data_provider.generic_profile_provider(profile, **configuration), configuration
+        data_provider.columnar_profile_provider(profile, **configuration), configuration
     )
 
     # Return the profile after the execution of kernel regression
@@ -438,14 +438,15 @@ def method_selection(ctx: click.Context, **kwargs: Any) -> None:
 @click.option(
     "--bandwidth-method",
     "-bm",
-    type=click.Choice(methods.BW_SELECTION_METHODS),
-    default=methods.BW_SELECTION_METHODS[0],
+    type=click.Choice(methods.SMOOTHING_BW_SELECTION_METHODS),
+    default=methods.SMOOTHING_BW_SELECTION_METHODS[0],
     help=(
         "Provides the helper method to determine the kernel bandwidth. The "
         "<bandwidth_method> will be used to compute the bandwidth, which will be used "
-        "at kernel-smoothing regression. Cannot be entered in combination with "
-        "<bandwidth-value>, then will be ignored and will be accepted value from "
-        "<bandwidth-value>."
+        "at kernel-smoothing regression. The `cv_ls` method selects the bandwidth by "
+        "leave-one-out cross-validation computed over the binned points. Cannot be "
+        "entered in combination with <bandwidth-value>, then will be ignored and will be "
+        "accepted value from <bandwidth-value>."
     ),
 )
 @click.option(
@@ -469,6 +470,27 @@ def method_selection(ctx: click.Context, **kwargs: Any) -> None:
         "methods ignoring it."
     ),
 )
+@click.option(
+    "--binned",
+    "-bn",
+    is_flag=True,
+    default=False,
+    help=(
+        "Computes the binned approximation of the kernel smoothing, which bins the points "
+        "into the equidistant grid and evaluates the kernel sums by FFT convolution. The "
+        "approximation is practical for millions of points."
+    ),
+)
+@click.option(
+    "--grid-size",
+    "-gz",
+    type=click.IntRange(min=2, max=None),
+    default=methods.DEFAULT_GRID_SIZE,
+    help=(
+        "Number of the grid points used by the binned kernel smoothing and by the `cv_ls` "
+        "bandwidth method. Larger grids are more accurate, but slower."
+    ),
+)
 @click.pass_context
 def kernel_smoothing(ctx: click.Context, **kwargs: Any) -> None:
     r"""
@@ -580,7 +602,19 @@ def kernel_smoothing(ctx: click.Context, **kwargs: Any) -> None:
     The supported methods are *Scotts's Rule* and *Silverman's Rule*, which are described in
     :ref:`postprocessors-kernel-regression-method_selection`. This parameter cannot be entered in
     combination with <bandwidth-value>, then will be ignored and will be accepted value from
-    <bandwidth-value>.
+    <bandwidth-value>. Moreover, the *cv_ls* method selects the bandwidth minimizing the error of
+    the least-squares leave-one-out cross-validation, which is computed over the binned points.
+
+        **Binned Kernel Smoothing <binned>**:
+
+        The exact computation of the kernel estimate evaluates the kernel for each pair of points,
+        which is quadratic in the number of points. With <binned> option the points are linearly
+        binned into the equidistant grid of <grid-size> points first, i.e. each point splits its
+        weight between the two nearest grid points. The kernel sums at the grid points are then
+        discrete convolutions of the binned points with the sampled kernel, computed by FFT,
+        and the resulting estimate is interpolated from the grid. The error of the approximation
+        is negligible, unless the bandwidth is comparable to the spacing of the grid or the kernel
+        is discontinuous (e.g. the *epanechnikov4* kernel).
     """
     assert ctx.parent is not None and f"impossible happened: {ctx} has no parent"
     # update the current set of params with the selected mode of kernel regression
@@ -5,7 +5,7 @@ auxiliary methods at executing of this method.
 from __future__ import annotations
 
 # Standard Imports
-from typing import Callable, Iterator, Any, cast
+from typing import Callable, Iterator, Any, Optional, cast, TYPE_CHECKING
 import dataclasses
 
 # Third-Party Imports
@@ -16,6 +16,10 @@ import sklearn.metrics
 
 # Perun Imports
 from perun.postprocess.regression_analysis import tools
+from perun.utils.common import parallel_kit, sketch_kit
+
+if TYPE_CHECKING:
+    import numpy.typing as npt
 
 
 @dataclasses.dataclass()
@@ -31,6 +35,8 @@ _MIN_R_SQUARE: float = 0.88
 _WINDOW_WIDTH_INCREASE: float = 0.15
 # starting window width as the part of the length from the whole current interval
 _INTERVAL_LENGTH: float = 0.05
+# part of the bins of the sketch, into which the streaming moving average is summarized
+_STREAMING_BUCKETS_RATIO: int = 4
 
 
 def get_supported_decay_params() -> list[str]:
@@ -66,7 +72,7 @@ def compute_window_width_change(window_width: int, r_square: float) -> int:
 
 
 def compute_moving_average(
-    data_gen: Iterator[tuple[list[float], list[float], str]],
+    data_gen: Iterator[tuple[Any, Any, str]],
     configuration: dict[str, Any],
 ) -> list[dict[str, Any]]:
     """
@@ -81,15 +87,33 @@ def compute_moving_average(
         configuration, _METHOD_REQUIRED_KEYS[configuration["moving_method"]], []
     )
 
-    # list of resulting models of the analysis
-    moving_average_models = []
-    for x_pts, y_pts, uid in data_gen:
+    # list of resulting models of the analysis, possibly computed in parallel for each chunk
+    return parallel_kit.map_chunks(
+        compute_chunk, data_gen, configuration, as_lists=not configuration.get("streaming")
+    )
+
+
+def compute_chunk(
+    x_pts: Any, y_pts: Any, uid: str, configuration: dict[str, Any]
+) -> dict[str, Any]:
+    """
+    Computes the moving average model for one chunk of resources (i.e. one uid).
+
+    :param list x_pts: the list of x points coordinates (array for streaming computation)
+    :param list y_pts: the list of y points coordinates (array for streaming computation)
+    :param str uid: uid of the chunk
+    :param dict configuration: the perun and option context
+    :return dict: the output dictionary with the moving average model
+    """
+    # The computed window width must not leak into the computation of other chunks
+    configuration = dict(configuration)
+    if configuration.get("streaming"):
+        moving_average_model = streaming_moving_average(x_pts, y_pts, configuration)
+    else:
         moving_average_model = moving_average(x_pts, y_pts, configuration)
-        moving_average_model["uid"] = uid
-        moving_average_model["model"] = "moving_average"
-        # add partial result to the model result list - create output dictionaries
-        moving_average_models.append(moving_average_model)
-    return moving_average_models
+    moving_average_model["uid"] = uid
+    moving_average_model["model"] = "moving_average"
+    return moving_average_model
 
 
 def execute_computation(y_pts: list[float], config: dict[str, Any]) -> tuple[Any, float]:
@@ -186,9 +210,147 @@ def moving_average(
     }
 
 
+def streaming_moving_average(
+    x_pts: npt.NDArray[Any], y_pts: npt.NDArray[Any], configuration: dict[str, Any]
+) -> dict[str, Any]:
+    """
+    Compute the moving average of a set of data in one pass (per window width) and bounded memory.
+
+    The points are processed in batches ordered by the x coordinates and the moving statistics are
+    computed incrementally (see :class:`perun.utils.common.sketch_kit.WindowedStatistics`) with
+    the same semantics as in :func:`execute_computation`. The coefficient of determination is
+    exact, while the computed statistics are summarized into the histogram sketch, from which the
+    means of statistics in buckets of equal width are stored (as in regressogram). The edges of
+    buckets are displaced by at most the width of bins of the sketch.
+
+    :param np.ndarray x_pts: the array of x points coordinates
+    :param np.ndarray y_pts: the array of y points coordinates
+    :param dict configuration: the perun and option context with needed parameters
+    :return dict: the output dictionary with result of analysis
+    """
+    resolution = configuration.get("sketch_resolution") or sketch_kit.DEFAULT_RESOLUTION
+    order = _sorting_order(x_pts, y_pts)
+    x_start, x_end = np.min(x_pts).item(), np.max(x_pts).item()
+
+    def computation(_: Any, config: dict[str, Any]) -> tuple[Any, float]:
+        """Computes the sketch of moving statistics with the current configuration"""
+        return _stream_moving_statistics(x_pts, y_pts, order, config, resolution)
+
+    # If has been specified the window width by user, then will be followed the direct computation
+    if configuration.get("window_width"):
+        sketch, r_square = computation(y_pts, configuration)
+    # If we did not specify the window width, then will be followed the iterative computation
+    else:
+        sketch, r_square, configuration["window_width"] = iterative_analysis(
+            [x_start, x_end], y_pts, configuration, computation
+        )
+
+    bucket_number = max(min(resolution // _STREAMING_BUCKETS_RATIO, len(x_pts)), 1)
+    _, _, bucket_sums = sketch.aggregate(bucket_number, x_start, x_end)
+    with np.errstate(all="ignore"):
+        bucket_stats = bucket_sums["sums"] / bucket_sums["counts"]
+    return {
+        "moving_method": configuration["moving_method"],
+        "window_width": configuration["window_width"],
+        "x_start": x_start,
+        "x_end": x_end,
+        "y_start": float(bucket_stats[0]),
+        "r_square": r_square,
+        "bucket_stats": bucket_stats.tolist(),
+        "per_key": configuration["per_key"],
+        "sketch": {"resolution": sketch.resolution, "bin_width": sketch.width},
+    }
+
+
+def _sorting_order(x_pts: npt.NDArray[Any], y_pts: npt.NDArray[Any]) -> Optional[npt.NDArray[Any]]:
+    """Computes the order of points sorted by x (and y) coordinates
+
+    :param np.ndarray x_pts: the array of x points coordinates
+    :param np.ndarray y_pts: the array of y points coordinates
+    :return: the indices of sorted points, or None if the points are already sorted
+    """
+    for start in range(0, len(x_pts), sketch_kit.BATCH_SIZE):
+        # The batches overlap by one point to check the order between them as well
+        x_batch = x_pts[start : start + sketch_kit.BATCH_SIZE + 1]
+        y_batch = y_pts[start : start + sketch_kit.BATCH_SIZE + 1]
+        x_equal = x_batch[1:] == x_batch[:-1]
+        if np.any(x_batch[1:] < x_batch[:-1]) or np.any(x_equal & (y_batch[1:] < y_batch[:-1])):
+            return np.lexsort((y_pts, x_pts))
+    return None
+
+
+def _stream_moving_statistics(
+    x_pts: npt.NDArray[Any],
+    y_pts: npt.NDArray[Any],
+    order: Optional[npt.NDArray[Any]],
+    config: dict[str, Any],
+    resolution: int,
+) -> tuple[sketch_kit.HistogramSketch, float]:
+    """Computes the moving statistics of points in batches and summarizes them into the sketch
+
+    :param np.ndarray x_pts: the array of x points coordinates
+    :param np.ndarray y_pts: the array of y points coordinates
+    :param np.ndarray order: the indices of sorted points, or None if the points are sorted
+    :param dict config: the dict contains the needed parameters to compute the individual methods
+    :param int resolution: the number of bins of the sketch
+    :return: the sketch of the moving statistics and the coefficient of determination
+    """
+    if config["moving_method"] == "ema":
+        statistics = sketch_kit.WindowedStatistics(
+            "ema",
+            config["window_width"],
+            config["min_periods"] or config["window_width"],
+            alpha=sketch_kit.ewm_alpha(config["decay"], config["window_width"]),
+        )
+    else:
+        statistics = sketch_kit.WindowedStatistics(
+            config["moving_method"],
+            config["window_width"],
+            config["min_periods"],
+            config["center"],
+            config.get("window_type") if config["moving_method"] == "sma" else None,
+        )
+    sketch = sketch_kit.HistogramSketch(resolution)
+    y_moments = sketch_kit.MomentSketch()
+    residual_sum = 0.0
+    # points, whose statistics were not computed yet (because of centered windows)
+    pending_x, pending_y = np.array([]), np.array([])
+
+    def add_statistics(batch_statistics: npt.NDArray[np.float64]) -> None:
+        """Adds the statistics of the first pending points to the sketch and the residuals"""
+        nonlocal pending_x, pending_y, residual_sum
+        count = len(batch_statistics)
+        x_batch, y_batch = pending_x[:count], pending_y[:count]
+        pending_x, pending_y = pending_x[count:], pending_y[count:]
+        y_moments.update(y_batch)
+        residual_sum += float(np.sum((y_batch - np.nan_to_num(batch_statistics)) ** 2))
+        defined = ~np.isnan(batch_statistics)
+        sketch.update(x_batch[defined], batch_statistics[defined])
+
+    for start in range(0, len(x_pts), sketch_kit.BATCH_SIZE):
+        indices: Any = slice(start, start + sketch_kit.BATCH_SIZE)
+        if order is not None:
+            indices = order[indices]
+        y_batch = np.asarray(y_pts[indices], dtype=np.float64)
+        pending_x = np.concatenate([pending_x, x_pts[indices]])
+        pending_y = np.concatenate([pending_y, y_batch])
+        add_statistics(statistics.update(y_batch))
+    add_statistics(statistics.finish())
+
+    # the coefficient of determination is computed in the same way as by sklearn
+    if y_moments.m2 > 0.0:
+        r_square = 1.0 - residual_sum / y_moments.m2
+    else:
+        r_square = 1.0 if residual_sum == 0.0 else 0.0
+    return sketch, r_square
+
+
 def iterative_analysis(
-    x_pts: list[float], y_pts: list[float], config: dict[str, Any]
-) -> tuple[pd.Series[Any], float, int]:
+    x_pts: list[float],
+    y_pts: Any,
+    config: dict[str, Any],
+    computation: Callable[[Any, dict[str, Any]], tuple[Any, float]] = execute_computation,
+) -> tuple[Any, float, int]:
     """
     Compute the iterative analysis of a set of data by moving average methods.
 
@@ -203,7 +365,9 @@ def iterative_analysis(
     :param list x_pts: the list of x points coordinates
     :param list y_pts: the list of y points coordinates
     :param dict config: the perun and option context with needed parameters
-    :return tuple: pandas.Series with the computed result -
+    :param function computation: the computation of the moving average and its coefficient of
+        determination (by default :func:`execute_computation`)
+    :return tuple: pandas.Series with the computed result (or result of the computation) -
         coefficient of determination float value - window width (int)
     """
     # set the initial value of window width by a few percents of the length of the interval
@@ -211,10 +375,10 @@ def iterative_analysis(
     config["window_width"] = max(1, int(_INTERVAL_LENGTH * (max(x_pts) - min(x_pts))))
     r_square, window_new_change = 0.0, 1
     # executing the iterative analysis until the value of R^2 will not reach the required level
-    bucket_stats: pd.Series[Any] = pd.Series()
+    bucket_stats: Any = pd.Series()
     while r_square < _MIN_R_SQUARE and window_new_change:
         # obtaining new results from moving average analysis
-        bucket_stats, r_square = execute_computation(y_pts, config)
+        bucket_stats, r_square = computation(y_pts, config)
         # check whether the window width is still changing
         new_window_width = compute_window_width_change(config["window_width"], r_square)
         window_new_change = config["window_width"] - new_window_width
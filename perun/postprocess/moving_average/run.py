@@ -55,7 +55,7 @@ def postprocess(
     """
     # Perform the non-parametric analysis using the moving average methods
     moving_average_models = methods.compute_moving_average(
-        data_provider.generic_profile_provider(profile, **configuration), configuration
+        data_provider.columnar_profile_provider(profile, **configuration), configuration
     )
 
     # Return the profile after the execution of moving average method
@@ -243,6 +243,7 @@ def exponential_moving_average(ctx: click.Context, **kwargs: Any) -> None:
     ),
 )
 @cli_kit.resources_key_options
+@cli_kit.streaming_options
 @click.pass_context
 def moving_average(ctx: click.Context, **_: Any) -> None:
     """
@@ -271,6 +272,10 @@ def moving_average(ctx: click.Context, **_: Any) -> None:
         basic and commonly used `<moving-methods>` are the **simple** moving average (**sma**) and
         the *exponential* moving average (**ema**).
 
+    For huge profiles, the moving average can be computed incrementally in one pass (per each
+    tried window width) and in bounded memory (`--streaming`). The :math:`R^2` is exact, while
+    the computed averages are summarized into buckets of equal width (similarly to regressogram).
+
     For more details about this approach of non-parametric analysis refer
     to :ref:`postprocessors-moving-average`.
     """
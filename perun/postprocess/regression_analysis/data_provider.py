@@ -4,13 +4,18 @@ from __future__ import annotations
 # Standard Imports
 from operator import itemgetter
 from typing import Iterator, Any, TYPE_CHECKING
+import array
+import collections
 
 # Third-Party Imports
+import numpy as np
 
 # Perun Imports
 from perun.profile import convert
 
 if TYPE_CHECKING:
+    import numpy.typing as npt
+
     from perun.profile.factory import Profile
 
 
@@ -59,3 +64,66 @@ def generic_profile_provider(
     # End of resources, yield the current lists
     if x_points_list:
         yield x_points_list, y_points_list, function_name
+
+
+def _column_of(
+    columns: dict[str, Any], persistent_properties: dict[str, Any], key: str
+) -> npt.NDArray[Any]:
+    """Returns the values of the key for all resources of one resource type as an array
+
+    Compact columns are returned as views of the profile storage without any copying, persistent
+    values are repeated for each of the resources.
+
+    :param dict columns: collectable columns of the resource type
+    :param dict persistent_properties: persistent properties of the resource type
+    :param str key: key of the requested values
+    :return: array of values
+    :raises KeyError: if the resources have no such key
+    """
+    if key in columns:
+        column = columns[key]
+        if isinstance(column, array.array):
+            return np.frombuffer(column, dtype=column.typecode) if column else np.array([])
+        return np.asarray(column)
+    number_of_resources = len(next(iter(columns.values()))) if columns else 1
+    return np.full(number_of_resources, convert.flatten(persistent_properties[key]))
+
+
+def columnar_profile_provider(
+    profile: Profile, of_key: str, per_key: str, **_: Any
+) -> Iterator[tuple[npt.NDArray[Any], npt.NDArray[Any], str]]:
+    """Data provider, that reads the points directly from the columns of the profile.
+
+    Unlike :func:`generic_profile_provider`, the resources are never flattened into dictionaries.
+    Only the two requested columns of each resource type are grouped by uid in one pass and the
+    points are yielded as arrays (views of the profile storage, if the uid has one resource type).
+    The uids are yielded in the same order and with the same points as by the generic provider.
+
+    :param Profile profile: the profile with resources
+    :param str of_key: key for which we are finding the model
+    :param str per_key: key of the independent variable
+    :param dict _: rest of the key arguments
+    :returns generator: each subsequent call returns tuple: x points array, y points array,
+        function name
+    """
+    columns_of_uids: dict[
+        Any, list[tuple[npt.NDArray[Any], npt.NDArray[Any]]]
+    ] = collections.defaultdict(list)
+    for resource_type, columns in profile["resources"].items():
+        persistent_properties = profile["resource_type_map"][resource_type]
+        columns_of_uids[convert.flatten(persistent_properties["uid"])].append(
+            (
+                _column_of(columns, persistent_properties, per_key),
+                _column_of(columns, persistent_properties, of_key),
+            )
+        )
+
+    for uid in sorted(columns_of_uids.keys()):
+        uid_columns = columns_of_uids.pop(uid)
+        if len(uid_columns) == 1:
+            x_points, y_points = uid_columns[0]
+        else:
+            x_points = np.concatenate([x_column for (x_column, _) in uid_columns])
+            y_points = np.concatenate([y_column for (_, y_column) in uid_columns])
+        if len(x_points):
+            yield x_points, y_points, uid
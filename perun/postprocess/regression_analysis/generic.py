@@ -15,15 +15,26 @@ the given argument and return value conventions.
 from __future__ import annotations
 
 # Standard Imports
-from typing import Any, Iterable, Callable
+from typing import Any, Iterable, Callable, Optional, TYPE_CHECKING
 import math
 
 # Third-Party Imports
+import numpy as np
 
 # Perun Imports
 from perun.postprocess.regression_analysis import tools
 from perun.utils.common import common_kit
 
+if TYPE_CHECKING:
+    import numpy.typing as npt
+
+
+# Vectorized counterparts of the point modification functions used by the models
+VECTORIZED_FUNCTIONS: dict[Callable[[float], float], Callable[..., Any]] = {
+    math.log: np.log,
+    math.log10: np.log10,
+}
+
 
 def generic_compute_regression(
     data_gen: Iterable[dict[str, Any]],
@@ -56,12 +67,125 @@ def generic_compute_regression(
         yield data
 
 
+def vectorize_modification(
+    f_m: Callable[[float], float]
+) -> Callable[[npt.NDArray[np.float64]], npt.NDArray[np.float64]]:
+    """Transforms the point modification function (e.g. log10) to function over whole arrays.
+
+    Points outside the domain of the function are transformed to NaN instead of raising errors.
+
+    :param function f_m: function object for modification of x or y values
+    :returns function: function that modifies whole array of points
+    """
+    if f_m in VECTORIZED_FUNCTIONS:
+        return VECTORIZED_FUNCTIONS[f_m]
+
+    def safe_modification(point: float) -> float:
+        """Modifies the single point, while transforming domain errors to NaN"""
+        try:
+            return f_m(point)
+        except (ValueError, OverflowError):
+            return math.nan
+
+    def vectorized_modification(points: npt.NDArray[np.float64]) -> npt.NDArray[np.float64]:
+        """Modifies all points at once, if the function supports arrays, or point by point"""
+        try:
+            modified = np.asarray(f_m(points), dtype=np.float64)  # type: ignore
+            if modified.shape == points.shape:
+                return modified
+        except (TypeError, ValueError):
+            pass
+        return np.fromiter(map(safe_modification, points), dtype=np.float64, count=len(points))
+
+    return vectorized_modification
+
+
+def generic_regression_sums(
+    x_pts: list[float] | npt.NDArray[np.float64],
+    y_pts: list[float] | npt.NDArray[np.float64],
+    modifications: list[tuple[Callable[[float], float], Callable[[float], float]]],
+    steps: int,
+) -> list[list[dict[str, float]]]:
+    """Computes the intermediate sums of all models in one pass over the points.
+
+    The points are converted to contiguous arrays and each of the distinct modification functions
+    is applied only once on the whole array. Points, for which some modification is not defined
+    (e.g. log10 of negative values) are masked out of the sums of the model.
+
+    The results correspond to the data dictionaries produced by :func:`generic_regression_data`.
+
+    :param list x_pts: the list of x data points
+    :param list y_pts: the list of y data points
+    :param list modifications: list of pairs of 'f_x' and 'f_y' functions for each of the models
+    :param int steps: splits the data generation into specified steps
+    :raises InvalidSequenceSplitException: if the result of split produces too few points
+    :returns list: list of data dictionaries for each computation step, for each of the models
+    """
+    x_arr = np.asarray(x_pts, dtype=np.float64)
+    y_arr = np.asarray(y_pts, dtype=np.float64)
+    part_starts = [part_start for part_start, _ in tools.split_sequence(len(x_arr), steps)]
+
+    modified_x: dict[Callable[[float], float], npt.NDArray[np.float64]] = {}
+    modified_y: dict[Callable[[float], float], npt.NDArray[np.float64]] = {}
+    results = []
+    with np.errstate(all="ignore"):
+        for f_x, f_y in modifications:
+            if f_x not in modified_x:
+                modified_x[f_x] = vectorize_modification(f_x)(x_arr)
+            if f_y not in modified_y:
+                modified_y[f_y] = vectorize_modification(f_y)(y_arr)
+            valid = np.isfinite(modified_x[f_x]) & np.isfinite(modified_y[f_y])
+            x_tmp = np.where(valid, modified_x[f_x], 0.0)
+            y_tmp = np.where(valid, modified_y[f_y], 0.0)
+
+            # Sums of each part are accumulated, so each step continues the previous ones
+            sums = np.cumsum(
+                np.add.reduceat(
+                    np.stack([x_tmp, y_tmp, x_tmp * x_tmp, y_tmp * y_tmp, x_tmp * y_tmp, valid]),
+                    part_starts,
+                    axis=1,
+                ),
+                axis=1,
+            )
+            x_mins = np.minimum.accumulate(
+                np.minimum.reduceat(np.where(valid, x_arr, x_arr[0]), part_starts)
+            )
+            x_maxs = np.maximum.accumulate(
+                np.maximum.reduceat(np.where(valid, x_arr, x_arr[0]), part_starts)
+            )
+            results.append(
+                [
+                    dict(
+                        x_sum=float(x_sum),
+                        y_sum=float(y_sum),
+                        xy_sum=float(xy_sum),
+                        x_sq_sum=float(x_square_sum),
+                        y_sq_sum=float(y_square_sum),
+                        pts_num=int(pts_num),
+                        num_sqrt=math.sqrt(pts_num),
+                        x_start=float(x_min),
+                        x_end=float(x_max),
+                    )
+                    for (
+                        x_sum,
+                        y_sum,
+                        x_square_sum,
+                        y_square_sum,
+                        xy_sum,
+                        pts_num,
+                    ), x_min, x_max in zip(sums.T, x_mins, x_maxs)
+                ]
+            )
+    return results
+
+
 def generic_regression_data(
     x_pts: list[float],
     y_pts: list[float],
     f_x: Callable[[float], float],
     f_y: Callable[[float], float],
     steps: int,
+    regression_sums: Optional[list[dict[str, float]]] = None,
     **_: Any,
 ) -> Iterable[dict[str, float]]:
     """The generic data generator.
@@ -70,11 +194,14 @@ def generic_regression_data(
     values and the number of points.
 
     'f_x' and 'f_y' refer to the x and y values modification for the sums (e.g. log10 for x values
-    => sum of log10(x) values).
+    => sum of log10(x) values). Points, for which the modification is not defined, are skipped.
 
     The 'steps' allows to split the points sequence into parts (for iterative computation),
     where each part continues the computation (the part contains results from the previous).
 
+    The sums are computed over whole arrays by :func:`generic_regression_sums`; if they were
+    already computed together with other models, they can be passed in 'regression_sums'.
+
     Yielded data dictionary contains 'x_sum', 'y_sum', 'xy_sum', 'x_sq_sum', 'y_sq_sum', 'pts_num',
     'num_sqrt', 'x_start' and 'x_end' keys.
 
@@ -85,53 +212,17 @@ def generic_regression_data(
     :param function f_y: function object for modification of y values (e.g. log10, **2, etc.) as
         specified by the model formula
     :param int steps: splits the data generation into specified steps
+    :param list regression_sums: already computed data dictionaries for each step
     :raises GenericRegressionExceptionBase: the derived exceptions
     :raises TypeError: if the required function arguments are not in the unpacked dictionary input
     :returns iterable: generator object which produces intermediate results for each computation
         step in a data dictionary
     """
-    # We also need the min and max values
-    x_min = x_pts[0]
-    x_max = x_pts[0]
-
-    # Compute the sums of x, y, x^2, y^2 and x*y
-    x_sum, y_sum, x_square_sum, y_square_sum, xy_sum = 0.0, 0.0, 0.0, 0.0, 0.0
-    # Split the computation into specified steps
-    for part_start, part_end in tools.split_sequence(len(x_pts), steps):
-        skipped = 0
-        for x_pt, y_pt in zip(x_pts[part_start:part_end], y_pts[part_start:part_end]):
-            # Account for possible domain errors with f_x and f_y functions, simply skip the point
-            try:
-                x_tmp = f_x(x_pt)
-                y_tmp = f_y(y_pt)
-            except ValueError:
-                skipped += 1
-                continue
-
-            # Compute the intermediate results
-            x_sum += x_tmp
-            y_sum += y_tmp
-            x_square_sum += x_tmp**2
-            y_square_sum += y_tmp**2
-            xy_sum += x_tmp * y_tmp
-
-            # Check the min and max
-            x_min, x_max = min(x_min, x_pt), max(x_max, x_pt)
-
-        # Computation step is complete, save the data
-        pts_num = part_end - skipped
-        data = dict(
-            x_sum=x_sum,
-            y_sum=y_sum,
-            xy_sum=xy_sum,
-            x_sq_sum=x_square_sum,
-            y_sq_sum=y_square_sum,
-            pts_num=pts_num,
-            num_sqrt=math.sqrt(pts_num),
-            x_start=x_min,
-            x_end=x_max,
-        )
-        yield data
+    if regression_sums is None:
+        regression_sums = generic_regression_sums(x_pts, y_pts, [(f_x, f_y)], steps)[0]
+    for data in regression_sums:
+        # Each step gets its own copy, since the computation updates it with the results
+        yield dict(data)
 
 
 def generic_regression_coefficients(
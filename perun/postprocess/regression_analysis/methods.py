@@ -12,9 +12,21 @@ import collections
 # Third-Party Imports
 
 # Perun Imports
-from perun.postprocess.regression_analysis import regression_models, tools
+from perun.postprocess.regression_analysis import generic, regression_models, tools
 from perun.utils import exceptions
 from perun.utils import log
+from perun.utils.common import parallel_kit
+
+
+# Keys of the data dictionaries used only during the computation of the models
+_COMPUTATION_ONLY_KEYS = (
+    "x_pts",
+    "y_pts",
+    "data_gen",
+    "func_list",
+    "regression_sums",
+    "transformations",
+)
 
 
 class ComputationMethod(Protocol):
@@ -31,7 +43,7 @@ def get_supported_param_methods() -> list[str]:
 
 
 def compute(
-    data_gen: Iterator[tuple[list[float], list[float], str]],
+    data_gen: Iterator[tuple[Any, Any, str]],
     method: str,
     models: tuple[str],
     **kwargs: Any,
@@ -50,18 +62,14 @@ def compute(
     """
     # Split the models into derived and standard ones
     derived, models = regression_models.filter_derived(models)
-    analysis = []
-    for chunk in data_gen:
-        try:
-            # First compute all the standard models
-            for result in _METHODS[method](chunk[0], chunk[1], models, **kwargs):
-                result["uid"] = chunk[2]
-                result["method"] = method
-                analysis.append(result)
-        except exceptions.GenericRegressionExceptionBase as exc:
-            log.minor_info(
-                f"unable to perform regression analysis on function '{chunk[2]} due to: {exc}",
-            )
+    # First compute all the standard models, possibly in parallel for each of the chunks
+    analysis = [
+        result
+        for chunk_results in parallel_kit.map_chunks(
+            compute_chunk, data_gen, method, models, kwargs
+        )
+        for result in chunk_results
+    ]
     # Compute the derived models
     for der in compute_derived(derived, analysis, **kwargs):
         analysis.append(der)
@@ -69,6 +77,43 @@ def compute(
     return list(map(_transform_to_output_data, analysis))
 
 
+def compute_chunk(
+    x_pts: list[float],
+    y_pts: list[float],
+    uid: str,
+    method: str,
+    models: tuple[str],
+    kwargs: dict[str, Any],
+) -> list[dict[str, Any]]:
+    """Computes the standard regression models for one chunk of data (i.e. one uid).
+
+    :param list x_pts: the list of x points coordinates
+    :param list y_pts: the list of y points coordinates
+    :param str uid: uid of the chunk
+    :param str method: the _METHODS key value indicating requested computation method
+    :param tuple of str models: tuple of requested standard regression models to compute
+    :param dict kwargs: various additional configuration arguments for specific models
+    :returns list of dict: the computation results
+    """
+    results = []
+    try:
+        for result in _METHODS[method](x_pts, y_pts, models, **kwargs):
+            # Drop the computation details, so the results are small and can be sent by workers
+            result = {
+                key: value
+                for (key, value) in result.items()
+                if key not in _COMPUTATION_ONLY_KEYS and not callable(value)
+            }
+            result["uid"] = uid
+            result["method"] = method
+            results.append(result)
+    except exceptions.GenericRegressionExceptionBase as exc:
+        log.minor_info(
+            f"unable to perform regression analysis on function '{uid} due to: {exc}",
+        )
+    return results
+
+
 def compute_derived(
     derived_models: tuple[str], analysis: list[dict[str, Any]], **kwargs: Any
 ) -> Iterator[dict[str, Any]]:
@@ -102,12 +147,8 @@ def full_computation(
     :returns iterable: the generator object which produces computed models one by one as a
         transformed output data dictionary
     """
-    # Get all the models properties
-    for model in regression_models.map_keys_to_models(computation_models):
-        # Update the properties accordingly
-        model["steps"] = 1
-        model = _build_uniform_regression_data_format(x_pts, y_pts, model)
-        # Compute each model
+    # Get all the models properties and compute each model
+    for model in _prepare_models(x_pts, y_pts, computation_models, 1):
         for result in model["computation"](**model):
             yield result
 
@@ -406,16 +447,48 @@ def _models_initial_step(
     model_generators = []
     results = []
     # Get all the models properties
-    for model in regression_models.map_keys_to_models(computation_models):
-        # Transform the properties
-        model["steps"] = steps
-        data = _build_uniform_regression_data_format(x_pts, y_pts, model)
+    for data in _prepare_models(x_pts, y_pts, computation_models, steps):
         # Do a single computational step for each model
-        model_generators.append(model["computation"](**data))
+        model_generators.append(data["computation"](**data))
         results.append(next(model_generators[-1]))
     return model_generators, results
 
 
+def _prepare_models(
+    x_pts: list[float], y_pts: list[float], computation_models: tuple[str], steps: int
+) -> list[dict[str, Any]]:
+    """Prepares the uniform data dictionaries of all models for the computation.
+
+    The intermediate sums of all models that use the generic data generator are computed at
+    once, in a single pass over the points.
+
+    :param list x_pts: the list of x points coordinates
+    :param list y_pts: the list of y points coordinates
+    :param tuple of str computation_models: the collection of regression models to compute
+    :param int steps: number of steps to slit the computation into
+    :raises InvalidPointsException: if the points count is too low or their coordinates list have
+        different lengths
+    :raises DictionaryKeysValidationFailed: in case the data format dictionary is incorrect
+    :returns list of dict: the uniform data dictionaries of the models
+    """
+    models = list(regression_models.map_keys_to_models(computation_models))
+    tools.check_points(len(x_pts), len(y_pts), tools.MIN_POINTS_COUNT)
+    generic_models = [
+        model for model in models if model.get("data_gen") == generic.generic_regression_data
+    ]
+    regression_sums = generic.generic_regression_sums(
+        x_pts, y_pts, [(model["f_x"], model["f_y"]) for model in generic_models], steps
+    )
+    for model, model_sums in zip(generic_models, regression_sums):
+        model["regression_sums"] = model_sums
+
+    for model in models:
+        # Update the properties accordingly
+        model["steps"] = steps
+        _build_uniform_regression_data_format(x_pts, y_pts, model)
+    return models
+
+
 def _find_best_fitting_model(model_results: list[dict[str, Any]]) -> int:
     """Finds the model which is currently the best fitting one.
 
@@ -32,7 +32,7 @@ def postprocess(
 
     # Perform the regression analysis
     analysis = methods.compute(
-        data_provider.generic_profile_provider(profile, **configuration),
+        data_provider.columnar_profile_provider(profile, **configuration),
         configuration["method"],
         configuration["regression_models"],
         steps=configuration["steps"],
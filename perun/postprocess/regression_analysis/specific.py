@@ -10,6 +10,7 @@ from __future__ import annotations
 from typing import Any, Iterable
 
 # Third-Party Imports
+import numpy as np
 
 # Perun Imports
 from perun.postprocess.regression_analysis import tools
@@ -38,32 +39,41 @@ def specific_quad_data(
     :returns iterable: generator object which produces intermediate results for each computation
         step in a data dictionary
     """
-    # We also need the min and max values
-    x_min = x_pts[0]
-    x_max = x_pts[0]
-
-    # Compute the sums of x, y, y^2, x^2, x^3, x^4, x * y and x^2 * y
-    x_sum, y_sum, x_square_sum, x_cube_sum = 0.0, 0.0, 0.0, 0.0
-    x4_sum, xy_sum, x_square_y_sum, y_square_sum = 0.0, 0.0, 0.0, 0.0
-    # Split the computation into specified steps
-    for part_start, part_end in tools.split_sequence(len(x_pts), steps):
-        skipped = 0
-        for x_pt, y_pt in zip(x_pts[part_start:part_end], y_pts[part_start:part_end]):
-            # Compute the intermediate results
-            x_sum += x_pt
-            y_sum += y_pt
-            y_square_sum += y_pt**2
-            x_square_sum += x_pt**2
-            x_cube_sum += x_pt**3
-            x4_sum += x_pt**4
-            xy_sum += x_pt * y_pt
-            x_square_y_sum += (x_pt**2) * y_pt
-
-            # Check the min and max
-            x_min, x_max = min(x_min, x_pt), max(x_max, x_pt)
-
+    x_arr = np.asarray(x_pts, dtype=np.float64)
+    y_arr = np.asarray(y_pts, dtype=np.float64)
+    parts = list(tools.split_sequence(len(x_arr), steps))
+    part_starts = [part_start for part_start, _ in parts]
+
+    # Compute the sums of x, y, y^2, x^2, x^3, x^4, x * y and x^2 * y over the whole arrays, the
+    # sums of each part are accumulated, so each step continues the previous ones
+    x_square = x_arr * x_arr
+    sums = np.cumsum(
+        np.add.reduceat(
+            np.stack(
+                [
+                    x_arr,
+                    y_arr,
+                    y_arr * y_arr,
+                    x_square,
+                    x_square * x_arr,
+                    x_square * x_square,
+                    x_arr * y_arr,
+                    x_square * y_arr,
+                ]
+            ),
+            part_starts,
+            axis=1,
+        ),
+        axis=1,
+    )
+    x_mins = np.minimum.accumulate(np.minimum.reduceat(x_arr, part_starts))
+    x_maxs = np.maximum.accumulate(np.maximum.reduceat(x_arr, part_starts))
+
+    for step, (_part_start, pts_num) in enumerate(parts):
+        x_sum, y_sum, y_square_sum, x_square_sum, x_cube_sum, x4_sum, xy_sum, x_square_y_sum = (
+            float(step_sum) for step_sum in sums[:, step]
+        )
         # Computation step is complete, save the data
-        pts_num = part_end - skipped
         data = {
             "x_sum": x_sum,
             "y_sum": y_sum,
@@ -74,8 +84,8 @@ def specific_quad_data(
             "x4_sum": x4_sum,
             "x_sq_y_sum": x_square_y_sum,
             "pts_num": pts_num,
-            "x_start": x_min,
-            "x_end": x_max,
+            "x_start": float(x_mins[step]),
+            "x_end": float(x_maxs[step]),
         }
         yield data
 
@@ -4,8 +4,9 @@ Module with regressogram computational method and auxiliary methods at executing
 from __future__ import annotations
 
 # Standard Imports
-from typing import Iterator, Any
+from typing import Callable, Iterator, Any, TYPE_CHECKING
 import inspect
+import math
 
 # Third-Party Imports
 import numpy as np
@@ -15,6 +16,11 @@ import sklearn.metrics
 
 # Perun Imports
 from perun.postprocess.regression_analysis import tools
+from perun.utils import log
+from perun.utils.common import parallel_kit, sketch_kit
+
+if TYPE_CHECKING:
+    import numpy.typing as npt
 
 # required arguments at regressogram post-processor
 _REQUIRED_KEYS = ["bucket_method", "statistic_function"]
@@ -39,7 +45,7 @@ def get_supported_selectors() -> list[str]:
 
 
 def compute_regressogram(
-    data_gen: Iterator[tuple[list[float], list[float], str]], config: dict[str, Any]
+    data_gen: Iterator[tuple[Any, Any, str]], config: dict[str, Any]
 ) -> list[dict[str, Any]]:
     """
     The regressogram wrapper to execute the analysis on the individual chunks of resources.
@@ -51,25 +57,43 @@ def compute_regressogram(
     # checking the presence of specific keys in individual methods
     tools.validate_dictionary_keys(config, _REQUIRED_KEYS, [])
 
-    # list of result of the analysis
-    analysis = []
-    for x_pts, y_pts, uid in data_gen:
-        # Check whether the user gives as own number of buckets or select the method to its estimate
-        buckets = (
-            config["bucket_number"] if config.get("bucket_number") else config["bucket_method"]
+    # list of result of the analysis, possibly computed in parallel for each of the chunks
+    return parallel_kit.map_chunks(
+        compute_chunk, data_gen, config, as_lists=not config.get("streaming")
+    )
+
+
+def compute_chunk(x_pts: Any, y_pts: Any, uid: str, config: dict[str, Any]) -> dict[str, Any]:
+    """
+    Computes the regressogram for one chunk of resources (i.e. one uid).
+
+    :param list x_pts: the list of x points coordinates (array for streaming computation)
+    :param list y_pts: the list of y points coordinates (array for streaming computation)
+    :param str uid: uid of the chunk
+    :param dict config: the perun and option context
+    :return dict: the output dictionary with result of analysis
+    """
+    # Check whether the user gives as own number of buckets or select the method to its estimate
+    buckets = config["bucket_number"] if config.get("bucket_number") else config["bucket_method"]
+    if config.get("streaming"):
+        result = streaming_regressogram(
+            x_pts,
+            y_pts,
+            config["statistic_function"],
+            buckets,
+            config.get("sketch_resolution") or sketch_kit.DEFAULT_RESOLUTION,
         )
+    else:
         result = regressogram(x_pts, y_pts, config["statistic_function"], buckets)
-        result.update(
-            {
-                "uid": uid,
-                "model": "regressogram",
-                "per_key": config["per_key"],
-                "of_key": config["of_key"],
-            }
-        )
-        # add partial result to the result list - create output dictionaries
-        analysis.append(result)
-    return analysis
+    result.update(
+        {
+            "uid": uid,
+            "model": "regressogram",
+            "per_key": config["per_key"],
+            "of_key": config["of_key"],
+        }
+    )
+    return result
 
 
 def regressogram(
@@ -128,6 +152,152 @@ def regressogram(
     }
 
 
+def streaming_regressogram(
+    x_pts: npt.NDArray[Any],
+    y_pts: npt.NDArray[Any],
+    statistic_function: str,
+    buckets: str | int,
+    resolution: int = sketch_kit.DEFAULT_RESOLUTION,
+) -> dict[str, Any]:
+    """
+    Compute the approximate regressogram of a set of data in one pass and bounded memory.
+
+    The points are summarized into the mergeable histogram sketch (see
+    :class:`perun.utils.common.sketch_kit.HistogramSketch`), from which the regressogram is
+    computed by :func:`regressogram_of_sketch`.
+
+    :param np.ndarray x_pts: the array of x points coordinates
+    :param np.ndarray y_pts: the array of y points coordinates
+    :param str statistic_function: the statistic_function to compute
+    :param str/int buckets: the number of buckets to calculate or the name of computational method
+    :param int resolution: the number of bins of the sketch
+    :return dict: the output dictionary with result of analysis
+    """
+    sketch = sketch_kit.HistogramSketch(resolution)
+    for start in range(0, len(x_pts), sketch_kit.BATCH_SIZE):
+        end = start + sketch_kit.BATCH_SIZE
+        sketch.update(x_pts[start:end], y_pts[start:end])
+    return regressogram_of_sketch(sketch, statistic_function, buckets)
+
+
+def regressogram_of_sketch(
+    sketch: sketch_kit.HistogramSketch, statistic_function: str, buckets: str | int
+) -> dict[str, Any]:
+    """
+    Compute the regressogram of the data summarized in the histogram sketch.
+
+    The bins of the sketch are assigned to the buckets of the regressogram, hence the edges of
+    buckets are displaced by at most the width of bins (stored in the output). For the mean, the
+    values of buckets and the coefficient of determination are exact w.r.t. the displaced edges.
+    The median is approximated by the weighted median of the means of bins within the bucket.
+    The number of buckets is estimated by the same methods as in :func:`regressogram`, however,
+    from the summary of the x coordinates.
+
+    :param HistogramSketch sketch: the sketch of the data
+    :param str statistic_function: the statistic_function to compute
+    :param str/int buckets: the number of buckets to calculate or the name of computational method
+    :return dict: the output dictionary with result of analysis
+    """
+    buckets_num = buckets if isinstance(buckets, int) else _SKETCH_BUCKET_SELECTORS[buckets](sketch)
+    bucket_number = max(1, int(buckets_num))
+    if bucket_number > sketch.resolution // 2:
+        log.warn(
+            f"regressogram with {bucket_number} buckets is imprecise for sketch resolution"
+            f" {sketch.resolution}"
+        )
+    bin_buckets, bucket_edges, bucket_sums = sketch.aggregate(bucket_number)
+    with np.errstate(all="ignore"):
+        if statistic_function == "median":
+            bucket_stats = _weighted_medians(sketch, bin_buckets, bucket_number)
+        else:
+            bucket_stats = bucket_sums["sums"] / bucket_sums["counts"]
+    bucket_stats = np.nan_to_num(bucket_stats)
+
+    # The residuals are computed from the sums and squares of y coordinates in buckets
+    residual_sum = max(
+        float(
+            np.sum(
+                bucket_sums["squares"]
+                - 2 * bucket_stats * bucket_sums["sums"]
+                + bucket_sums["counts"] * bucket_stats**2
+            )
+        ),
+        0.0,
+    )
+    y_sum, count = float(np.sum(sketch.y_sums)), sketch.count
+    total_sum = max(float(np.sum(sketch.y_squares)) - y_sum**2 / count, 0.0)
+    if total_sum > 0.0:
+        r_square = 1.0 - residual_sum / total_sum
+    else:
+        r_square = 1.0 if residual_sum == 0.0 else 0.0
+
+    return {
+        "buckets_method": "user" if isinstance(buckets, int) else buckets,
+        "statistic_function": statistic_function,
+        "bucket_stats": bucket_stats.tolist(),
+        "x_start": float(bucket_edges[0]),
+        "x_end": float(bucket_edges[-1]),
+        "y_start": float(np.min(sketch.y_mins)),
+        "r_square": r_square,
+        "sketch": {"resolution": sketch.resolution, "bin_width": sketch.width},
+    }
+
+
+def _weighted_medians(
+    sketch: sketch_kit.HistogramSketch, bin_buckets: npt.NDArray[np.int64], bucket_number: int
+) -> npt.NDArray[np.float64]:
+    """Computes the weighted medians of means of bins for each of the buckets
+
+    :param HistogramSketch sketch: the sketch of the data
+    :param np.ndarray bin_buckets: index of bucket of each of the bins
+    :param int bucket_number: number of buckets
+    :return: medians of the buckets (NaN for empty buckets)
+    """
+    used = np.flatnonzero(sketch.counts)
+    means = sketch.y_sums[used] / sketch.counts[used]
+    order = np.lexsort((means, bin_buckets[used]))
+    used, means = used[order], means[order]
+    medians = np.full(bucket_number, np.nan)
+    bucket_starts = np.flatnonzero(np.diff(bin_buckets[used], prepend=-1))
+    for start, end in zip(bucket_starts, list(bucket_starts[1:]) + [len(used)]):
+        cumulative_counts = np.cumsum(sketch.counts[used[start:end]])
+        median_index = int(np.searchsorted(cumulative_counts, cumulative_counts[-1] / 2.0))
+        medians[bin_buckets[used[start]]] = means[start + median_index]
+    return medians
+
+
+def _sketch_doane(sketch: sketch_kit.HistogramSketch) -> float:
+    """Doane's estimator computed from the summary of x coordinates (see numpy)
+
+    :param HistogramSketch sketch: the sketch of the data
+    :return: the estimate
+    """
+    size = sketch.count
+    if size > 2 and sketch.x_moments.std() > 0.0:
+        sg1 = math.sqrt(6.0 * (size - 2) / ((size + 1.0) * (size + 3)))
+        return _sketch_ptp(sketch) / (
+            1.0 + math.log2(size) + math.log2(1.0 + abs(sketch.x_moments.skewness()) / sg1)
+        )
+    return 0.0
+
+
+def _sketch_fd(sketch: sketch_kit.HistogramSketch) -> float:
+    """Freedman Diaconis estimator computed from the approximate quartiles (see numpy)
+
+    :param HistogramSketch sketch: the sketch of the data
+    :return: the estimate
+    """
+    return 2.0 * (sketch.quantile(0.75) - sketch.quantile(0.25)) * sketch.count ** (-1.0 / 3.0)
+
+
+def _sketch_ptp(sketch: sketch_kit.HistogramSketch) -> float:
+    """
+    :param HistogramSketch sketch: the sketch of the data
+    :return: the range of x coordinates
+    """
+    return float(sketch.x_moments.maximum - sketch.x_moments.minimum)
+
+
 # Code for calculating number of buckets for regressogram can be got from SciPy:
 # https://docs.scipy.org/doc/numpy/reference/generated/numpy.histogram_bin_edges.html#numpy.histogram_bucket_edges
 
@@ -144,5 +314,18 @@ _BUCKET_SELECTORS = {
     "sturges": numpy_bucket_selectors._hist_bin_sturges,  # type: ignore
 }
 
+# the same methods computed from the summaries of x coordinates in the sketches
+_SKETCH_BUCKET_SELECTORS: dict[str, Callable[[sketch_kit.HistogramSketch], float]] = {
+    "auto": lambda sketch: min(_sketch_fd(sketch), _SKETCH_BUCKET_SELECTORS["sturges"](sketch))
+    or _SKETCH_BUCKET_SELECTORS["sturges"](sketch),
+    "doane": _sketch_doane,
+    "fd": _sketch_fd,
+    "rice": lambda sketch: _sketch_ptp(sketch) / (2.0 * sketch.count ** (1.0 / 3)),
+    "scott": lambda sketch: (24.0 * math.pi**0.5 / sketch.count) ** (1.0 / 3.0)
+    * sketch.x_moments.std(),
+    "sqrt": lambda sketch: _sketch_ptp(sketch) / math.sqrt(sketch.count),
+    "sturges": lambda sketch: _sketch_ptp(sketch) / (math.log2(sketch.count) + 1.0),
+}
+
 # supported non-parametric methods
 _METHODS = ["regressogram", "moving_average", "kernel_regression"]
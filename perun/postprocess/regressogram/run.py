@@ -33,7 +33,7 @@ def postprocess(
     """
     # Perform the non-parametric analysis using the regressogram method
     regressogram_models = methods.compute_regressogram(
-        data_provider.generic_profile_provider(profile, **configuration), configuration
+        data_provider.columnar_profile_provider(profile, **configuration), configuration
     )
 
     # Return the profile after the execution of regressogram method
@@ -78,6 +78,7 @@ def postprocess(
     ),
 )
 @cli_kit.resources_key_options
+@cli_kit.streaming_options
 @pass_profile
 def regressogram(profile: Profile, **kwargs: Any) -> None:
     """
@@ -120,6 +121,12 @@ def regressogram(profile: Profile, **kwargs: Any) -> None:
         For more details about these methods to estimate the optimal number of buckets or to view
         the code of these methods, you can visit SciPy_.
 
+    For huge profiles, the regressogram can be computed approximately in one pass and in bounded
+    memory (`--streaming`). The points are summarized into the mergeable histogram sketch with
+    `<sketch_resolution>` bins, hence the edges of buckets are displaced by at most the width of
+    one bin, while the means and :math:`R^2` are exact w.r.t. the displaced edges. Medians are
+    approximated by the medians of means of bins.
+
     For more details about this approach of non-parametric analysis refer to
     :ref:`postprocessors-regressogram`.
     """
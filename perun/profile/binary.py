@@ -0,0 +1,238 @@
+"""Binary columnar format of profiles stored in the object store
+
+The binary format avoids serializing the whole profile into one JSON document. Instead, the
+collectable values of each resource type are stored column by column in independently compressed
+blocks. Numeric columns are stored as raw little-endian arrays, the rest of columns is stored as
+JSON lists. This way the profiles are decoded much faster and only the required columns have to be
+inflated.
+
+The format is as follows (all integers are little-endian)::
+
+    magic            4B   b"pbin"
+    version          4B   unsigned int
+    header length    8B   unsigned long long
+    header           zlib compressed JSON object with the following keys:
+                       "compression": compression of column blocks, either "zlib" or "none"
+                       "extra": additional data stored by the writer (e.g. by cache)
+                       "profile": all the items of profile except of the resources
+                       "resource_type_map": dictionary of persistent properties of resource types
+                       "resource_types": list of resource types in the order of storage
+                       "columns": list of [resource type, key, kind, count, offset, length]
+    column blocks    (compressed) blocks, offsets are relative to the end of header
+
+The kind of column is either typecode of array (``q`` or ``d``) or ``j`` for JSON encoded lists.
+"""
+from __future__ import annotations
+
+# Standard Imports
+from typing import Any, BinaryIO, Iterable, Optional
+import array
+import json
+import mmap
+import struct
+import sys
+import zlib
+
+# Third-Party Imports
+
+# Perun Imports
+from perun.profile.factory import Profile, COLUMN_TYPECODES
+from perun.utils.common import common_kit
+from perun.utils.exceptions import IncorrectProfileFormatException
+
+
+BINARY_PROFILE_MAGIC_PREFIX: bytes = b"pbin"
+BINARY_PROFILE_VERSION: int = 1
+BINARY_PROFILE_PREAMBLE: struct.Struct = struct.Struct("<4sIQ")
+JSON_COLUMN_KIND: str = "j"
+
+
+def is_binary_profile(content_prefix: bytes) -> bool:
+    """Checks whether the content starts with the magic prefix of binary profiles
+
+    :param bytes content_prefix: first bytes of the checked content
+    :return: true if the content is a binary profile
+    """
+    return content_prefix[: len(BINARY_PROFILE_MAGIC_PREFIX)] == BINARY_PROFILE_MAGIC_PREFIX
+
+
+def _encode_column(column: Any) -> tuple[str, bytes]:
+    """Encodes the column of collectable values to bytes
+
+    :param column: either compact array or list of values
+    :return: pair of kind of the column and its encoded content
+    """
+    if not isinstance(column, array.array):
+        typecode = COLUMN_TYPECODES.get(type(column[0])) if column else None
+        if typecode and all(type(value) is type(column[0]) for value in column):
+            try:
+                column = array.array(typecode, column)
+            except OverflowError:
+                pass
+    if isinstance(column, array.array):
+        if sys.byteorder != "little":
+            column = array.array(column.typecode, column)
+            column.byteswap()
+        return column.typecode, column.tobytes()
+    return JSON_COLUMN_KIND, json.dumps(list(column)).encode("utf-8")
+
+
+def _decode_column(kind: str, content: bytes) -> list[Any] | array.array[Any]:
+    """Decodes the column of collectable values from bytes
+
+    :param str kind: kind of the column
+    :param bytes content: encoded content of the column
+    :return: decoded column
+    """
+    if kind == JSON_COLUMN_KIND:
+        return json.loads(content)
+    column = array.array(kind)
+    column.frombytes(content)
+    if sys.byteorder != "little":
+        column.byteswap()
+    return column
+
+
+def pack_profile(
+    profile: Profile, compress: bool = True, extra: Optional[dict[str, Any]] = None
+) -> bytes:
+    """Packs the profile into the binary columnar format
+
+    :param Profile profile: packed profile
+    :param bool compress: if set to false, then the column blocks are stored uncompressed
+    :param dict extra: additional data stored in the header
+    :return: binary representation of the profile
+    """
+    column_directory = []
+    blocks = []
+    offset = 0
+    for resource_type, columns in profile["resources"].items():
+        for key, column in columns.items():
+            kind, content = _encode_column(column)
+            block = zlib.compress(content) if compress else content
+            column_directory.append([resource_type, key, kind, len(column), offset, len(block)])
+            blocks.append(block)
+            offset += len(block)
+
+    header = {
+        "compression": "zlib" if compress else "none",
+        "extra": extra or {},
+        "profile": {
+            key: value
+            for (key, value) in profile.items()
+            if key not in ("resources", "resource_type_map")
+        },
+        "resource_type_map": profile["resource_type_map"],
+        "resource_types": list(profile["resources"].keys()),
+        "columns": column_directory,
+    }
+    packed_header = zlib.compress(json.dumps(header).encode("utf-8"))
+    preamble = BINARY_PROFILE_PREAMBLE.pack(
+        BINARY_PROFILE_MAGIC_PREFIX, BINARY_PROFILE_VERSION, len(packed_header)
+    )
+    return b"".join([preamble, packed_header] + blocks)
+
+
+class BinaryProfileReader:
+    """Reader of profiles stored in the binary columnar format
+
+    The header of the profile is read eagerly, while the columns are read lazily on demand.
+
+    :ivar str file_name: name of the file opened in the handle (used for error reporting)
+    :ivar file handle: opened binary handle (or memory map) positioned at the start of the profile
+    :ivar bool compressed: true if the column blocks are compressed
+    :ivar dict extra: additional data stored in the header
+    :ivar dict profile: items of the profile except of the resources
+    :ivar dict resource_type_map: dictionary of persistent properties of resource types
+    :ivar list resource_types: list of resource types in the order of storage
+    :ivar dict columns: map of (resource type, key) to (kind, count, offset, length) of column
+    :ivar int data_offset: offset of the first column block in the handle
+    """
+
+    def __init__(self, file_name: str, handle: BinaryIO | mmap.mmap) -> None:
+        """
+        :param str file_name: name of the file opened in the handle
+        :param file handle: opened binary handle positioned at the start of the profile
+        :raises IncorrectProfileFormatException: when the profile is malformed
+        """
+        self.file_name = file_name
+        self.handle = handle
+        start = handle.tell()
+        try:
+            magic, version, header_length = BINARY_PROFILE_PREAMBLE.unpack(
+                handle.read(BINARY_PROFILE_PREAMBLE.size)
+            )
+            if magic != BINARY_PROFILE_MAGIC_PREFIX or version > BINARY_PROFILE_VERSION:
+                raise ValueError("unsupported binary profile")
+            header = json.loads(zlib.decompress(handle.read(header_length)))
+        except (struct.error, zlib.error, ValueError):
+            raise IncorrectProfileFormatException(file_name, "malformed profile '{}'")
+
+        self.compressed: bool = header.get("compression", "zlib") == "zlib"
+        self.extra: dict[str, Any] = header.get("extra", {})
+        self.profile: dict[str, Any] = header["profile"]
+        if self.profile.get("header", {}).get("type") not in common_kit.SUPPORTED_PROFILE_TYPES:
+            raise IncorrectProfileFormatException(file_name, "malformed profile '{}'")
+        self.resource_type_map: dict[str, dict[str, Any]] = header["resource_type_map"]
+        self.resource_types: list[str] = header["resource_types"]
+        self.columns: dict[tuple[str, str], tuple[str, int, int, int]] = {
+            (resource_type, key): (kind, count, offset, length)
+            for (resource_type, key, kind, count, offset, length) in header["columns"]
+        }
+        self.data_offset = start + BINARY_PROFILE_PREAMBLE.size + header_length
+
+    def column_keys_of(self, resource_type: str) -> list[str]:
+        """
+        :param str resource_type: resource type
+        :return: list of keys of collectable columns of the resource type
+        """
+        return [key for (rtype, key) in self.columns.keys() if rtype == resource_type]
+
+    def read_column(self, resource_type: str, key: str) -> list[Any] | array.array[Any]:
+        """Reads and inflates one column of collectable values
+
+        :param str resource_type: resource type of the column
+        :param str key: key of the collectable value
+        :return: decoded column
+        :raises IncorrectProfileFormatException: when the column is malformed
+        """
+        kind, count, offset, length = self.columns[(resource_type, key)]
+        self.handle.seek(self.data_offset + offset)
+        try:
+            block = self.handle.read(length)
+            column = _decode_column(kind, zlib.decompress(block) if self.compressed else block)
+        except (zlib.error, ValueError):
+            raise IncorrectProfileFormatException(self.file_name, "malformed profile '{}'")
+        if len(column) != count:
+            raise IncorrectProfileFormatException(self.file_name, "malformed profile '{}'")
+        return column
+
+    def read_resources(
+        self, keys: Optional[Iterable[str]] = None
+    ) -> dict[str, dict[str, list[Any] | array.array[Any]]]:
+        """Reads the columns of all resource types
+
+        :param list keys: if set, then only columns with the given keys are read
+        :return: map of resource types to their columns
+        """
+        selected_keys = set(keys) if keys is not None else None
+        resources: dict[str, dict[str, list[Any] | array.array[Any]]] = {
+            resource_type: {} for resource_type in self.resource_types
+        }
+        for resource_type, key in self.columns.keys():
+            if selected_keys is None or key in selected_keys:
+                resources.setdefault(resource_type, {})[key] = self.read_column(resource_type, key)
+        return resources
+
+    def to_profile(self) -> Profile:
+        """Decodes the whole profile
+
+        :return: decoded profile
+        """
+        return Profile(
+            {
+                **self.profile,
+                "resource_type_map": self.resource_type_map,
+                "resources": self.read_resources(),
+            }
+        )
@@ -15,8 +15,9 @@ complex queries and statistical tests over the profiles.
 from __future__ import annotations
 
 # Standard Imports
-from typing import TYPE_CHECKING, Any
+from typing import TYPE_CHECKING, Any, Iterable, Optional
 import array
+import itertools
 import operator
 
 # Third-Party Imports
@@ -79,6 +80,81 @@ def resources_to_pandas_dataframe(profile: Profile) -> pandas.DataFrame:
     return pandas.DataFrame(values)
 
 
+def resources_to_aggregated_amounts(
+    profile: Profile,
+    group_by: Iterable[str] = ("uid", "trace"),
+    filters: Optional[list[tuple[str, Any]]] = None,
+    amount_key: str = "amount",
+) -> tuple[dict[tuple[Any, ...], Any], Any]:
+    """Sums the amounts of the resources in the `profile` grouped by the given keys.
+
+    This is the equivalent of grouping the :func:`resources_to_pandas_dataframe` by the keys
+    and summing the amounts, however, the resources are folded directly from the storage of
+    the profile in a single pass, without constructing the dataframe. Since the resources are
+    stored by their types (i.e. unique persistent properties, including the uid and trace), the
+    keys are usually constructed only once per type and the amounts are summed by columns,
+    hence the memory is bounded by the number of groups rather than the number of resources.
+
+    E.g. given the `memory` profile ``mprof``, one can obtain the following::
+
+        >>> convert.resources_to_aggregated_amounts(mprof)
+        ({('main:../memo...:22', 'malloc:unreachabl...'): 4, ...}, 4)
+
+    Resources missing some of the grouping keys are not assigned to any group (but their
+    amounts are still part of the total amount) and missing amounts are summed as zeros, as
+    in `pandas`_.
+
+    :param Profile profile: dictionary with profile w.r.t. :ref:`profile-spec`
+    :param iterable group_by: flattened keys of resources, by which the amounts are grouped
+    :param list filters: list of pairs of flattened keys and values, the resource is aggregated
+        only if it has at least one of the values (all resources are aggregated if empty)
+    :param str amount_key: key of the aggregated amounts
+    :returns: pair of map of values of grouping keys to sums of amounts and the total amount
+    """
+    group_by = tuple(group_by)
+    filters = filters or []
+    grouping_keys = set(group_by) | {key for (key, _) in filters}
+    keys = list(grouping_keys | {amount_key})
+    groups: dict[tuple[Any, ...], Any] = {}
+    total = 0
+
+    for persistent_properties, columns in profile.all_resource_types(True):
+        resources_count = len(next(iter(columns.values()))) if columns else 1
+        # If no grouping key is collectable, all resources of the type fall into the same group
+        if all(key in persistent_properties or key not in columns for key in grouping_keys):
+            if filters and not any(persistent_properties.get(k) == v for (k, v) in filters):
+                continue
+            if amount_key in persistent_properties:
+                amount = persistent_properties[amount_key] * resources_count
+            else:
+                amount = sum(columns.get(amount_key, ()))
+            total += amount
+            if all(key in persistent_properties for key in group_by):
+                group = tuple(persistent_properties[key] for key in group_by)
+                groups[group] = groups.get(group, 0) + amount
+            continue
+
+        # Persistent properties take precedence, as in the resources of the profile
+        values = {
+            key: (
+                itertools.repeat(persistent_properties[key], resources_count)
+                if key in persistent_properties
+                else columns.get(key, itertools.repeat(None, resources_count))
+            )
+            for key in keys
+        }
+        for row in zip(*(values[key] for key in keys)):
+            resource = dict(zip(keys, row))
+            if filters and not any(resource[k] == v for (k, v) in filters):
+                continue
+            amount = resource[amount_key] or 0
+            total += amount
+            group = tuple(resource[key] for key in group_by)
+            if None not in group:
+                groups[group] = groups.get(group, 0) + amount
+    return groups, total
+
+
 def models_to_pandas_dataframe(profile: Profile) -> pandas.DataFrame:
     """Converts the models of profile (w.r.t :ref:`profile-spec`) to format
     supported by `pandas`_ library.
@@ -104,7 +180,7 @@ def models_to_pandas_dataframe(profile: Profile) -> pandas.DataFrame:
 
 def to_flame_graph_format(profile: Profile) -> list[str]:
     """Transforms the **memory** profile w.r.t. :ref:`profile-spec` into the
-    format supported by perl script of Brendan Gregg.
+    folded format of the flame graph scripts of Brendan Gregg.
 
     .. _Brendan Gregg's homepage: https://www.brendangregg.com/index.html
 
@@ -124,7 +200,8 @@ def to_flame_graph_format(profile: Profile) -> list[str]:
 
     Each line corresponds to some collected resource (in this case amount of
     allocated memory) preceeded by its trace (i.e. functions or other unique
-    identifiers joined using ``;`` character).
+    identifiers joined using ``;`` character). Note that the flame graphs themselves are
+    rendered from the stacks folded into the prefix trie (see :mod:`perun.profile.folding`).
 
     :param Profile profile: the memory profile
     :returns: list of lines, each representing one allocation call stack
@@ -133,14 +210,9 @@ def to_flame_graph_format(profile: Profile) -> list[str]:
     for _, snapshot in profile.all_snapshots():
         for alloc in snapshot:
             if "subtype" not in alloc.keys() or alloc["subtype"] != "free":
-                stack_str = to_uid(alloc["uid"]) + ";"
-                for frame in alloc["trace"][::-1]:
-                    line = to_string_line(frame)
-                    stack_str += line + ";"
-                if stack_str and stack_str.endswith(";"):
-                    final = stack_str[:-1]
-                    final += " " + str(alloc["amount"]) + "\n"
-                    stacks.append(final)
+                frames = [to_uid(alloc["uid"])]
+                frames.extend(to_string_line(frame) for frame in reversed(alloc["trace"]))
+                stacks.append(f"{';'.join(frames)} {alloc['amount']}\n")
 
     return stacks
 
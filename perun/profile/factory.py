@@ -10,7 +10,9 @@ from __future__ import annotations
 # Standard Imports
 from collections.abc import MutableMapping
 from typing import Any, Iterator, Iterable, TYPE_CHECKING
+import array
 import collections
+import distutils.util as dutils
 import itertools
 import operator
 
@@ -28,20 +30,30 @@ import perun.postprocess.regressogram.methods as nparam_methods
 if TYPE_CHECKING:
     from perun.utils.structs import ModelRecord
 
+# Maps the exact types of collectable values to typecodes of compact array columns
+COLUMN_TYPECODES: dict[type, str] = {int: "q", float: "d"}
+
 
 class Profile(MutableMapping[str, Any]):
     """
     :ivar dict _storage: internal storage of the profile
     :ivar dict _tuple_to_resource_type_map: map of tuple of persistent records of resources to
         unique identifier of those resources
+    :ivar dict _hashable_tuple_to_resource_type_map: cache of resource types for tuples of
+        persistent records (keyed together with types of their values and with the keys of
+        collectable records), that can be hashed directly
     :ivar Counter _uid_counter: counter of how many resources type uid has
+    :ivar bool _columnar: if set to true, then collectable values of numeric types are stored in
+        typed compact arrays instead of lists
     """
 
     __slots__ = [
         "_storage",
         "_tuple_to_resource_type_map",
+        "_hashable_tuple_to_resource_type_map",
         "_resource_type_to_flattened_resources_map",
         "_uid_counter",
+        "_columnar",
     ]
 
     collectable = {
@@ -52,6 +64,11 @@ class Profile(MutableMapping[str, Any]):
         "address",
         "timestamp",
         "exclusive",
+        "max-rss",
+        "voluntary-switches",
+        "involuntary-switches",
+        "minor-faults",
+        "major-faults",
     }
     persistent = {"trace", "type", "subtype", "uid", "location"}
 
@@ -81,8 +98,13 @@ class Profile(MutableMapping[str, Any]):
             "models": global_data.get("models", []) if isinstance(global_data, dict) else [],
         }
         self._tuple_to_resource_type_map: dict[str, str] = {}
+        self._hashable_tuple_to_resource_type_map: dict[tuple[Any, ...], str] = {}
         self._resource_type_to_flattened_resources_map: dict[str, dict[str, Any]] = {}
         self._uid_counter: collections.Counter[str] = collections.Counter()
+        # The compact storage can be turned off in runtime config, e.g. for debugging purposes
+        self._columnar: bool = bool(
+            dutils.strtobool(str(config.runtime().safe_get("profiles.columnar_storage", "true")))
+        )
 
         for key, value in initialization_data.items():
             if key in ("resources", "snapshots", "global"):
@@ -126,6 +148,9 @@ class Profile(MutableMapping[str, Any]):
                 )
         elif isinstance(resource_list, (dict, Profile)):
             self._storage["resources"].update(resource_list)
+            if self._columnar and isinstance(resource_list, dict):
+                for resources in resource_list.values():
+                    _compact_columns(resources)
         else:
             self._translate_resources(resource_list, {})
 
@@ -153,33 +178,99 @@ class Profile(MutableMapping[str, Any]):
         Profile.persistent.update({key for key, val in ctx.items() if isinstance(val, str)})
         Profile.collectable.update({key for key, val in ctx.items() if not isinstance(val, str)})
 
+        # Resources usually share the same keys, hence we precompute how each key is translated
+        translation_plans: dict[
+            tuple[str, ...], tuple[list[tuple[str, bool, Any]], list[str], tuple[str, ...]]
+        ] = {}
+        storage = self._storage["resources"]
         for resource in resource_list:
-            persistent_properties = [
-                (key, value) for (key, value) in resource.items() if key not in Profile.collectable
-            ] + ctx_persistent_properties
-            persistent_properties.extend(list(additional_params.items()))
-            persistent_properties.sort(key=operator.itemgetter(0))
+            resource_keys = tuple(resource.keys())
+            if resource_keys not in translation_plans:
+                persistent_plan, collectable_keys = _build_translation_plan(
+                    resource_keys,
+                    ctx_persistent_properties + list(additional_params.items()),
+                )
+                column_keys = tuple(
+                    sorted(collectable_keys + [key for (key, _) in ctx_collectable_properties])
+                )
+                translation_plans[resource_keys] = persistent_plan, collectable_keys, column_keys
+            persistent_plan, collectable_keys, column_keys = translation_plans[resource_keys]
+            persistent_properties = tuple(
+                (key, resource[key] if from_resource else value)
+                for (key, from_resource, value) in persistent_plan
+            )
             collectable_properties = [
-                (key, value) for (key, value) in resource.items() if key in Profile.collectable
+                (key, resource[key]) for key in collectable_keys
             ] + ctx_collectable_properties
             resource_type = self.register_resource_type(
-                resource["uid"], tuple(persistent_properties)
+                resource["uid"], persistent_properties, column_keys
             )
-            if resource_type not in self._storage["resources"].keys():
-                self._storage["resources"][resource_type] = {
-                    key: [] for (key, _) in collectable_properties
+            columns = storage.get(resource_type)
+            if columns is None:
+                columns = storage[resource_type] = {
+                    key: _new_column(value, self._columnar)
+                    for (key, value) in collectable_properties
                 }
             for key, value in collectable_properties:
-                self._storage["resources"][resource_type][key].append(value)
-
-    def register_resource_type(self, uid: str, persistent_properties: tuple[Any, ...]) -> str:
+                column = columns[key]
+                if type(column) is list:
+                    column.append(value)
+                elif COLUMN_TYPECODES.get(type(value)) == column.typecode:
+                    try:
+                        column.append(value)
+                    except OverflowError:
+                        _append_to_column(columns, key, value)
+                else:
+                    _append_to_column(columns, key, value)
+
+    def register_resource_type(
+        self,
+        uid: str,
+        persistent_properties: tuple[Any, ...],
+        collectable_keys: tuple[str, ...] = (),
+    ) -> str:
         """Registers tuple of persistent properties under new key or return existing one
 
+        Since all resources of one type share the same columns of collectable values, resources
+        with different sets of collectable keys (e.g. when some of the values are unknown and
+        hence omitted) are registered as different types.
+
+        :param str uid: uid of the resource that will be used to describe the resource type
+        :param tuple persistent_properties: tuple of persistent properties
+        :param tuple collectable_keys: sorted keys of the collectable properties of the resource
+        :return: uid corresponding to the tuple of persistent properties
+        """
+        # Equal values of different types (e.g. 1, 1.0 and True) have to be registered separately
+        typed_properties = tuple(
+            (key, type(value), value) for (key, value) in persistent_properties
+        ) + (collectable_keys,)
+        try:
+            return self._hashable_tuple_to_resource_type_map[typed_properties]
+        except KeyError:
+            pass
+        except TypeError:
+            # Tuples containing nested dictionaries or lists cannot be hashed
+            return self._register_resource_type_by_key(uid, persistent_properties, collectable_keys)
+        resource_type = self._register_resource_type_by_key(
+            uid, persistent_properties, collectable_keys
+        )
+        self._hashable_tuple_to_resource_type_map[typed_properties] = resource_type
+        return resource_type
+
+    def _register_resource_type_by_key(
+        self,
+        uid: str,
+        persistent_properties: tuple[Any, ...],
+        collectable_keys: tuple[str, ...] = (),
+    ) -> str:
+        """Registers tuple of persistent properties under its string representation
+
         :param str uid: uid of the resource that will be used to describe the resource type
         :param tuple persistent_properties: tuple of persistent properties
+        :param tuple collectable_keys: sorted keys of the collectable properties of the resource
         :return: uid corresponding to the tuple of persistent properties
         """
-        property_key = str(convert.flatten(persistent_properties))
+        property_key = str(convert.flatten(persistent_properties)) + str(collectable_keys)
         uid_key = convert.flatten(uid)
         if property_key not in self._tuple_to_resource_type_map.keys():
             new_type = f"{uid_key}#{self._uid_counter[uid_key]}"
@@ -238,9 +329,19 @@ class Profile(MutableMapping[str, Any]):
     def serialize(self) -> dict[str, Any]:
         """Returns serializable representation of the profile
 
+        Compact array columns are converted back to lists, the rest of the storage is shared.
+
         :return: serializable representation (i.e. the actual storage)
         """
-        return self._storage
+        serialized = dict(self._storage)
+        serialized["resources"] = {
+            resource_type: {
+                key: column.tolist() if isinstance(column, array.array) else column
+                for (key, column) in columns.items()
+            }
+            for (resource_type, columns) in self._storage["resources"].items()
+        }
+        return serialized
 
     def _get_flattened_persistent_values_for(self, resource_type: str) -> dict[str, Any]:
         """Flattens the nested values of the resources to single level
@@ -313,6 +414,28 @@ class Profile(MutableMapping[str, Any]):
                 # In case we have only persistent properties
                 yield persistent_properties.get("snapshot", 0), persistent_properties
 
+    def all_resource_types(
+        self, flatten_values: bool = False
+    ) -> Iterable[tuple[dict[str, Any], dict[str, Any]]]:
+        """Generator for iterating through the resources grouped by their types.
+
+        Unlike :meth:`all_resources`, the resources are not constructed one by one, instead, for
+        each type of resources (i.e. each unique combination of persistent properties) the
+        generator yields its persistent properties and the columns of its collectable
+        properties, as they are stored in the profile. This is suitable for aggregations over
+        huge profiles, since each persistent property is processed only once per type.
+
+        :param bool flatten_values: if set to true, then the persistent values will
+            be flattened to one level.
+        :returns: iterable stream of pairs of persistent properties and dictionary of columns of
+            collectable properties (columns are empty, if the type has only persistent properties)
+        """
+        for resource_type, resources in self._storage["resources"].items():
+            if flatten_values:
+                yield self._get_flattened_persistent_values_for(resource_type), resources
+            else:
+                yield self._storage["resource_type_map"][resource_type], resources
+
     def all_resource_fields(self) -> set[str]:
         """Generator for iterating through all the fields (both flattened and
         original) that are occurring in the resources.
@@ -450,5 +573,72 @@ class Profile(MutableMapping[str, Any]):
         return len(self._storage["resources"])
 
 
+def _build_translation_plan(
+    resource_keys: tuple[str, ...], constant_properties: list[tuple[str, Any]]
+) -> tuple[list[tuple[str, bool, Any]], list[str]]:
+    """Precomputes how resources with the given keys are translated to the efficient format
+
+    The persistent part of the plan is sorted by the keys in the same (stable) order as the
+    persistent properties of the resources.
+
+    :param tuple resource_keys: keys of the translated resources
+    :param list constant_properties: persistent properties shared by all the resources
+    :return: pair of persistent plan, i.e. list of keys, flag whether the value is taken from the
+        resource and the constant value otherwise, and list of collectable keys
+    """
+    persistent_plan = [
+        (key, True, None) for key in resource_keys if key not in Profile.collectable
+    ] + [(key, False, value) for (key, value) in constant_properties]
+    persistent_plan.sort(key=operator.itemgetter(0))
+    collectable_keys = [key for key in resource_keys if key in Profile.collectable]
+    return persistent_plan, collectable_keys
+
+
+def _new_column(value: Any, columnar: bool) -> list[Any] | array.array[Any]:
+    """Creates new column for collectable values, starting with the type of the @p value
+
+    :param object value: the first value that will be stored in the column
+    :param bool columnar: if set to true, then numeric values are stored in compact arrays
+    :return: new empty column
+    """
+    typecode = COLUMN_TYPECODES.get(type(value)) if columnar else None
+    return array.array(typecode) if typecode else []
+
+
+def _append_to_column(columns: dict[str, Any], key: str, value: Any) -> None:
+    """Appends the value to the column, which does not fit into compact array
+
+    If the value does not fit into the array (e.g. because of its type), then the column is
+    converted back to the list of values.
+
+    :param dict columns: columns of one resource type
+    :param str key: key of the column
+    :param object value: appended value
+    """
+    column = columns[key]
+    if isinstance(column, array.array):
+        column = columns[key] = column.tolist()
+    column.append(value)
+
+
+def _compact_columns(columns: Any) -> None:
+    """Converts the homogeneous numeric list columns to compact arrays
+
+    :param dict columns: columns of one resource type
+    """
+    if not isinstance(columns, dict):
+        return
+    for key, column in columns.items():
+        if not isinstance(column, list) or not column:
+            continue
+        value_type = type(column[0])
+        typecode = COLUMN_TYPECODES.get(value_type)
+        if typecode and all(type(value) is value_type for value in column):
+            try:
+                columns[key] = array.array(typecode, column)
+            except OverflowError:
+                pass
+
+
 # Click helper
 pass_profile = click.make_pass_decorator(Profile)
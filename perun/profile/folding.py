@@ -0,0 +1,303 @@
+"""Folding of the call stacks of the resources into prefix tries.
+
+Each stack is folded into the trie of frames, where each path from the root corresponds to one
+stack (from its outermost frame) and each node remembers the amount of resources, whose stack
+ends exactly in the node. The names of the frames are interned, hence each frame is stored (and
+compared) only as an integer identifier, and nodes of the trie are stored in flat arrays indexed
+by the identifiers of the nodes.
+
+Since the resources in the profiles are stored by their persistent properties (which include
+the trace and the uid), each unique stack is folded into the trie only once, and the amounts of
+the resources with the same stack are summed up directly. Two tries can then be merged or
+diffed in time linear to the number of their nodes, without creating any folded-stack strings.
+"""
+from __future__ import annotations
+
+# Standard Imports
+from typing import Any, Iterable, Iterator, Optional, TYPE_CHECKING
+import array
+
+# Third-Party Imports
+
+# Perun Imports
+from perun.profile import convert
+
+if TYPE_CHECKING:
+    from perun.profile.factory import Profile
+
+
+ROOT: int = 0
+NO_NODE: int = -1
+# Edges of the trie are keyed by the parent node shifted by this many bits and the child frame
+FRAME_BITS: int = 32
+
+
+class StackTrie:
+    """Prefix trie of folded stacks with interned frames
+
+    The root of the trie (with identifier :data:`ROOT`) has no frame. Parents are always created
+    before their children, hence the identifier of the parent is always smaller than the
+    identifier of its child. The nodes are stored in flat arrays, the children of each node are
+    linked through their siblings, and the child with the given frame is looked up in the single
+    map of all edges, so the trie stays compact even for millions of unique stacks.
+
+    :ivar dict frame_ids: map of names of the frames to their interned identifiers
+    :ivar list frame_names: names of the frames indexed by their identifiers
+    :ivar array frames: interned frame of each node
+    :ivar array parents: parent of each node (:data:`NO_NODE` for the root)
+    :ivar array first_children: the most recently created child of each node
+    :ivar array next_siblings: the previously created sibling of each node
+    :ivar dict edges: map of parent nodes and frames to the child nodes
+    :ivar array counts: amount of resources, whose stack ends in the node
+    :ivar array baseline_counts: amount of resources in baseline, whose stack ends in the node
+        (only set for differences of two tries)
+    """
+
+    __slots__ = [
+        "frame_ids",
+        "frame_names",
+        "frames",
+        "parents",
+        "first_children",
+        "next_siblings",
+        "edges",
+        "counts",
+        "baseline_counts",
+    ]
+
+    def __init__(self) -> None:
+        """Initializes the trie with the root node"""
+        self.frame_ids: dict[str, int] = {}
+        self.frame_names: list[str] = []
+        self.frames: array.array[int] = array.array("q", [NO_NODE])
+        self.parents: array.array[int] = array.array("q", [NO_NODE])
+        self.first_children: array.array[int] = array.array("q", [NO_NODE])
+        self.next_siblings: array.array[int] = array.array("q", [NO_NODE])
+        self.edges: dict[int, int] = {}
+        self.counts: array.array[float] = array.array("d", [0])
+        self.baseline_counts: Optional[array.array[float]] = None
+
+    def __len__(self) -> int:
+        """
+        :return: number of nodes in the trie (including the root)
+        """
+        return len(self.frames)
+
+    def intern(self, name: str) -> int:
+        """Returns the identifier of the frame, registering it if it is not yet known
+
+        :param str name: name of the frame
+        :return: identifier of the frame
+        """
+        frame_id = self.frame_ids.get(name)
+        if frame_id is None:
+            frame_id = self.frame_ids[name] = len(self.frame_names)
+            self.frame_names.append(name)
+        return frame_id
+
+    def child(self, node: int, frame: int) -> int:
+        """Returns the child of the node with the given frame, creating it if it does not exist
+
+        :param int node: parent node
+        :param int frame: interned frame of the child
+        :return: identifier of the child node
+        """
+        edge = (node << FRAME_BITS) | frame
+        child = self.edges.get(edge)
+        if child is None:
+            child = self.edges[edge] = len(self.frames)
+            self.frames.append(frame)
+            self.parents.append(node)
+            self.first_children.append(NO_NODE)
+            self.next_siblings.append(self.first_children[node])
+            self.first_children[node] = child
+            self.counts.append(0)
+            if self.baseline_counts is not None:
+                self.baseline_counts.append(0)
+        return child
+
+    def children(self, node: int) -> Iterator[int]:
+        """
+        :param int node: parent node
+        :return: iterator of the children of the node
+        """
+        child = self.first_children[node]
+        while child != NO_NODE:
+            yield child
+            child = self.next_siblings[child]
+
+    def add(self, stack: Iterable[str], count: float) -> int:
+        """Folds the stack into the trie
+
+        :param iterable stack: names of the frames from the outermost one
+        :param float count: amount of resources with the stack
+        :return: node, where the stack ends
+        """
+        node, frame_ids, edges = ROOT, self.frame_ids, self.edges
+        for name in stack:
+            frame = frame_ids.get(name)
+            if frame is None:
+                frame = self.intern(name)
+            child = edges.get((node << FRAME_BITS) | frame)
+            node = self.child(node, frame) if child is None else child
+        self.counts[node] += count
+        return node
+
+    def stack_of(self, node: int) -> list[str]:
+        """
+        :param int node: node of the trie
+        :return: names of the frames on the path from the root to the node
+        """
+        stack = []
+        while node != ROOT:
+            stack.append(self.frame_names[self.frames[node]])
+            node = self.parents[node]
+        return stack[::-1]
+
+    def depths(self) -> list[int]:
+        """
+        :return: depth of each node (0 for the root)
+        """
+        depths = [0] * len(self)
+        for node in range(1, len(self)):
+            depths[node] = depths[self.parents[node]] + 1
+        return depths
+
+    def totals(self) -> list[float]:
+        """Computes the inclusive amounts of the nodes, i.e. including the amounts of descendants
+
+        :return: inclusive amount of each node
+        """
+        totals = self.counts.tolist()
+        for node in range(len(totals) - 1, ROOT, -1):
+            totals[self.parents[node]] += totals[node]
+        return totals
+
+    def graft(self, other: StackTrie) -> list[int]:
+        """Adds all nodes of other trie to this trie
+
+        The amounts of the nodes are left untouched, so the caller can combine them as needed.
+
+        :param StackTrie other: grafted trie
+        :return: map of nodes of the other trie to the nodes of this trie
+        """
+        frame_map = [self.intern(name) for name in other.frame_names]
+        node_map = [ROOT] * len(other)
+        for node in range(1, len(other)):
+            node_map[node] = self.child(
+                node_map[other.parents[node]], frame_map[other.frames[node]]
+            )
+        return node_map
+
+    def copy(self) -> StackTrie:
+        """
+        :return: copy of the trie
+        """
+        trie = StackTrie()
+        trie.frame_ids = self.frame_ids.copy()
+        trie.frame_names = self.frame_names.copy()
+        trie.frames = self.frames[:]
+        trie.parents = self.parents[:]
+        trie.first_children = self.first_children[:]
+        trie.next_siblings = self.next_siblings[:]
+        trie.edges = self.edges.copy()
+        trie.counts = self.counts[:]
+        if self.baseline_counts is not None:
+            trie.baseline_counts = self.baseline_counts[:]
+        return trie
+
+    def merge(self, other: StackTrie) -> StackTrie:
+        """Merges two tries, summing the amounts of the same stacks
+
+        :param StackTrie other: merged trie
+        :return: new trie with stacks of both of the tries
+        """
+        merged = self.copy()
+        for node, merged_node in enumerate(merged.graft(other)):
+            merged.counts[merged_node] += other.counts[node]
+        return merged
+
+    def difference(self, baseline: StackTrie, normalize: bool = True) -> StackTrie:
+        """Computes the difference of this (target) trie against the baseline trie
+
+        The resulting trie contains the stacks of both tries, the amounts of the target in
+        :attr:`counts` and the amounts of the baseline in :attr:`baseline_counts`. If @p
+        normalize is set, the baseline amounts are scaled (and truncated) to the same total
+        amount as the target, so the trees are comparable even if they were e.g. sampled for
+        different times.
+
+        :param StackTrie baseline: baseline trie
+        :param bool normalize: if set to true, then baseline amounts are normalized
+        :return: new trie with target and baseline amounts
+        """
+        diff = self.copy()
+        diff.baseline_counts = array.array("d", bytes(len(diff) * diff.counts.itemsize))
+        node_map = diff.graft(baseline)
+        baseline_total, target_total = sum(baseline.counts), sum(self.counts)
+        scale = normalize and baseline_total not in (0, target_total)
+        for node, diff_node in enumerate(node_map):
+            count = baseline.counts[node]
+            diff.baseline_counts[diff_node] += (
+                int(count * target_total / baseline_total) if scale else count
+            )
+        return diff
+
+    def deltas(self) -> list[float]:
+        """
+        :return: difference of target and baseline amounts of stacks ending in each node
+        """
+        assert self.baseline_counts is not None
+        return [target - base for (target, base) in zip(self.counts, self.baseline_counts)]
+
+
+def fold_profile(profile: Profile, amount_key: str = "amount") -> StackTrie:
+    """Folds the stacks of all resources of the profile into the trie.
+
+    The stack of each resource consists of the frames of its trace followed by its uid (as in
+    :func:`perun.profile.convert.to_flame_graph_format`); freed resources are skipped. The stack
+    is constructed only once per each resource type, i.e. per unique persistent properties.
+    Instead of the amounts, other metric of the resources (e.g. the counts of some event sampled
+    by kperf) can be folded; resources without the metric are skipped.
+
+    :param Profile profile: folded profile
+    :param str amount_key: key of the folded metric of the resources
+    :return: trie of the folded stacks with amounts of resources
+    """
+    trie = StackTrie()
+    resource_type_map = profile["resource_type_map"]
+    for resource_type, columns in profile["resources"].items():
+        properties = resource_type_map[resource_type]
+        if properties.get("subtype") == "free":
+            continue
+        amount = _sum_of_amounts(properties, columns, amount_key)
+        if amount is None:
+            continue
+        stack = [convert.to_string_line(frame) for frame in properties.get("trace", [])]
+        stack.append(convert.to_uid(properties["uid"]))
+        trie.add(stack, amount)
+    return trie
+
+
+def _sum_of_amounts(
+    properties: dict[str, Any], columns: dict[str, Any], amount_key: str = "amount"
+) -> Optional[float]:
+    """Sums the amounts of the resources of one type, skipping the freed ones
+
+    :param dict properties: persistent properties of the resource type
+    :param dict columns: columns of collectable properties of the resources
+    :param str amount_key: key of the summed amounts
+    :return: sum of the amounts or None if the resources have no amounts
+    """
+    if not columns:
+        return properties.get(amount_key)
+    if amount_key in columns:
+        amounts = columns[amount_key]
+    elif amount_key in properties:
+        amounts = [properties[amount_key]] * len(next(iter(columns.values())))
+    else:
+        return None
+    if "subtype" in columns:
+        return sum(
+            amount for (amount, subtype) in zip(amounts, columns["subtype"]) if subtype != "free"
+        )
+    return sum(amounts)
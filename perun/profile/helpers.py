@@ -246,11 +246,11 @@ def find_profile_entry(profile: str, minor_version: str) -> index.BasicIndexEntr
         # The profile can be only sha value or source path now
         if store.is_sha1(profile):
             return index.lookup_entry_within_index(
-                index_handle, lambda x: x.checksum == profile, profile
+                index_handle, lambda x: x.checksum == profile, profile, ("checksum", profile)
             )
         else:
             return index.lookup_entry_within_index(
-                index_handle, lambda x: x.path == profile, profile
+                index_handle, lambda x: x.path == profile, profile, ("path", profile)
             )
 
 
@@ -303,12 +303,15 @@ def generate_postprocessor_info(job: Job) -> list[dict[str, Any]]:
 
 def finalize_profile_for_job(profile: profiles.Profile, job: Job) -> profiles.Profile:
     """
+    The keys of the header provided by the collector (e.g. the achieved confidence of the
+    measurements) are kept, unless they are generated for the job.
+
     :param dict profile: collected profile through some collector
     :param Job job: job with information about the computed profile
     :returns dict: valid profile JSON file
     """
     profile.update({"origin": pcs.vcs().get_minor_head()})
-    profile.update({"header": generate_header_for_profile(job)})
+    profile.update({"header": {**profile.get("header", {}), **generate_header_for_profile(job)}})
     profile.update({"machine": environment.get_machine_specification()})
     profile.update({"collector_info": generate_collector_info(job)})
     profile.update({"postprocessors": generate_postprocessor_info(job)})
@@ -601,6 +601,41 @@ def resources_key_options(
     return functools.reduce(lambda x, option: option(x), options, func)
 
 
+def streaming_options(
+    func: Callable[..., Any]
+) -> Callable[[click.Context, click.Option, Any], Any]:
+    """
+    This method creates Click decorator for options of approximate streaming computation of
+    non-parametric postprocessors: `regressogram` and `moving average`.
+
+    :param function func: the function in which the decorator of common options is currently applied
+    :return: returns sequence of the single options for the current function (f) as decorators
+    """
+    options = [
+        click.option(
+            "--streaming",
+            "-st",
+            is_flag=True,
+            default=False,
+            help=(
+                "Computes the approximate models in one pass over the resources and in bounded"
+                " memory using mergeable sketches (suitable for huge profiles)."
+            ),
+        ),
+        click.option(
+            "--sketch_resolution",
+            "-sr",
+            type=click.IntRange(min=4, max=None),
+            default=None,
+            help=(
+                "Sets the number of bins of sketches used by the streaming computation (4096 by"
+                " default). Higher resolution yields more precise models."
+            ),
+        ),
+    ]
+    return functools.reduce(lambda x, option: option(x), options, func)
+
+
 CLI_DUMP_TEMPLATE = None
 CLI_DUMP_TEMPLATE_STRING = """Environment Info
 ----------------
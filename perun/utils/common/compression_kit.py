@@ -0,0 +1,302 @@
+"""Chunked compression of contents into containers of independently compressed blocks.
+
+The content is split into blocks of fixed size, which are compressed independently. This allows
+us to compress the content while it is produced, to inflate it in a streaming fashion, and to
+(de)compress several blocks in parallel (both zlib and zstd release the GIL).
+
+The format of the container is as follows (all integers are little-endian)::
+
+    magic            4B   b"pblk"
+    version          1B   unsigned char
+    codec            1B   unsigned char (0 = zlib, 1 = zstd)
+    block size       4B   unsigned int
+    blocks           sequence of blocks, where each block consists of:
+                       compressed length   4B   unsigned int
+                       raw length          4B   unsigned int
+                       compressed data
+    end marker       block with both lengths set to 0
+
+Contents packed by a single call of ``zlib.compress`` (used by older versions of Perun) never
+start with the magic prefix and are hence inflated by the plain zlib decompressor.
+"""
+from __future__ import annotations
+
+# Standard Imports
+from concurrent.futures import Future, ThreadPoolExecutor
+from types import TracebackType
+from typing import Any, BinaryIO, Callable, Iterable, Iterator, Optional, Type, TypeVar
+import collections
+import io
+import os
+import struct
+import zlib
+
+# Third-Party Imports
+try:
+    import zstandard  # type: ignore
+except ImportError:  # pragma: no cover
+    zstandard = None
+
+# Perun Imports
+
+
+BLOCK_CONTAINER_MAGIC: bytes = b"pblk"
+BLOCK_CONTAINER_VERSION: int = 1
+BLOCK_CONTAINER_PREAMBLE: struct.Struct = struct.Struct("<4sBBI")
+BLOCK_HEADER: struct.Struct = struct.Struct("<II")
+DEFAULT_BLOCK_SIZE: int = 1 << 20
+LEGACY_CHUNK_SIZE: int = 1 << 20
+CODECS: dict[str, int] = {"zlib": 0, "zstd": 1}
+T = TypeVar("T")
+
+
+def is_block_container(content_prefix: bytes) -> bool:
+    """Checks whether the content starts with the magic prefix of block containers
+
+    :param bytes content_prefix: first bytes of the checked content
+    :return: true if the content is a block container
+    """
+    return content_prefix[: len(BLOCK_CONTAINER_MAGIC)] == BLOCK_CONTAINER_MAGIC
+
+
+def default_workers() -> int:
+    """
+    :return: number of threads used for (de)compression of blocks
+    """
+    return max(min(os.cpu_count() or 1, 8), 1)
+
+
+def _get_compressor(codec: int) -> Callable[[bytes], bytes]:
+    """
+    :param int codec: identification of the codec
+    :return: function that compresses one block
+    :raises zlib.error: if the codec is not supported
+    """
+    if codec == CODECS["zlib"]:
+        return zlib.compress
+    if codec == CODECS["zstd"] and zstandard is not None:
+        return lambda block: zstandard.ZstdCompressor().compress(block)
+    raise zlib.error(f"unsupported compression codec '{codec}'")
+
+
+def _get_decompressor(codec: int) -> Callable[[bytes], bytes]:
+    """
+    :param int codec: identification of the codec
+    :return: function that inflates one block
+    :raises zlib.error: if the codec is not supported
+    """
+    if codec == CODECS["zlib"]:
+        return zlib.decompress
+    if codec == CODECS["zstd"] and zstandard is not None:
+        return lambda block: zstandard.ZstdDecompressor().decompress(block)
+    raise zlib.error(f"unsupported compression codec '{codec}'")
+
+
+def _map_blocks(
+    function: Callable[[Any], T],
+    blocks: Iterable[Any],
+    workers: int,
+) -> Iterator[T]:
+    """Applies the function on blocks, in parallel, while keeping the order of blocks
+
+    At most 2 * workers blocks are processed at once, so the memory is bounded even for large
+    streams of blocks.
+
+    :param function: function applied on each block
+    :param blocks: stream of blocks
+    :param int workers: number of threads
+    :return: stream of processed blocks in the original order
+    """
+    if workers <= 1:
+        yield from map(function, blocks)
+        return
+    with ThreadPoolExecutor(max_workers=workers) as executor:
+        pending: collections.deque[Future[T]] = collections.deque()
+        for block in blocks:
+            pending.append(executor.submit(function, block))
+            if len(pending) >= 2 * workers:
+                yield pending.popleft().result()
+        while pending:
+            yield pending.popleft().result()
+
+
+class BlockWriter:
+    """Writer of block containers, that compresses the content while it is written
+
+    :ivar file handle: opened binary handle, where the container is written
+    :ivar int codec: identification of the codec used for compression of blocks
+    :ivar int block_size: size of the uncompressed blocks
+    :ivar int workers: number of threads used for compression
+    :ivar bytearray buffer: content that was not compressed yet
+    """
+
+    __slots__ = ["handle", "codec", "block_size", "workers", "buffer"]
+
+    def __init__(
+        self,
+        handle: BinaryIO,
+        codec: str = "zlib",
+        block_size: int = DEFAULT_BLOCK_SIZE,
+        workers: Optional[int] = None,
+    ) -> None:
+        """
+        :param file handle: opened binary handle, where the container is written
+        :param str codec: name of the codec used for compression of blocks
+        :param int block_size: size of the uncompressed blocks
+        :param int workers: number of threads used for compression (by default based on cpus)
+        :raises zlib.error: if the codec is not supported
+        """
+        self.handle = handle
+        self.codec = CODECS.get(codec, -1)
+        _get_compressor(self.codec)
+        self.block_size = block_size
+        self.workers = workers or default_workers()
+        self.buffer = bytearray()
+        handle.write(
+            BLOCK_CONTAINER_PREAMBLE.pack(
+                BLOCK_CONTAINER_MAGIC, BLOCK_CONTAINER_VERSION, self.codec, block_size
+            )
+        )
+
+    def __enter__(self) -> BlockWriter:
+        """Context manager entry"""
+        return self
+
+    def __exit__(
+        self,
+        exc_type: Optional[Type[BaseException]],
+        exc_val: Optional[BaseException],
+        exc_tb: Optional[TracebackType],
+    ) -> None:
+        """Context manager exit, which flushes the rest of the content"""
+        if exc_type is None:
+            self.close()
+
+    def _write_blocks(self, blocks: Iterable[bytes | memoryview], workers: int) -> None:
+        """Compresses the blocks and writes them to the handle
+
+        :param blocks: stream of uncompressed blocks
+        :param int workers: number of threads used for compression of the blocks
+        """
+        compress = _get_compressor(self.codec)
+        for raw_length, packed_block in _map_blocks(
+            lambda block: (len(block), compress(block)), blocks, workers
+        ):
+            self.handle.write(BLOCK_HEADER.pack(len(packed_block), raw_length))
+            self.handle.write(packed_block)
+
+    def write(self, content: bytes) -> None:
+        """Compresses the whole blocks of the content and buffers the rest
+
+        The whole blocks are compressed directly from the views of the content, hence the content
+        is not copied and only few blocks are held in the memory at once.
+
+        :param bytes content: written content
+        """
+        view = memoryview(content).cast("B")
+        if self.buffer:
+            missing = self.block_size - len(self.buffer)
+            self.buffer.extend(view[:missing])
+            view = view[missing:]
+            if len(self.buffer) < self.block_size:
+                return
+            self._write_blocks([bytes(self.buffer)], 1)
+            self.buffer.clear()
+        whole_blocks = len(view) // self.block_size
+        self._write_blocks(
+            (
+                view[start : start + self.block_size]
+                for start in range(0, whole_blocks * self.block_size, self.block_size)
+            ),
+            min(self.workers, whole_blocks),
+        )
+        self.buffer.extend(view[whole_blocks * self.block_size :])
+
+    def close(self) -> None:
+        """Compresses the rest of the content and writes the end marker"""
+        if self.buffer:
+            self._write_blocks([bytes(self.buffer)], 1)
+            self.buffer.clear()
+        self.handle.write(BLOCK_HEADER.pack(0, 0))
+
+
+def compress(
+    content: bytes,
+    codec: str = "zlib",
+    block_size: int = DEFAULT_BLOCK_SIZE,
+    workers: Optional[int] = None,
+) -> bytes:
+    """Compresses the content into the block container
+
+    :param bytes content: compressed content
+    :param str codec: name of the codec used for compression of blocks
+    :param int block_size: size of the uncompressed blocks
+    :param int workers: number of threads used for compression
+    :return: block container
+    """
+    sink = io.BytesIO()
+    with BlockWriter(sink, codec, block_size, workers) as writer:
+        writer.write(content)
+    return sink.getvalue()
+
+
+def _read_blocks(handle: BinaryIO) -> Iterator[bytes]:
+    """Reads the compressed blocks of the container, the preamble has to be read already
+
+    :param file handle: opened binary handle positioned at the first block
+    :return: stream of compressed blocks
+    :raises zlib.error: when the container is truncated
+    """
+    while True:
+        block_header = handle.read(BLOCK_HEADER.size)
+        if len(block_header) != BLOCK_HEADER.size:
+            raise zlib.error("truncated block container")
+        packed_length, _ = BLOCK_HEADER.unpack(block_header)
+        if packed_length == 0:
+            return
+        packed_block = handle.read(packed_length)
+        if len(packed_block) != packed_length:
+            raise zlib.error("truncated block container")
+        yield packed_block
+
+
+def iter_decompressed(handle: BinaryIO, workers: Optional[int] = None) -> Iterator[bytes]:
+    """Inflates the content of the handle in a streaming fashion
+
+    Both block containers and contents compressed by plain zlib are supported. The blocks of
+    containers are inflated in parallel.
+
+    :param file handle: opened binary handle
+    :param int workers: number of threads used for decompression
+    :return: stream of inflated chunks of the content
+    :raises zlib.error: when the content is malformed
+    """
+    preamble = handle.read(BLOCK_CONTAINER_PREAMBLE.size)
+    if not is_block_container(preamble):
+        decompressor = zlib.decompressobj()
+        chunk = preamble + handle.read(LEGACY_CHUNK_SIZE)
+        while chunk:
+            yield decompressor.decompress(chunk)
+            chunk = handle.read(LEGACY_CHUNK_SIZE)
+        yield decompressor.flush()
+        return
+
+    if len(preamble) != BLOCK_CONTAINER_PREAMBLE.size:
+        raise zlib.error("truncated block container")
+    _, version, codec, _ = BLOCK_CONTAINER_PREAMBLE.unpack(preamble)
+    if version > BLOCK_CONTAINER_VERSION:
+        raise zlib.error(f"unsupported version '{version}' of block container")
+    yield from _map_blocks(
+        _get_decompressor(codec), _read_blocks(handle), workers or default_workers()
+    )
+
+
+def decompress(handle: BinaryIO, workers: Optional[int] = None) -> bytes:
+    """Inflates the whole content of the handle
+
+    :param file handle: opened binary handle
+    :param int workers: number of threads used for decompression
+    :return: inflated content
+    :raises zlib.error: when the content is malformed
+    """
+    return b"".join(iter_decompressed(handle, workers))
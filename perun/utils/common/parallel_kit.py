@@ -0,0 +1,178 @@
+"""Parallel execution of computations over chunks of points, e.g. of postprocessors per each uid.
+
+The points of all chunks are stored in arrays in anonymous shared memory, which is inherited by
+forked workers of the process pool. Hence, the points are never pickled, and the workers only
+receive the indices of chunks they should compute. The results are returned in the order of
+the chunks, regardless of the order, in which the workers finish them.
+"""
+from __future__ import annotations
+
+# Standard Imports
+from typing import Any, Callable, Iterable, TypeVar, TYPE_CHECKING
+import mmap
+import multiprocessing
+
+# Third-Party Imports
+import numpy as np
+
+# Perun Imports
+from perun.logic import config
+from perun.utils import log
+
+if TYPE_CHECKING:
+    import numpy.typing as npt
+
+
+ChunkResult = TypeVar("ChunkResult")
+# Data of the currently computed chunks; forked workers inherit them instead of unpickling them
+_SHARED_CHUNKS: dict[str, Any] = {}
+
+
+def get_number_of_workers() -> int:
+    """Returns the number of workers, which compute the chunks concurrently.
+
+    The number is set by :ckey:`execute.postprocess_workers`; by default the chunks are computed
+    sequentially.
+
+    :return: number of workers (at least 1)
+    """
+    try:
+        return max(int(config.lookup_key_recursively("execute.postprocess_workers", "1")), 1)
+    except ValueError:
+        log.warn("'execute.postprocess_workers' is not a number: computing sequentially")
+        return 1
+    except OSError:
+        return 1
+
+
+def to_shared_array(arrays: list[npt.NDArray[Any]]) -> npt.NDArray[Any]:
+    """Concatenates the arrays into one array stored in the anonymous shared memory.
+
+    :param list arrays: list of one-dimensional numeric arrays
+    :return: concatenated array, that is shared with forked processes
+    """
+    dtype = np.result_type(*arrays)
+    length = sum(len(array) for array in arrays)
+    # Anonymous mappings are shared with the forked children, without any copying
+    shared_memory = mmap.mmap(-1, max(length * dtype.itemsize, 1))
+    shared_array: npt.NDArray[Any] = np.frombuffer(shared_memory, dtype=dtype, count=length)
+    np.concatenate(arrays, out=shared_array)
+    return shared_array
+
+
+def _are_shareable(arrays: list[npt.NDArray[Any]]) -> bool:
+    """Checks that the arrays can be concatenated without changing any of the values or types
+
+    :param list arrays: list of arrays of points
+    :return: true if all arrays are one-dimensional numeric arrays of the same type
+    """
+    return all(
+        array.ndim == 1 and array.dtype.kind in "iuf" and array.dtype == arrays[0].dtype
+        for array in arrays
+    )
+
+
+def _compute_shared_chunk(index: int) -> Any:
+    """Computes one chunk stored in the shared memory
+
+    :param int index: index of the chunk
+    :return: result of the chunk function
+    """
+    start, end = _SHARED_CHUNKS["offsets"][index], _SHARED_CHUNKS["offsets"][index + 1]
+    x_pts, y_pts = _SHARED_CHUNKS["x_pts"][start:end], _SHARED_CHUNKS["y_pts"][start:end]
+    return _SHARED_CHUNKS["function"](
+        x_pts.tolist() if _SHARED_CHUNKS["as_lists"] else x_pts,
+        y_pts.tolist() if _SHARED_CHUNKS["as_lists"] else y_pts,
+        _SHARED_CHUNKS["uids"][index],
+        *_SHARED_CHUNKS["args"],
+    )
+
+
+def _as_list(points: Any) -> Any:
+    """
+    :param points: list or array of points
+    :return: list of points with values of builtin types (e.g. for storing them in profile)
+    """
+    return points.tolist() if isinstance(points, np.ndarray) else points
+
+
+def _map_chunks_sequentially(
+    chunk_function: Callable[..., ChunkResult],
+    chunks: list[tuple[Any, Any, str]],
+    as_lists: bool,
+    *args: Any,
+) -> list[ChunkResult]:
+    """Computes the function for each chunk of points in this process
+
+    :param function chunk_function: function computed for each chunk
+    :param list chunks: chunks of x points, y points and uid
+    :param bool as_lists: if set to true, the points are passed as lists, otherwise as arrays
+    :param args: additional arguments of the chunk function
+    :return: list of results for each of the chunks
+    """
+    convert = _as_list if as_lists else np.asarray
+    return [
+        chunk_function(convert(x_pts), convert(y_pts), uid, *args) for (x_pts, y_pts, uid) in chunks
+    ]
+
+
+def map_chunks(
+    chunk_function: Callable[..., ChunkResult],
+    chunks: Iterable[tuple[Any, Any, str]],
+    *args: Any,
+    as_lists: bool = True,
+) -> list[ChunkResult]:
+    """Computes the function for each chunk of points, possibly in the pool of workers.
+
+    The function is called as ``chunk_function(x_pts, y_pts, uid, *args)``, where the points are
+    passed as lists (even if the chunks contain arrays, e.g. from columnar data provider), unless
+    @p as_lists is false, in which case they are passed as arrays without any copying.
+    If more workers are configured (see :ckey:`execute.postprocess_workers`), the chunks are
+    computed concurrently.
+    Chunks with non-numeric points (or points of different numeric types) are always computed
+    sequentially, as well as all chunks when called from a daemonic process (e.g. the workers of
+    degradation checks), which are not allowed to spawn their own workers.
+
+    :param function chunk_function: function computed for each chunk (has to be defined at the
+        module level)
+    :param iterable chunks: chunks of x points, y points (lists or arrays) and uid (e.g. from
+        data providers)
+    :param args: additional arguments of the chunk function
+    :param bool as_lists: if set to true, the points are passed as lists, otherwise as arrays
+    :return: list of results for each of the chunks in the original order
+    """
+    chunks = list(chunks)
+    workers = min(get_number_of_workers(), len(chunks))
+    if (
+        workers <= 1
+        or multiprocessing.current_process().daemon
+        or "fork" not in multiprocessing.get_all_start_methods()
+    ):
+        return _map_chunks_sequentially(chunk_function, chunks, as_lists, *args)
+
+    x_arrays = [np.asarray(x_pts) for (x_pts, _, _) in chunks]
+    y_arrays = [np.asarray(y_pts) for (_, y_pts, _) in chunks]
+    if not _are_shareable(x_arrays) or not _are_shareable(y_arrays):
+        return _map_chunks_sequentially(chunk_function, chunks, as_lists, *args)
+
+    _SHARED_CHUNKS.update(
+        {
+            "x_pts": to_shared_array(x_arrays),
+            "y_pts": to_shared_array(y_arrays),
+            "offsets": np.cumsum([0] + [len(array) for array in x_arrays]).tolist(),
+            "uids": [uid for (_, _, uid) in chunks],
+            "function": chunk_function,
+            "args": args,
+            "as_lists": as_lists,
+        }
+    )
+    del x_arrays, y_arrays, chunks
+    try:
+        with multiprocessing.get_context("fork").Pool(workers) as pool:
+            return pool.map(
+                _compute_shared_chunk,
+                range(len(_SHARED_CHUNKS["uids"])),
+                chunksize=max(1, len(_SHARED_CHUNKS["uids"]) // (4 * workers)),
+            )
+    finally:
+        _SHARED_CHUNKS.clear()
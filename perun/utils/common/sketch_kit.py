@@ -0,0 +1,552 @@
+"""Mergeable sketches, that summarize huge series of points in one pass and bounded memory.
+
+The sketches are updated by batches of points (e.g. slices of columns of profile), hence even the
+series with hundreds of millions of points are summarized without materializing any per-point
+Python objects. Sketches of different parts of the same series can be merged, e.g. when the parts
+were summarized by different workers.
+
+:class:`MomentSketch` keeps exact count, mean, second and third central moments and extremes.
+:class:`HistogramSketch` keeps the points binned into at most ``resolution`` bins of equal width
+aligned to the grid of powers of two. When the points do not fit into the bins, the width of bins
+is doubled (and neighbouring bins are merged), so the width of bins is at most
+``2 * (x_max - x_min) / (resolution - 2)``. Any statistic of points aggregated over the bins is
+hence computed for intervals, whose edges are displaced by at most one width of the bin.
+:class:`WindowedStatistics` computes moving statistics incrementally, keeping only the last window
+of the series.
+"""
+from __future__ import annotations
+
+# Standard Imports
+from typing import Any, Optional, TYPE_CHECKING
+import math
+
+# Third-Party Imports
+import numpy as np
+import scipy.signal
+
+# Perun Imports
+
+if TYPE_CHECKING:
+    import numpy.typing as npt
+
+
+# Number of points processed at once by the streaming computations
+BATCH_SIZE: int = 1 << 16
+# Default number of bins of the histogram sketches
+DEFAULT_RESOLUTION: int = 4096
+# Number of significant bits kept in the indices of bins (so they fit into int64)
+_INDEX_PRECISION: int = 52
+
+
+class MomentSketch:
+    """Mergeable summary of the count, central moments and extremes of values
+
+    :ivar int count: number of summarized values
+    :ivar float mean: mean of the values
+    :ivar float m2: sum of the squared deviations from the mean
+    :ivar float m3: sum of the cubed deviations from the mean
+    :ivar float minimum: minimal value
+    :ivar float maximum: maximal value
+    """
+
+    __slots__ = ["count", "mean", "m2", "m3", "minimum", "maximum"]
+
+    def __init__(self) -> None:
+        """Initializes the empty sketch"""
+        self.count: int = 0
+        self.mean: float = 0.0
+        self.m2: float = 0.0
+        self.m3: float = 0.0
+        self.minimum: Any = math.inf
+        self.maximum: Any = -math.inf
+
+    def update(self, values: npt.NDArray[Any]) -> None:
+        """Adds the batch of values into the summary
+
+        :param np.ndarray values: batch of values
+        """
+        if len(values) == 0:
+            return
+        batch = MomentSketch()
+        batch.count = len(values)
+        batch.mean = float(np.mean(values))
+        deviations = np.asarray(values, dtype=np.float64) - batch.mean
+        batch.m2 = float(np.dot(deviations, deviations))
+        batch.m3 = float(np.sum(deviations**3))
+        batch.minimum, batch.maximum = values.min().item(), values.max().item()
+        self.merge(batch)
+
+    def merge(self, other: MomentSketch) -> None:
+        """Merges the summary of other values into this summary
+
+        :param MomentSketch other: merged summary
+        """
+        if other.count == 0:
+            return
+        count = self.count + other.count
+        delta = other.mean - self.mean
+        self.m3 += (
+            other.m3
+            + delta**3 * self.count * other.count * (self.count - other.count) / count**2
+            + 3.0 * delta * (self.count * other.m2 - other.count * self.m2) / count
+        )
+        self.m2 += other.m2 + delta**2 * self.count * other.count / count
+        self.mean += delta * other.count / count
+        self.count = count
+        self.minimum = min(self.minimum, other.minimum)
+        self.maximum = max(self.maximum, other.maximum)
+
+    def std(self) -> float:
+        """
+        :return: (population) standard deviation of values
+        """
+        return math.sqrt(max(self.m2, 0.0) / self.count) if self.count else 0.0
+
+    def skewness(self) -> float:
+        """
+        :return: (population) skewness of values, or 0 if the values are constant
+        """
+        sigma = self.std()
+        return (self.m3 / self.count) / sigma**3 if sigma > 0.0 else 0.0
+
+
+class HistogramSketch:
+    """Mergeable histogram of points (x, y) binned by the x coordinates
+
+    Bin with index ``k`` covers the interval ``[k * 2**level, (k + 1) * 2**level)``, the sketch
+    keeps ``resolution`` consecutive bins starting with the index ``offset``. For each bin, the
+    count of points and the sum, the sum of squares, the minimum and the maximum of y coordinates
+    are stored.
+
+    :ivar int resolution: maximal number of bins
+    :ivar int level: binary logarithm of the width of bins
+    :ivar int offset: index of the first kept bin
+    :ivar MomentSketch x_moments: exact summary of the x coordinates
+    :ivar np.ndarray counts: number of points in bins
+    :ivar np.ndarray y_sums: sums of y coordinates in bins
+    :ivar np.ndarray y_squares: sums of squared y coordinates in bins
+    :ivar np.ndarray y_mins: minimal y coordinates in bins
+    :ivar np.ndarray y_maxs: maximal y coordinates in bins
+    """
+
+    __slots__ = [
+        "resolution",
+        "level",
+        "offset",
+        "x_moments",
+        "counts",
+        "y_sums",
+        "y_squares",
+        "y_mins",
+        "y_maxs",
+    ]
+
+    def __init__(self, resolution: int = DEFAULT_RESOLUTION) -> None:
+        """Initializes the empty sketch
+
+        :param int resolution: maximal number of bins (at least 4)
+        """
+        self.resolution: int = max(resolution, 4)
+        self.level: int = -(2**30)
+        self.offset: int = 0
+        self.x_moments: MomentSketch = MomentSketch()
+        self.counts: npt.NDArray[np.float64] = np.zeros(self.resolution)
+        self.y_sums: npt.NDArray[np.float64] = np.zeros(self.resolution)
+        self.y_squares: npt.NDArray[np.float64] = np.zeros(self.resolution)
+        self.y_mins: npt.NDArray[np.float64] = np.full(self.resolution, np.inf)
+        self.y_maxs: npt.NDArray[np.float64] = np.full(self.resolution, -np.inf)
+
+    @property
+    def count(self) -> int:
+        """
+        :return: number of points in the sketch
+        """
+        return self.x_moments.count
+
+    @property
+    def width(self) -> float:
+        """
+        :return: width of the bins
+        """
+        return math.ldexp(1.0, self.level)
+
+    def _index_of(self, x: float, level: int) -> int:
+        """
+        :param float x: x coordinate
+        :param int level: binary logarithm of the width of bins
+        :return: index of the bin containing the coordinate
+        """
+        return math.floor(math.ldexp(x, -level))
+
+    def _fitting_level(self, x_min: float, x_max: float, level: int) -> int:
+        """Finds the minimal level (not lower than @p level), where the interval fits into bins
+
+        :param float x_min: start of the interval
+        :param float x_max: end of the interval
+        :param int level: the minimal considered level
+        :return: the level, where the interval covers at most resolution bins
+        """
+        # The indices have to be precise and fit into int64
+        magnitude = math.frexp(max(abs(x_min), abs(x_max)))[1]
+        level = max(level, magnitude - _INDEX_PRECISION)
+        while self._index_of(x_max, level) - self._index_of(x_min, level) >= self.resolution:
+            level += 1
+        return level
+
+    def _rebin(self, level: int, offset: int) -> None:
+        """Moves the bins to the new (coarser or equal) level and new offset
+
+        :param int level: the new level
+        :param int offset: index of the first bin at the new level
+        """
+        if level == self.level and offset == self.offset:
+            return
+        used = np.flatnonzero(self.counts)
+        indices = ((used + self.offset) >> (level - self.level)) - offset
+        counts, y_sums, y_squares = (np.zeros(self.resolution) for _ in range(3))
+        y_mins, y_maxs = np.full(self.resolution, np.inf), np.full(self.resolution, -np.inf)
+        np.add.at(counts, indices, self.counts[used])
+        np.add.at(y_sums, indices, self.y_sums[used])
+        np.add.at(y_squares, indices, self.y_squares[used])
+        np.minimum.at(y_mins, indices, self.y_mins[used])
+        np.maximum.at(y_maxs, indices, self.y_maxs[used])
+        self.counts, self.y_sums, self.y_squares = counts, y_sums, y_squares
+        self.y_mins, self.y_maxs = y_mins, y_maxs
+        self.level, self.offset = level, offset
+
+    def _fit(self, x_min: float, x_max: float, level: int) -> None:
+        """Rebins the sketch so the interval and the points already in the sketch fit into bins
+
+        :param float x_min: start of the interval
+        :param float x_max: end of the interval
+        :param int level: the minimal level of the sketch
+        """
+        if self.count:
+            x_min, x_max = min(x_min, self.x_moments.minimum), max(x_max, self.x_moments.maximum)
+        level = self._fitting_level(x_min, x_max, max(level, self.level))
+        if not self.count:
+            self.level = level
+        self._rebin(level, self._index_of(x_min, level))
+
+    def update(self, x_pts: npt.NDArray[Any], y_pts: npt.NDArray[Any]) -> None:
+        """Adds the batch of points into the sketch
+
+        :param np.ndarray x_pts: x coordinates of the points
+        :param np.ndarray y_pts: y coordinates of the points
+        """
+        if len(x_pts) == 0:
+            return
+        x_pts, y_pts = np.asarray(x_pts), np.asarray(y_pts, dtype=np.float64)
+        self._fit(float(x_pts.min()), float(x_pts.max()), self.level)
+        self.x_moments.update(x_pts)
+        indices = np.floor(np.ldexp(x_pts.astype(np.float64), -self.level)).astype(np.int64)
+        indices -= self.offset
+        self.counts += np.bincount(indices, minlength=self.resolution)
+        self.y_sums += np.bincount(indices, weights=y_pts, minlength=self.resolution)
+        self.y_squares += np.bincount(indices, weights=y_pts**2, minlength=self.resolution)
+        np.minimum.at(self.y_mins, indices, y_pts)
+        np.maximum.at(self.y_maxs, indices, y_pts)
+
+    def merge(self, other: HistogramSketch) -> None:
+        """Merges the other sketch (with the same resolution) into this sketch
+
+        :param HistogramSketch other: merged sketch
+        """
+        if other.count == 0:
+            return
+        self._fit(other.x_moments.minimum, other.x_moments.maximum, other.level)
+        other_bins = HistogramSketch(other.resolution)
+        other_bins.x_moments.merge(other.x_moments)
+        other_bins.counts, other_bins.y_sums = other.counts, other.y_sums
+        other_bins.y_squares, other_bins.y_mins, other_bins.y_maxs = (
+            other.y_squares,
+            other.y_mins,
+            other.y_maxs,
+        )
+        other_bins.level, other_bins.offset = other.level, other.offset
+        other_bins._rebin(self.level, self.offset)
+        self.x_moments.merge(other.x_moments)
+        self.counts += other_bins.counts
+        self.y_sums += other_bins.y_sums
+        self.y_squares += other_bins.y_squares
+        np.minimum(self.y_mins, other_bins.y_mins, out=self.y_mins)
+        np.maximum(self.y_maxs, other_bins.y_maxs, out=self.y_maxs)
+
+    def bin_centers(self) -> npt.NDArray[np.float64]:
+        """
+        :return: centers of the bins clamped to the range of the points
+        """
+        centers = (np.arange(self.resolution) + self.offset + 0.5) * self.width
+        return np.clip(centers, self.x_moments.minimum, self.x_moments.maximum)
+
+    def _order_statistic(self, cumulative_counts: npt.NDArray[np.float64], rank: int) -> float:
+        """Approximates the order statistic of x coordinates by the center of its bin
+
+        :param np.ndarray cumulative_counts: cumulative counts of points in bins
+        :param int rank: the (zero-based) rank of the order statistic
+        :return: approximate order statistic
+        """
+        bin_index = int(np.searchsorted(cumulative_counts, rank, side="right"))
+        return float(self.bin_centers()[min(bin_index, self.resolution - 1)])
+
+    def quantile(self, q: float) -> float:
+        """Approximates the quantile of x coordinates, the error is at most half of the bin width
+
+        The quantile is linearly interpolated between the closest order statistics, as by numpy.
+
+        :param float q: the quantile in the range [0, 1]
+        :return: approximate quantile of x coordinates
+        """
+        cumulative_counts = np.cumsum(self.counts)
+        rank = q * (self.count - 1)
+        lower_rank = math.floor(rank)
+        lower = self._order_statistic(cumulative_counts, lower_rank)
+        upper = self._order_statistic(cumulative_counts, min(lower_rank + 1, self.count - 1))
+        return lower + (rank - lower_rank) * (upper - lower)
+
+    def aggregate(
+        self, bucket_number: int, x_start: Optional[float] = None, x_end: Optional[float] = None
+    ) -> tuple[npt.NDArray[np.int64], npt.NDArray[np.float64], dict[str, npt.NDArray[Any]]]:
+        """Aggregates the bins into buckets of equal width spanning the range of x coordinates
+
+        Each bin is assigned to the bucket containing its center.
+
+        :param int bucket_number: number of buckets
+        :param float x_start: start of the first bucket (by default the minimal x coordinate)
+        :param float x_end: end of the last bucket (by default the maximal x coordinate)
+        :return: bucket index of each bin, edges of buckets, and the counts, sums and sums of
+            squares of y coordinates in each bucket
+        """
+        edges = np.linspace(
+            self.x_moments.minimum if x_start is None else x_start,
+            self.x_moments.maximum if x_end is None else x_end,
+            bucket_number + 1,
+        )
+        bucket_width = (edges[-1] - edges[0]) / bucket_number
+        if bucket_width > 0:
+            buckets = np.floor((self.bin_centers() - edges[0]) / bucket_width).astype(np.int64)
+        else:
+            buckets = np.zeros(self.resolution, dtype=np.int64)
+        buckets = np.clip(buckets, 0, bucket_number - 1)
+        return (
+            buckets,
+            edges,
+            {
+                "counts": np.bincount(buckets, self.counts, bucket_number),
+                "sums": np.bincount(buckets, self.y_sums, bucket_number),
+                "squares": np.bincount(buckets, self.y_squares, bucket_number),
+            },
+        )
+
+
+def ewm_alpha(decay: str, value: float) -> float:
+    """Converts the decay parameter of exponential moving average to the smoothing factor
+
+    :param str decay: name of the decay parameter (com, span, halflife or alpha)
+    :param float value: value of the decay parameter
+    :return: smoothing factor alpha
+    """
+    if decay == "com":
+        return 1.0 / (1.0 + value)
+    if decay == "span":
+        return 2.0 / (value + 1.0)
+    if decay == "halflife":
+        return 1.0 - math.exp(-math.log(2.0) / value)
+    return value
+
+
+def ewm_warm_up_length(alpha: float, relative_error: float) -> int:
+    """Computes the number of preceding values needed to warm up the exponential moving average
+
+    The weights of values older than the warm-up sum to less than the @p relative_error, hence
+    the average of the continued series differs by at most ``relative_error * max(|y|)``.
+
+    :param float alpha: smoothing factor
+    :param float relative_error: the required bound of the error
+    :return: number of values to warm up the average
+    """
+    if alpha >= 1.0:
+        return 0
+    return max(math.ceil(math.log(relative_error) / math.log(1.0 - alpha)), 0)
+
+
+class WindowedStatistics:
+    """Incremental moving statistics of the series, with the same semantics as pandas
+
+    Simple moving average ('sma', optionally weighted by the window of the scipy type), simple
+    moving median ('smm') and exponential moving average ('ema', with adjusted weights) are
+    supported. Only the last window of the series is kept between the batches. The statistics of
+    centered windows lag behind the processed values by the half of the window, the rest of them is
+    returned by :meth:`finish`.
+
+    The statistics of the series split into consecutive parts can be computed independently,
+    if each part (except of the first one) is warmed up by the preceding window of values (see
+    :meth:`warm_up` and :func:`ewm_warm_up_length` for exponential moving average).
+
+    :ivar str method: the computed statistic
+    :ivar int window_width: width of the window
+    :ivar int min_periods: minimal number of values in window for the statistic to be defined
+    :ivar bool center: if set to true, the statistic is computed for centered windows
+    :ivar np.ndarray weights: weights of the values in window, or None if they are not weighted
+    :ivar float alpha: smoothing factor of exponential moving average
+    :ivar np.ndarray history: the last values of the series (NaNs stand for missing values)
+    :ivar list ewm_state: numerator, denominator and count of values of exponential average
+    :ivar int skipped: number of statistics of windows, that are still to be skipped when centered
+    """
+
+    __slots__ = [
+        "method",
+        "window_width",
+        "min_periods",
+        "center",
+        "weights",
+        "alpha",
+        "history",
+        "ewm_state",
+        "skipped",
+    ]
+
+    def __init__(
+        self,
+        method: str,
+        window_width: int,
+        min_periods: Optional[int] = None,
+        center: bool = False,
+        window_type: Optional[str] = None,
+        alpha: float = 1.0,
+    ) -> None:
+        """
+        :param str method: the computed statistic ('sma', 'smm' or 'ema')
+        :param int window_width: width of the window
+        :param int min_periods: minimal number of values in window (by default the window width)
+        :param bool center: if set to true, the statistic is computed for centered windows
+        :param str window_type: scipy type of the window used to weight the values of 'sma'
+        :param float alpha: smoothing factor of exponential moving average
+        """
+        self.method = method
+        self.window_width = max(int(window_width), 1)
+        self.min_periods = self.window_width if min_periods is None else min_periods
+        self.center = center and method != "ema"
+        self.weights: Optional[npt.NDArray[np.float64]] = (
+            scipy.signal.windows.get_window(window_type, self.window_width, False)
+            if window_type and method == "sma"
+            else None
+        )
+        self.alpha = alpha
+        self.history: npt.NDArray[np.float64] = np.full(self.window_width - 1, np.nan)
+        self.ewm_state: list[float] = [0.0, 0.0, 0.0]
+        self.skipped: int = self.lag
+
+    @property
+    def lag(self) -> int:
+        """
+        :return: number of values, whose statistics are not yet returned
+        """
+        return (self.window_width - 1) // 2 if self.center else 0
+
+    def _window_statistics(self, values: npt.NDArray[np.float64]) -> npt.NDArray[np.float64]:
+        """Computes the statistics of windows ending at each of the values (not the history)
+
+        :param np.ndarray values: the values preceded by the history of window width - 1 values
+        :return: statistics of windows
+        """
+        width = self.window_width
+        present = ~np.isnan(values)
+        counts = np.convolve(present, np.ones(width), mode="valid")
+        if self.method == "smm":
+            statistics = np.full(len(counts), np.nan)
+            defined = counts >= max(self.min_periods, 1)
+            # Median of windows is computed in slices, so the copies of windows stay small
+            step = max(BATCH_SIZE // width, 1)
+            windows = np.lib.stride_tricks.sliding_window_view(values, width)
+            for start in range(0, len(counts), step):
+                part = slice(start, start + step)
+                if defined[part].any():
+                    with np.errstate(all="ignore"):
+                        statistics[part] = np.nanmedian(windows[part], axis=1)
+            statistics[~defined] = np.nan
+            return statistics
+        weights = np.ones(width) if self.weights is None else self.weights
+        filled = np.where(present, values, 0.0)
+        # Convolution flips the kernel, hence the weights are reversed to align with windows
+        sums = np.convolve(filled, weights[::-1], mode="valid")
+        weight_sums = np.convolve(present, weights[::-1], mode="valid")
+        with np.errstate(all="ignore"):
+            statistics = sums / weight_sums
+        statistics[counts < max(self.min_periods, 1)] = np.nan
+        return statistics
+
+    def _ewm_statistics(self, values: npt.NDArray[np.float64]) -> npt.NDArray[np.float64]:
+        """Computes exponential moving average of the values continuing the current state
+
+        :param np.ndarray values: the values of the series
+        :return: exponential moving averages
+        """
+        if len(values) == 0:
+            return np.array([])
+        decay = 1.0 - self.alpha
+        numerator, denominator, count = self.ewm_state
+        # Both sums follow the recurrence s_i = v_i + decay * s_{i-1}
+        numerators = scipy.signal.lfilter([1.0], [1.0, -decay], values, zi=[decay * numerator])[0]
+        denominators = scipy.signal.lfilter(
+            [1.0], [1.0, -decay], np.ones(len(values)), zi=[decay * denominator]
+        )[0]
+        with np.errstate(all="ignore"):
+            statistics = numerators / denominators
+        counts = count + np.arange(1, len(values) + 1)
+        statistics[counts < max(self.min_periods, 1)] = np.nan
+        self.ewm_state = [numerators[-1], denominators[-1], counts[-1]]
+        return statistics
+
+    def _process(self, values: npt.NDArray[np.float64]) -> npt.NDArray[np.float64]:
+        """Computes the statistics of windows ending at the values and updates the history
+
+        :param np.ndarray values: batch of values
+        :return: statistics of windows ending at each of the values
+        """
+        if self.method == "ema":
+            return self._ewm_statistics(values)
+        extended = np.concatenate([self.history, values])
+        statistics = self._window_statistics(extended)
+        self.history = extended[len(extended) - (self.window_width - 1) :]
+        return statistics
+
+    def warm_up(self, values: npt.NDArray[Any]) -> None:
+        """Processes the values preceding the series, without computing their statistics
+
+        :param np.ndarray values: values preceding the series
+        """
+        values = np.asarray(values, dtype=np.float64)
+        if self.method == "ema":
+            self._ewm_statistics(values)
+        else:
+            extended = np.concatenate([self.history, values])
+            self.history = extended[len(extended) - (self.window_width - 1) :]
+
+    def _skip_lagging(self, statistics: npt.NDArray[np.float64]) -> npt.NDArray[np.float64]:
+        """Skips the statistics of windows, that are not centered at any value of the series
+
+        :param np.ndarray statistics: statistics of windows ending at the processed values
+        :return: statistics of the centered windows
+        """
+        skipped = min(self.skipped, len(statistics))
+        self.skipped -= skipped
+        return statistics[skipped:]
+
+    def update(self, values: npt.NDArray[Any]) -> npt.NDArray[np.float64]:
+        """Processes the batch of values of the series
+
+        :param np.ndarray values: batch of values
+        :return: statistics of the values, whose windows are complete (i.e. all except of the last
+            values of centered windows)
+        """
+        return self._skip_lagging(self._process(np.asarray(values, dtype=np.float64)))
+
+    def finish(self) -> npt.NDArray[np.float64]:
+        """Computes the statistics of the last lagging values of centered windows
+
+        :return: the remaining statistics
+        """
+        if not self.lag:
+            return np.array([])
+        return self._skip_lagging(self._process(np.full(self.lag, np.nan)))
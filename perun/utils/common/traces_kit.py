@@ -1,12 +1,25 @@
-"""Set of helpers for working with traces """
+"""Set of helpers for working with traces
+
+The traces are classified into clusters of similar traces, where the similarity is given by the
+edit distance of the traces (see :func:`compute_distance`). To avoid comparing each trace with
+pivots of all clusters, the clusters are indexed by the lengths of their pivots (since traces of
+too different lengths are never similar) and by locality sensitive hashing of the MinHash
+signatures of the pivots: the signature of each trace approximates the Jaccard similarity of the
+sets of its frames and pairs of consecutive frames. Traces, whose signatures collide in any band,
+are the candidates for the comparison, and only the few candidates with the most collisions are
+compared using the edit distance.
+"""
 from __future__ import annotations
 
 # Standard Imports
 from enum import Enum
-from typing import Any, Callable, Optional
+from typing import Any, Callable, Iterable, Optional
+import collections
 import functools
+import zlib
 
 # Third-Party Imports
+import numpy as np
 
 # Perun Imports
 
@@ -27,6 +40,17 @@ class ClassificationStrategy(Enum):
 
 
 DEFAULT_THRESHOLD: float = 2.0
+# Number of pivots compared with each trace; if there are more pivots of similar length, only the
+# candidates from the locality sensitive hashing are compared
+MAX_CANDIDATES: int = 8
+# The MinHash signature is split into bands of rows; the traces are candidates if they share a band
+MINHASH_BANDS: int = 16
+MINHASH_ROWS: int = 2
+# Mersenne prime used for the universal hashing of shingles (the products fit into 64 bits)
+_MINHASH_PRIME: int = (1 << 31) - 1
+_MINHASH_COEFFICIENTS = np.random.default_rng(0xC1A55).integers(
+    1, _MINHASH_PRIME, size=(2, MINHASH_BANDS * MINHASH_ROWS, 1), dtype=np.uint64
+)
 
 
 class TraceCluster:
@@ -37,17 +61,20 @@ class TraceCluster:
     :ivar pivot: main representant of the cluster, that is used for comparisons with other members
     :ivar members: list of members corresponding to the cluster, whose distance is from pivot smaller than
         threshold of the classifier.
+    :ivar order: order in which the cluster was created in its layer
     """
 
-    __slots__ = ["members", "pivot"]
+    __slots__ = ["members", "pivot", "order"]
 
-    def __init__(self, pivot: TraceClusterMember):
+    def __init__(self, pivot: TraceClusterMember, order: int = 0):
         """Creates empty cluster with single element
 
         :param pivot: initial pivot of the cluster
+        :param order: order in which the cluster was created in its layer
         """
         self.pivot: TraceClusterMember = pivot
         self.members: list[TraceClusterMember] = [pivot]
+        self.order: int = order
 
 
 class TraceClusterMember:
@@ -83,12 +110,18 @@ class TraceClassifierLayer:
     The layer utilizes its own cache for computing the distances. For computing costs of switching
     uids in the traces, we use the shared general cache.
 
+    The trace is compared only with pivots of similar length; if there are more than
+    :data:`MAX_CANDIDATES` of them, only the pivots with the most colliding bands of MinHash
+    signatures are compared.
+
     :ivar trace_to_cluster: mapping of traces (as strings) to their classified TraceClusters
     :ivar distance_cache: cache of the distances between two traces represented as floating point
     :ivar clusters: list of clusters in the layer
     :ivar find_cluster: function used to find appropriate cluster; this is set wrt strategy either
         as 'best-fit' or as 'first-fit'.
     :ivar threshold: threshold of the distances between vectors.
+    :ivar clusters_by_length: mapping of lengths of pivots to the clusters
+    :ivar band_index: mapping of bands of MinHash signatures of pivots to the clusters
     """
 
     __slots__ = [
@@ -97,6 +130,8 @@ class TraceClassifierLayer:
         "clusters",
         "find_cluster",
         "threshold",
+        "clusters_by_length",
+        "band_index",
     ]
 
     def __init__(
@@ -123,6 +158,8 @@ class TraceClassifierLayer:
                 [TraceClusterMember], TraceClusterMember
             ] = self.find_best_fit_cluster_for
         self.threshold: float = threshold
+        self.clusters_by_length: dict[int, list[TraceCluster]] = collections.defaultdict(list)
+        self.band_index: dict[tuple[int, ...], list[TraceCluster]] = collections.defaultdict(list)
 
     def classify_trace(self, trace: list[str]) -> TraceClusterMember:
         """For given trace return corresponding cluster
@@ -151,10 +188,10 @@ class TraceClassifierLayer:
     def find_first_fit_cluster_for(self, trace_member: TraceClusterMember) -> TraceClusterMember:
         """Finds first suitable cluster for the given trace
 
-        We iterate through all the clusters; we skip clusters, that are bigger than
-        the analysed traces wrt given threshold (no need to classify them, since
-        they will always have cost higher than the threshold). If we find some
-        cluster that is suitable, we return it.
+        We iterate through the candidate clusters (see :meth:`candidate_clusters_for`); we skip
+        clusters, that are bigger than the analysed traces wrt given threshold (no need to
+        classify them, since they will always have cost higher than the threshold). If we find
+        some cluster that is suitable, we return it.
 
         If no cluster is found, we create a new one.
 
@@ -165,64 +202,99 @@ class TraceClassifierLayer:
         :param trace_member: trace which we are classifying
         :return: classification of the traces
         """
-        trace_len = len(trace_member.as_list)
-        for cluster in self.clusters:
-            if abs(len(cluster.pivot.as_list) - trace_len) <= self.threshold:
-                fitness = fast_compute_distance(
-                    trace_member.as_list, cluster.pivot.as_list, self.threshold, self.distance_cache
-                )
-                if fitness <= self.threshold:
-                    cluster.members.append(trace_member)
-                    trace_member.parent = cluster
-                    trace_member.distance = fitness
-                    return cluster.pivot
+        for cluster in self.candidate_clusters_for(trace_member.as_list):
+            fitness = fast_compute_distance(
+                trace_member.as_list, cluster.pivot.as_list, self.threshold, self.distance_cache
+            )
+            if fitness <= self.threshold:
+                cluster.members.append(trace_member)
+                trace_member.parent = cluster
+                trace_member.distance = fitness
+                return cluster.pivot
 
         # We did not find any suitable cluster, hence we crate new one
-        new_cluster = TraceCluster(trace_member)
-        self.clusters.append(new_cluster)
-        trace_member.parent = new_cluster
-        return trace_member
+        return self.create_cluster_for(trace_member)
 
     def find_best_fit_cluster_for(self, trace_member: TraceClusterMember) -> TraceClusterMember:
         """Finds best fit cluster for the given trace
 
-        We iterate through all the clusters; we skip clusters, that are bigger than
-        the analysed traces wrt given threshold (no need to classify them, since
-        they will always have cost higher than the threshold). We then remember which
-        cluster had the best fit. This is finally returned.
+        We iterate through the candidate clusters (see :meth:`candidate_clusters_for`); we skip
+        clusters, that are bigger than the analysed traces wrt given threshold (no need to
+        classify them, since they will always have cost higher than the threshold). We then
+        remember which cluster had the best fit. This is finally returned.
 
         If no cluster is found, we create a new one.
 
-        Note: this finds the best cluster, however, if there is too much clusters, it might lead
-        to an excesive number of comparisons leading to high computational cost.
-
         :param trace_member: trace which we are classifying
         :return: classification of the traces
         """
         best_fit: Optional[TraceCluster] = None
         best_fit_distance = self.threshold
-        trace_len = len(trace_member.as_list)
-        for cluster in self.clusters:
-            if abs(len(cluster.pivot.as_list) - trace_len) <= self.threshold:
-                fitness = fast_compute_distance(
-                    trace_member.as_list, cluster.pivot.as_list, self.threshold, self.distance_cache
-                )
-                if fitness < best_fit_distance or (
-                    fitness == best_fit_distance and best_fit is None
-                ):
-                    best_fit = cluster
+        for cluster in self.candidate_clusters_for(trace_member.as_list):
+            fitness = fast_compute_distance(
+                trace_member.as_list, cluster.pivot.as_list, self.threshold, self.distance_cache
+            )
+            if fitness < best_fit_distance or (fitness == best_fit_distance and best_fit is None):
+                best_fit = cluster
+                best_fit_distance = fitness
         if not best_fit:
             # We did not find any suitable cluster, hence we crate new one
-            new_cluster = TraceCluster(trace_member)
-            self.clusters.append(new_cluster)
-            trace_member.parent = new_cluster
-            return trace_member
+            return self.create_cluster_for(trace_member)
         else:
             trace_member.parent = best_fit
             trace_member.distance = best_fit_distance
             best_fit.members.append(trace_member)
             return best_fit.pivot
 
+    def candidate_clusters_for(self, trace: list[str]) -> list[TraceCluster]:
+        """Returns the clusters, whose pivots should be compared with the trace
+
+        Only clusters with pivots of similar length (wrt the threshold) can fit the trace. If
+        there are at most :data:`MAX_CANDIDATES` of them, all of them are returned in the order
+        of their creation. Otherwise, only the clusters, whose pivots share some band of MinHash
+        signature with the trace, are returned, ordered by the number of shared bands.
+
+        :param trace: classified trace
+        :return: list of candidate clusters
+        """
+        trace_len = len(trace)
+        lengths = range(
+            max(trace_len - int(self.threshold), 0), trace_len + int(self.threshold) + 1
+        )
+        candidates = [
+            cluster
+            for length in lengths
+            if length in self.clusters_by_length
+            for cluster in self.clusters_by_length[length]
+        ]
+        if len(candidates) <= MAX_CANDIDATES:
+            return sorted(candidates, key=lambda cluster: cluster.order)
+
+        collisions: collections.Counter[TraceCluster] = collections.Counter()
+        for band in signature_bands(trace):
+            collisions.update(
+                cluster
+                for cluster in self.band_index.get(band, [])
+                if abs(len(cluster.pivot.as_list) - trace_len) <= self.threshold
+            )
+        return sorted(collisions, key=lambda cluster: (-collisions[cluster], cluster.order))[
+            :MAX_CANDIDATES
+        ]
+
+    def create_cluster_for(self, trace_member: TraceClusterMember) -> TraceClusterMember:
+        """Creates new cluster with the trace as its pivot and registers it in the indices
+
+        :param trace_member: pivot of the new cluster
+        :return: the pivot of the new cluster
+        """
+        new_cluster = TraceCluster(trace_member, len(self.clusters))
+        self.clusters.append(new_cluster)
+        self.clusters_by_length[len(trace_member.as_list)].append(new_cluster)
+        for band in signature_bands(trace_member.as_list):
+            self.band_index[band].append(new_cluster)
+        trace_member.parent = new_cluster
+        return trace_member
+
 
 class TraceClassifier:
     """Hierarchical classifier of traces
@@ -296,6 +368,40 @@ class TraceClassifier:
         return layer.classify_trace(trace)
 
 
+@functools.cache
+def shingle_hash(shingle: str) -> int:
+    """
+    :param shingle: frame or pair of frames joined by comma
+    :return: stable 32-bit hash of the shingle
+    """
+    return zlib.crc32(shingle.encode("utf-8"))
+
+
+def signature_bands(trace: list[str]) -> Iterable[tuple[int, ...]]:
+    """Computes the bands of MinHash signature of the trace
+
+    The trace is represented by the set of shingles: its frames and pairs of consecutive frames.
+    Each value of the signature is the minimum of one universal hash function over the shingles;
+    the probability that two traces have the same value equals to the Jaccard similarity of their
+    shingles. The signature is split into :data:`MINHASH_BANDS` bands, each identified by its
+    index and its :data:`MINHASH_ROWS` values.
+
+    :param trace: list of frames
+    :return: iterable of bands of the signature
+    """
+    shingles = [shingle_hash(frame) for frame in trace] + [
+        shingle_hash(f"{caller},{callee}") for (caller, callee) in zip(trace, trace[1:])
+    ]
+    multipliers, increments = _MINHASH_COEFFICIENTS
+    signature = (
+        (multipliers * np.array(shingles or [0], dtype=np.uint64) + increments) % _MINHASH_PRIME
+    ).min(axis=1)
+    return (
+        (band, *signature[band * MINHASH_ROWS : (band + 1) * MINHASH_ROWS].tolist())
+        for band in range(MINHASH_BANDS)
+    )
+
+
 @functools.cache
 def split_to_words(identifier: str) -> set[str]:
     """Splits identifier of function into list of words
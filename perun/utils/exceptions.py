@@ -379,6 +379,25 @@ class InvalidBinaryException(Exception):
         return self.msg
 
 
+class InvalidPerfDataException(Exception):
+    """Raised when the data recorded by perf cannot be read, because they are missing, malformed
+    or in format unsupported by the reader"""
+
+    __slots__ = ["filename", "reason"]
+
+    def __init__(self, filename: str, reason: str) -> None:
+        """
+        :param str filename: path to the recorded perf data
+        :param str reason: the reason why the data cannot be read
+        """
+        super().__init__("")
+        self.filename = filename
+        self.reason = reason
+
+    def __str__(self) -> str:
+        return f"Cannot read perf data '{self.filename}': {self.reason}"
+
+
 class SystemTapScriptCompilationException(Exception):
     """Raised when an error is encountered during the compilation of a SystemTap script"""
 
@@ -3,11 +3,15 @@
 In particular, it includes functions for working with:
 
   1. Processes: calling external processes or working with running processes;
-  2. Environment: getting information about environment, where Perun was run (such as the Python version).
-  3. Executables: getting information about executable files.
+  2. Environment: getting information about environment, where Perun was run (such as the Python version);
+  3. Executables: getting information about executable files;
+  4. Isolation: running concurrent processes on disjoint cpus and in their own cgroups;
+  5. Symbolization: resolving the addresses in ELF binaries to their functions and source lines.
 """
 
 import perun.utils.external.commands
 import perun.utils.external.environment
 import perun.utils.external.executable
+import perun.utils.external.isolation
 import perun.utils.external.processes
+import perun.utils.external.symbolization
@@ -0,0 +1,293 @@
+"""Isolation of concurrently running processes on disjoint cpus, NUMA nodes and cgroups.
+
+The repetitions of the measurements can run concurrently on many-core machines, as long as they
+do not interfere with each other. Each concurrent slot is hence placed on its own set of cpus,
+which are taken from a single NUMA node whenever there are at least as many nodes as slots (so
+the memory of the processes, which is allocated on the node of the cpu that first touches it, is
+local to the slot), and the processes of the slot can be further limited by their own cgroup.
+
+Only the unified hierarchy (cgroup v2) is supported, and the cgroups are created as siblings of
+the leaf cgroup, to which the current process is moved from its original cgroup; hence the
+original cgroup has to be delegated to the user and must not contain further processes.
+"""
+from __future__ import annotations
+
+# Standard Imports
+from typing import Any, Callable, Iterable, Iterator, Optional, TypeVar
+import concurrent.futures
+import contextlib
+import dataclasses
+import glob
+import os
+import re
+
+# Third-Party Imports
+
+# Perun Imports
+from perun.utils import exceptions, log
+from perun.utils.external import processes
+
+
+T = TypeVar("T")
+NODE_CPU_LISTS: str = "/sys/devices/system/node/node*/cpulist"
+CGROUP_ROOT: str = "/sys/fs/cgroup"
+# Period of the cpu bandwidth control of cgroups in microseconds
+CPU_PERIOD: int = 100000
+
+
+@dataclasses.dataclass(frozen=True)
+class Placement:
+    """Placement of one concurrent slot of the repetitions
+
+    :ivar int slot: index of the slot
+    :ivar frozenset cpus: cpus, to which the processes of the slot are pinned
+    :ivar int node: NUMA node, whose cpus are used (None if the cpus span several nodes)
+    """
+
+    __slots__ = ["slot", "cpus", "node"]
+
+    slot: int
+    cpus: frozenset[int]
+    node: Optional[int]
+
+    def to_resource(self, cgroup: Optional[CGroup] = None) -> dict[str, Any]:
+        """
+        :param CGroup cgroup: cgroup, in which the processes of the slot run
+        :return: properties of resources describing the placement of the run
+        """
+        placement: dict[str, Any] = {"slot": self.slot, "cpus": format_cpu_list(self.cpus)}
+        if self.node is not None:
+            placement["numa-node"] = self.node
+        if cgroup is not None and cgroup.path is not None:
+            placement["cgroup"] = os.path.basename(cgroup.path)
+        return placement
+
+
+def format_cpu_list(cpus: Iterable[int]) -> str:
+    """Formats the cpus in the format of ``taskset`` and ``/sys`` (e.g. ``0-3,8``)
+
+    :param iterable cpus: formatted cpus
+    :return: comma separated cpus and ranges of consecutive cpus
+    """
+    ranges: list[list[int]] = []
+    for cpu in sorted(set(cpus)):
+        if ranges and ranges[-1][1] == cpu - 1:
+            ranges[-1][1] = cpu
+        else:
+            ranges.append([cpu, cpu])
+    return ",".join(str(first) if first == last else f"{first}-{last}" for first, last in ranges)
+
+
+def numa_nodes(cpus: Optional[Iterable[int]] = None) -> dict[int, set[int]]:
+    """Finds the NUMA nodes of the cpus
+
+    :param iterable cpus: available cpus (the affinity of the current process if None)
+    :return: map of the NUMA nodes to their available cpus (the cpus of unknown nodes are
+        mapped to -1)
+    """
+    available = set(cpus) if cpus is not None else set(os.sched_getaffinity(0))
+    nodes: dict[int, set[int]] = {}
+    for cpu_list in glob.glob(NODE_CPU_LISTS):
+        node = re.search(r"node(\d+)", cpu_list)
+        with open(cpu_list, "r") as cpu_list_handle:
+            node_cpus = processes.parse_cpu_list(cpu_list_handle.read()) & available
+        if node and node_cpus:
+            nodes[int(node.group(1))] = node_cpus
+    covered = set().union(*nodes.values())
+    if covered != available:
+        # The cpus of unknown nodes (e.g. when the topology cannot be read) have no node
+        return nodes | {-1: available - covered}
+    return nodes
+
+
+def split_to_placements(slots: int, cpus: Optional[Iterable[int]] = None) -> list[Placement]:
+    """Splits the cpus to disjoint placements of the slots
+
+    The slots are spread over the NUMA nodes, and the cpus of each node are split evenly among
+    its slots. If there are more slots than cpus, then the slots share the cpus.
+
+    :param int slots: number of concurrent slots
+    :param iterable cpus: available cpus (the affinity of the current process if None)
+    :return: placement for each of the slots
+    """
+    nodes = sorted(numa_nodes(cpus).items())
+    slots_of_nodes: list[list[int]] = [[] for _ in nodes]
+    for slot in range(slots):
+        slots_of_nodes[slot % len(nodes)].append(slot)
+    placements = []
+    for (node, node_cpus), node_slots in zip(nodes, slots_of_nodes):
+        ordered = sorted(node_cpus)
+        for index, slot in enumerate(node_slots):
+            if len(node_slots) >= len(ordered):
+                slot_cpus = {ordered[index % len(ordered)]}
+            else:
+                begin = index * len(ordered) // len(node_slots)
+                slot_cpus = set(ordered[begin : (index + 1) * len(ordered) // len(node_slots)])
+            placements.append(Placement(slot, frozenset(slot_cpus), node if node >= 0 else None))
+    return sorted(placements, key=lambda placement: placement.slot)
+
+
+class CGroup:
+    """Cgroup of one slot limiting the resources of its processes (see :func:`slot_cgroups`)
+
+    The processes join the cgroup before they execute their command (see
+    :func:`perun.utils.external.processes.run_measured`), so they never run unlimited.
+
+    :ivar str name: name of the cgroup
+    :ivar str path: path to the cgroup (None if it was not created)
+    :ivar dict limits: map of the interface files of the cgroup to their written values
+    """
+
+    __slots__ = ["name", "path", "limits"]
+
+    def __init__(self, name: str, limits: dict[str, str]) -> None:
+        """
+        :param str name: name of the cgroup
+        :param dict limits: map of the interface files of the cgroup to their written values
+        """
+        self.name = name
+        self.path: Optional[str] = None
+        self.limits = limits
+
+    def create(self, parent: str) -> None:
+        """Creates the cgroup with the limits
+
+        :param str parent: path to the parent cgroup, which has the limiting controllers enabled
+        """
+        self.path = os.path.join(parent, self.name)
+        os.mkdir(self.path)
+        for limit, value in self.limits.items():
+            _write_interface_file(os.path.join(self.path, limit), value)
+
+    def remove(self) -> None:
+        """Removes the cgroup, once all of its processes finished"""
+        if self.path is not None:
+            with exceptions.SuppressedExceptions(OSError):
+                os.rmdir(self.path)
+            self.path = None
+
+
+def cgroup_limits(memory_limit: Optional[str], cpu_limit: Optional[float]) -> dict[str, str]:
+    """
+    :param str memory_limit: maximal memory of the processes (e.g. 512M)
+    :param float cpu_limit: maximal number of cpus used by the processes (e.g. 1.5)
+    :return: map of the interface files of cgroup to the values setting the limits
+    """
+    limits: dict[str, str] = {}
+    if memory_limit is not None:
+        limits["memory.max"] = memory_limit
+    if cpu_limit is not None:
+        limits["cpu.max"] = f"{int(cpu_limit * CPU_PERIOD)} {CPU_PERIOD}"
+    return limits
+
+
+def current_cgroup() -> str:
+    """
+    :return: path to the cgroup of the current process in the unified hierarchy
+    :raises OSError: if the unified hierarchy (cgroup v2) is not available
+    """
+    with open("/proc/self/cgroup", "r") as cgroup_handle:
+        current = [line[3:].strip() for line in cgroup_handle if line.startswith("0::")]
+    path = os.path.join(CGROUP_ROOT, current[0].lstrip("/")) if current else CGROUP_ROOT
+    if not os.path.exists(os.path.join(path, "cgroup.controllers")):
+        raise OSError("cgroup v2 is not available")
+    return path
+
+
+@contextlib.contextmanager
+def slot_cgroups(
+    name: str, slots: int, memory_limit: Optional[str] = None, cpu_limit: Optional[float] = None
+) -> Iterator[list[CGroup]]:
+    """Creates the cgroups of the slots, each limiting the resources of the processes of its slot
+
+    The controllers cannot be enabled for the children of cgroup, which contains processes (the
+    no internal process rule of cgroup v2). Hence, the current process is first moved to its own
+    leaf cgroup, the controllers are enabled in its original cgroup, and the cgroups of the slots
+    are created as siblings of the leaf. All of this is reverted, once the context is left.
+
+    If the cgroups cannot be created (e.g. the cgroup v2 is not mounted or delegated, or the
+    original cgroup contains further processes), then a warning is issued and the processes are
+    not limited. The cgroups are not created at all, if there are no limits.
+
+    :param str name: prefix of the names of the created cgroups
+    :param int slots: number of the slots
+    :param str memory_limit: maximal memory of the processes of each slot (e.g. 512M)
+    :param float cpu_limit: maximal number of cpus used by the processes of each slot (e.g. 1.5)
+    :return: cgroup of each slot
+    """
+    limits = cgroup_limits(memory_limit, cpu_limit)
+    cgroups = [CGroup(f"{name}-{slot}", limits) for slot in range(slots)]
+    parent, leaf, enabled = "", "", ""
+    try:
+        if limits:
+            parent = current_cgroup()
+            controllers = {limit.split(".")[0] for limit in limits}
+            with open(os.path.join(parent, "cgroup.controllers"), "r") as controllers_handle:
+                missing = controllers - set(controllers_handle.read().split())
+            if missing:
+                raise OSError(f"controllers {', '.join(sorted(missing))} are not available")
+            leaf_path = os.path.join(parent, f"{name}-main")
+            os.mkdir(leaf_path)
+            leaf = leaf_path
+            _write_interface_file(os.path.join(leaf, "cgroup.procs"), str(os.getpid()))
+            subtree_control = os.path.join(parent, "cgroup.subtree_control")
+            with open(subtree_control, "r") as subtree_handle:
+                to_enable = sorted(controllers - set(subtree_handle.read().split()))
+            if to_enable:
+                _write_interface_file(subtree_control, " ".join(f"+{c}" for c in to_enable))
+                enabled = " ".join(f"-{c}" for c in to_enable)
+            for cgroup in cgroups:
+                cgroup.create(parent)
+    except OSError as exc:
+        log.warn(f"cannot limit the resources by cgroups ({exc}), running unlimited")
+        for cgroup in cgroups:
+            cgroup.remove()
+    try:
+        yield cgroups
+    finally:
+        for cgroup in cgroups:
+            cgroup.remove()
+        with exceptions.SuppressedExceptions(OSError):
+            if enabled:
+                _write_interface_file(os.path.join(parent, "cgroup.subtree_control"), enabled)
+            if leaf:
+                _write_interface_file(os.path.join(parent, "cgroup.procs"), str(os.getpid()))
+                os.rmdir(leaf)
+
+
+def _write_interface_file(path: str, value: str) -> None:
+    """Writes the value to the interface file of cgroup
+
+    :param str path: path to the interface file
+    :param str value: written value
+    """
+    with open(path, "w") as interface_handle:
+        interface_handle.write(value)
+
+
+def run_in_placements(
+    placements: list[Placement], repetitions: int, task: Callable[[Placement, int], T]
+) -> list[T]:
+    """Runs the repetitions of the task concurrently, each slot pinned to its placement
+
+    The repetitions are assigned to the slots in the round-robin fashion, and the repetitions
+    of each slot run one after another. Since the task runs in its own thread, and the affinity
+    is set for the calling thread only, the processes spawned by the task inherit its placement.
+
+    :param list placements: placements of the concurrent slots
+    :param int repetitions: number of repetitions of the task
+    :param callable task: runs the repetition (with the given order) in the given placement
+    :return: results of the repetitions in their order
+    """
+    results: list[Optional[T]] = [None] * repetitions
+
+    def run_slot(placement: Placement) -> None:
+        """Runs the repetitions of the slot"""
+        with processes.pinned_to_cpus(placement.cpus):
+            for order in range(placement.slot, repetitions, len(placements)):
+                results[order] = task(placement, order)
+
+    with concurrent.futures.ThreadPoolExecutor(max_workers=len(placements)) as executor:
+        for future in [executor.submit(run_slot, placement) for placement in placements]:
+            future.result()
+    return results  # type: ignore
@@ -1,14 +1,22 @@
 """Helper functions for working with processes
 
-Currently, this contains working with nonblocking subprocesses
+Currently, this contains working with nonblocking subprocesses, pinning of processes to cpus and
+measuring of the resources used by processes.
 """
 from __future__ import annotations
 
 # Standard Imports
-from typing import Any, Optional, Callable, Iterator
+from typing import Any, Optional, Callable, Iterable, Iterator
 import contextlib
+import dataclasses
+import os
+import resource
 import subprocess
 import shlex
+import sys
+import threading
+import time
+import weakref
 
 # Third-Party Imports
 
@@ -58,3 +66,323 @@ def nonblocking_subprocess(
                     if termination_kwargs is None:
                         termination_kwargs = {}
                     termination(**termination_kwargs)
+
+
+@dataclasses.dataclass(frozen=True)
+class ProcessUsage:
+    """Resources used by one finished process, as reported by the kernel
+
+    :ivar int wall_time: elapsed wall time of the process in nanoseconds
+    :ivar float user_time: time spent in the user mode in seconds
+    :ivar float system_time: time spent in the kernel mode in seconds
+    :ivar int max_rss: maximum resident set size in kilobytes or None, if it is unknown; note
+        that the kernel accounts the memory of the spawning process to its child until the child
+        executes the command, hence the size is known only if it exceeds the peak resident set
+        size of the spawning process (see :class:`MeasuringSpawner`)
+    :ivar int voluntary_switches: number of context switches, when the process waited
+    :ivar int involuntary_switches: number of context switches, when the process was preempted
+    :ivar int minor_faults: number of page faults serviced without any I/O
+    :ivar int major_faults: number of page faults, which required I/O
+    :ivar int exit_code: exit code of the process (128 + number of the signal if killed by the
+        signal, as reported by shells and the time utility)
+    """
+
+    __slots__ = [
+        "wall_time",
+        "user_time",
+        "system_time",
+        "max_rss",
+        "voluntary_switches",
+        "involuntary_switches",
+        "minor_faults",
+        "major_faults",
+        "exit_code",
+    ]
+
+    wall_time: int
+    user_time: float
+    system_time: float
+    max_rss: Optional[int]
+    voluntary_switches: int
+    involuntary_switches: int
+    minor_faults: int
+    major_faults: int
+    exit_code: int
+
+
+def parse_cpu_list(cpu_list: str) -> set[int]:
+    """Parses the list of cpus in the format of ``taskset`` and ``/sys`` (e.g. ``0-3,8``)
+
+    :param str cpu_list: comma separated cpus or ranges of cpus
+    :return: set of the listed cpus
+    :raises ValueError: if the list is malformed
+    """
+    cpus: set[int] = set()
+    for part in filter(None, (part.strip() for part in cpu_list.split(","))):
+        first, _, last = part.partition("-")
+        cpus.update(range(int(first), int(last or first) + 1))
+    return cpus
+
+
+@contextlib.contextmanager
+def pinned_to_cpus(cpus: Optional[Iterable[int]]) -> Iterator[None]:
+    """Temporarily pins the current process to the cpus, so the spawned processes inherit them
+
+    If no cpus are given, or the affinity cannot be set on the platform, nothing is pinned.
+
+    :param iterable cpus: cpus, to which the process is pinned
+    """
+    cpus = set(cpus or ())
+    if not cpus or not hasattr(os, "sched_setaffinity"):
+        yield
+        return
+    original_cpus = os.sched_getaffinity(0)
+    os.sched_setaffinity(0, cpus)
+    try:
+        yield
+    finally:
+        os.sched_setaffinity(0, original_cpus)
+
+
+# Source of the helper process, which spawns the measured commands (see MeasuringSpawner). It
+# reads the requests (working directory, cpus and arguments separated by zero bytes) from the
+# first and writes the used resources of the commands to the second of the passed descriptors.
+_SPAWNER_SOURCE = """
+import os, resource, sys, time
+requests, replies = os.fdopen(int(sys.argv[1]), "rb"), os.fdopen(int(sys.argv[2]), "w", 1)
+os.set_inheritable(requests.fileno(), False)
+os.set_inheritable(replies.fileno(), False)
+discard_output = [(os.POSIX_SPAWN_OPEN, fd, os.devnull, os.O_WRONLY, 0) for fd in (1, 2)]
+for request in requests:
+    cwd, cpus, *args = request[:-1].split(b"\\0")
+    try:
+        os.chdir(cwd)
+        if cpus:
+            os.sched_setaffinity(0, [int(cpu) for cpu in cpus.split(b",")])
+        start = time.perf_counter_ns()
+        pid = os.posix_spawnp(args[0], args, os.environ, file_actions=discard_output)
+    except OSError as exc:
+        replies.write(f"error {exc.errno or 0} {exc.strerror}\\n")
+        continue
+    _, status, usage = os.wait4(pid, 0)
+    wall_time = time.perf_counter_ns() - start
+    # The peak of the memory of the helper itself (its ru_maxrss contains the peak of perun)
+    try:
+        with open("/proc/self/status") as proc_status:
+            spawner_max_rss = next(int(ln.split()[1]) for ln in proc_status if "VmHWM" in ln)
+    except (OSError, StopIteration):
+        spawner_max_rss = resource.getrusage(resource.RUSAGE_SELF).ru_maxrss
+    replies.write(" ".join(map(str, (
+        "ok", wall_time, os.waitstatus_to_exitcode(status), usage.ru_utime, usage.ru_stime,
+        usage.ru_maxrss, usage.ru_nvcsw, usage.ru_nivcsw, usage.ru_minflt, usage.ru_majflt,
+        spawner_max_rss,
+    ))) + "\\n")
+"""
+
+
+class MeasuringSpawner:
+    """Small long-lived helper process, which spawns the measured commands
+
+    The kernel accounts the peak memory of the spawning process to its child, hence if the
+    commands were spawned directly by perun (which has its own peak of ~100MB with all its
+    dependencies), their maximum resident set size would be unknown for most of the commands.
+    The helper is a bare python interpreter, whose peak is only few megabytes.
+
+    :ivar Popen process: the helper process
+    :ivar file requests: pipe, through which the commands are sent to the helper
+    :ivar file replies: pipe, through which the used resources are received from the helper
+    :ivar int owner: pid of the process that started the helper (forked children start their own)
+    :ivar dict environment: environment of the helper (it is restarted, if the environment changes)
+    """
+
+    __slots__ = ["process", "requests", "replies", "owner", "environment", "__weakref__"]
+
+    def __init__(self) -> None:
+        """Starts the helper process
+
+        :raises OSError: if the helper cannot be started
+        """
+        request_read, request_write = os.pipe()
+        reply_read, reply_write = os.pipe()
+        try:
+            self.process = subprocess.Popen(
+                [sys.executable, "-I", "-S", "-c", _SPAWNER_SOURCE]
+                + [str(request_read), str(reply_write)],
+                pass_fds=(request_read, reply_write),
+            )
+        except OSError:
+            os.close(request_write)
+            os.close(reply_read)
+            raise
+        finally:
+            # The ends of the helper are not needed in perun
+            os.close(request_read)
+            os.close(reply_write)
+        self.requests = os.fdopen(request_write, "wb")
+        self.replies = os.fdopen(reply_read, "r")
+        self.owner = os.getpid()
+        self.environment = dict(os.environ)
+        weakref.finalize(self, MeasuringSpawner._stop, self.process, self.requests, self.replies)
+
+    @staticmethod
+    def _stop(process: subprocess.Popen[bytes], requests: Any, replies: Any) -> None:
+        """Stops the helper process by closing its pipes
+
+        :param Popen process: the helper process
+        :param file requests: pipe of the requests
+        :param file replies: pipe of the replies
+        """
+        with contextlib.suppress(OSError):
+            requests.close()
+            replies.close()
+        with contextlib.suppress(subprocess.TimeoutExpired):
+            process.wait(timeout=5)
+
+    def is_usable(self) -> bool:
+        """
+        :return: true if the helper runs, belongs to this process and has the current environment
+        """
+        return (
+            self.owner == os.getpid()
+            and self.process.poll() is None
+            and self.environment == os.environ
+        )
+
+    def spawn(self, args: list[str], cpus: set[int]) -> tuple[float, ...]:
+        """Spawns the command by the helper and waits for its resources
+
+        :param list args: arguments of the command
+        :param set cpus: cpus, to which the command is pinned (not pinned if empty)
+        :return: wall time, exit code, user time, system time, max rss, voluntary and involuntary
+            switches, minor and major faults of the command and the peak memory of the helper
+        :raises OSError: if the command cannot be spawned, or the helper does not respond
+        """
+        fields = [os.getcwd(), ",".join(map(str, sorted(cpus)))] + args
+        self.requests.write(b"\0".join(map(os.fsencode, fields)) + b"\n")
+        self.requests.flush()
+        reply = self.replies.readline()
+        if not reply:
+            raise BrokenPipeError("the spawner of measured commands terminated")
+        status, _, values = reply.partition(" ")
+        if status == "error":
+            error_number, _, message = values.partition(" ")
+            raise OSError(int(error_number), message.strip(), args[0])
+        return tuple(float(value) if "." in value else int(value) for value in values.split())
+
+
+_SPAWNERS = threading.local()
+
+
+def _spawn_by_helper(args: list[str], cpus: set[int]) -> Optional[tuple[float, ...]]:
+    """Spawns the command by the spawner of the current thread (see :class:`MeasuringSpawner`)
+
+    :param list args: arguments of the command
+    :param set cpus: cpus, to which the command is pinned (not pinned if empty)
+    :return: used resources of the command (see :meth:`MeasuringSpawner.spawn`) or None, if the
+        spawner is not available
+    :raises OSError: if the command cannot be spawned
+    """
+    spawner = getattr(_SPAWNERS, "spawner", None)
+    try:
+        if spawner is None or not spawner.is_usable():
+            spawner = _SPAWNERS.spawner = MeasuringSpawner()
+        return spawner.spawn(args, cpus)
+    except (BrokenPipeError, ValueError, IndexError):
+        _SPAWNERS.spawner = None
+        return None
+    except OSError as exc:
+        if exc.filename is None:
+            # The helper itself cannot be started or used
+            _SPAWNERS.spawner = None
+            return None
+        raise
+
+
+def _spawn_directly(args: list[str], cpus: set[int]) -> tuple[float, ...]:
+    """Spawns the command directly by perun
+
+    :param list args: arguments of the command
+    :param set cpus: cpus, to which the command is pinned (not pinned if empty)
+    :return: used resources of the command (see :meth:`MeasuringSpawner.spawn`)
+    :raises OSError: if the command cannot be spawned
+    """
+    discard_output = [(os.POSIX_SPAWN_OPEN, fd, os.devnull, os.O_WRONLY, 0) for fd in (1, 2)]
+    with pinned_to_cpus(cpus):
+        start = time.perf_counter_ns()
+        pid = os.posix_spawnp(args[0], args, os.environ, file_actions=discard_output)
+    _, status, usage = os.wait4(pid, 0)
+    wall_time = time.perf_counter_ns() - start
+    return (
+        wall_time,
+        os.waitstatus_to_exitcode(status),
+        usage.ru_utime,
+        usage.ru_stime,
+        usage.ru_maxrss,
+        usage.ru_nvcsw,
+        usage.ru_nivcsw,
+        usage.ru_minflt,
+        usage.ru_majflt,
+        resource.getrusage(resource.RUSAGE_SELF).ru_maxrss,
+    )
+
+
+def run_measured(
+    command: str,
+    cpus: Optional[Iterable[int]] = None,
+    check: bool = True,
+    cgroup: Optional[str] = None,
+) -> ProcessUsage:
+    """Runs the command without shell and measures the resources it used
+
+    The command is spawned by ``posix_spawn`` (without the overhead of any wrapper, such as the
+    ``time`` utility) with its output discarded, and its resources are collected by ``wait4``;
+    the wall time is measured by the monotonic clock with nanosecond resolution. The command is
+    spawned by the small helper process (see :class:`MeasuringSpawner`), so the peak memory of
+    perun is not accounted to it; only if the helper cannot be used, perun spawns it directly.
+
+    :param str command: the measured command
+    :param iterable cpus: cpus, to which the command is pinned (not pinned if empty)
+    :param bool check: if set to true, then the non-zero exit code raises exception
+    :param str cgroup: path to the cgroup, which the spawned process joins before it executes
+        the command (by a minimal shell), so the command never runs outside of it
+    :return: resources used by the command
+    :raises subprocess.CalledProcessError: if the command fails and @p check is set
+    :raises OSError: if the command cannot be spawned
+    """
+    args = shlex.split(command)
+    if cgroup is not None:
+        args = ["sh", "-c", 'echo 0 > "$0/cgroup.procs" && exec "$@"', cgroup] + args
+    if cpus:
+        spawned_cpus = set(cpus)
+    else:
+        # The command inherits the cpus of the calling thread (e.g. of its slot)
+        spawned_cpus = os.sched_getaffinity(0) if hasattr(os, "sched_getaffinity") else set()
+    measured = _spawn_by_helper(args, spawned_cpus) or _spawn_directly(args, set(cpus or ()))
+    (
+        wall_time,
+        exit_code,
+        user_time,
+        system_time,
+        max_rss,
+        voluntary_switches,
+        involuntary_switches,
+        minor_faults,
+        major_faults,
+        spawner_max_rss,
+    ) = measured
+    exit_code = int(128 - exit_code if exit_code < 0 else exit_code)
+    if check and exit_code != 0:
+        raise subprocess.CalledProcessError(exit_code, command)
+    # The peak of the spawning process is accounted to the child as well, hence smaller sizes
+    # cannot be attributed to the command
+    return ProcessUsage(
+        int(wall_time),
+        user_time,
+        system_time,
+        int(max_rss) if max_rss > spawner_max_rss else None,
+        int(voluntary_switches),
+        int(involuntary_switches),
+        int(minor_faults),
+        int(major_faults),
+        exit_code,
+    )
@@ -0,0 +1,902 @@
+"""Symbolization of the addresses in the ELF binaries shared by the collectors.
+
+The function symbols of the binary and the line table of its DWARF debug information are read
+only once, and are indexed by their address ranges: the starting addresses of the ranges are
+stored in a sorted flat array, so each address is resolved by a single binary search. Since the
+parsing of the line tables is the most expensive part of the symbolization, the indexed tables
+are cached on disk under the build-id of the binary, and are reused by any later collection
+(of any collector) that profiles the same build.
+
+Only the little endian binaries are supported. Binaries without the build-id are symbolized
+each time they are loaded, and the binaries without the line table resolve only the functions.
+"""
+from __future__ import annotations
+
+# Standard Imports
+from typing import Any, Optional
+import array
+import bisect
+import mmap
+import os
+import struct
+import subprocess
+import tempfile
+import zlib
+
+# Third-Party Imports
+
+# Perun Imports
+from perun.utils import exceptions
+
+
+CACHE_MAGIC: bytes = b"PERUNSYM"
+# Version of the cache format; the caches of other versions are ignored and rewritten
+CACHE_VERSION: int = 1
+# File of the ranges of the line table, which are not covered by any sequence
+NO_FILE: int = -1
+
+# ELF constants
+PT_LOAD: int = 1
+SHT_SYMTAB: int = 2
+SHT_NOTE: int = 7
+SHT_DYNSYM: int = 11
+SHF_COMPRESSED: int = 0x800
+NT_GNU_BUILD_ID: int = 3
+# STT_FUNC and STT_GNU_IFUNC symbols
+FUNCTION_TYPES: tuple[int, ...] = (2, 10)
+
+# DWARF attributes, contents of the entries of the line tables and forms read by the collectors
+DW_AT_STMT_LIST: int = 0x10
+DW_AT_COMP_DIR: int = 0x1B
+DW_LNCT_PATH: int = 1
+DW_LNCT_DIRECTORY_INDEX: int = 2
+DW_FORM_STRING: int = 0x08
+DW_FORM_STRP: int = 0x0E
+DW_FORM_LINE_STRP: int = 0x1F
+DW_FORM_INDIRECT: int = 0x16
+DW_FORM_IMPLICIT_CONST: int = 0x21
+# Forms encoded as unsigned and signed LEB128 numbers, and forms of blocks with LEB128 size
+ULEB_FORMS: tuple[int, ...] = (0x0F, 0x15, 0x1A, 0x1B, 0x22, 0x23)
+SLEB_FORMS: tuple[int, ...] = (0x0D,)
+BLOCK_FORMS: tuple[int, ...] = (0x09, 0x18)
+# Sizes of the fixed size forms (and of the sizes of blocks), with the forms of the size of
+# addresses and offsets marked by ADDRESS_SIZE and OFFSET_SIZE
+ADDRESS_SIZE: int = -1
+OFFSET_SIZE: int = -2
+FORM_SIZES: dict[int, int] = {
+    0x01: ADDRESS_SIZE,
+    0x05: 2,
+    0x06: 4,
+    0x07: 8,
+    0x0B: 1,
+    0x0C: 1,
+    0x10: OFFSET_SIZE,
+    0x11: 1,
+    0x12: 2,
+    0x13: 4,
+    0x14: 8,
+    0x17: OFFSET_SIZE,
+    0x19: 0,
+    0x1C: 4,
+    0x1D: OFFSET_SIZE,
+    0x1E: 16,
+    0x20: 8,
+    0x21: 0,
+    0x24: 8,
+    0x25: 1,
+    0x26: 2,
+    0x27: 3,
+    0x28: 4,
+    0x29: 1,
+    0x2A: 2,
+    0x2B: 3,
+    0x2C: 4,
+}
+BLOCK_SIZE_FORMS: dict[int, int] = {0x0A: 1, 0x03: 2, 0x04: 4}
+
+# Symbols loaded by this process, keyed by the paths, modification times and sizes of binaries
+_LOADED: dict[tuple[str, int, int], Optional[BinarySymbols]] = {}
+
+
+class BinarySymbols:
+    """Functions and source lines of the ELF binary indexed by their address ranges
+
+    :ivar str path: path to the binary
+    :ivar str build_id: build-id of the binary in hex (empty if the binary has none)
+    :ivar list segments: loadable segments as triples of file offset, size and virtual address
+    :ivar list symbols: defined function symbols as triples of address, size and name, in the
+        order of the symbol table (including the aliases of the same function)
+    :ivar array function_starts: sorted starting addresses of the functions
+    :ivar array function_ends: ending addresses of the functions
+    :ivar list function_names: names of the functions
+    :ivar list demangled_names: demangled names of the functions (None until they are needed)
+    :ivar array line_starts: sorted starting addresses of the ranges of the line table
+    :ivar array line_files: source file of each range (:data:`NO_FILE` if it is not covered)
+    :ivar array line_numbers: source line of each range
+    :ivar list files: paths of the source files
+    """
+
+    __slots__ = [
+        "path",
+        "build_id",
+        "segments",
+        "symbols",
+        "function_starts",
+        "function_ends",
+        "function_names",
+        "demangled_names",
+        "line_starts",
+        "line_files",
+        "line_numbers",
+        "files",
+    ]
+
+    # Formats of the header (from e_type), program header, section header and symbol
+    _FORMATS = {
+        1: ("<HHIIIIIHHHHHH", "<IIIIIIII", "<IIIIIIIIII", "<IIIBBH"),
+        2: ("<HHIQQQIHHHHHH", "<IIQQQQQQ", "<IIQQQQIIQQ", "<IBBHQQ"),
+    }
+
+    def __init__(self, path: str, use_cache: bool = True) -> None:
+        """Reads the symbols of the binary, or loads them from the cache of its build
+
+        :param str path: path to the binary
+        :param bool use_cache: if set to false, the cache is neither read, nor written
+        :raises OSError: if the binary cannot be read
+        :raises ValueError: if the binary is not a supported ELF file
+        """
+        self.path = path
+        self.build_id = ""
+        self.segments: list[tuple[int, int, int]] = []
+        self.symbols: list[tuple[int, int, str]] = []
+        self.function_starts: array.array[int] = array.array("Q")
+        self.function_ends: array.array[int] = array.array("Q")
+        self.function_names: list[str] = []
+        self.demangled_names: Optional[list[str]] = None
+        self.line_starts: array.array[int] = array.array("Q")
+        self.line_files: array.array[int] = array.array("i")
+        self.line_numbers: array.array[int] = array.array("I")
+        self.files: list[str] = []
+        with open(path, "rb") as binary, mmap.mmap(
+            binary.fileno(), 0, access=mmap.ACCESS_READ
+        ) as data:
+            try:
+                headers = self._read_headers(data)
+                cache = cache_path(self.build_id) if use_cache and self.build_id else None
+                if cache is None or not self._load_cache(cache):
+                    self._read_symbols(data, headers)
+                    self._read_line_table(data, headers)
+                    if cache is not None:
+                        self._store_cache(cache)
+            except (struct.error, IndexError, zlib.error) as exc:
+                raise ValueError(str(exc))
+        self._index_functions()
+
+    def _read_headers(self, data: mmap.mmap) -> list[tuple[Any, ...]]:
+        """Reads the loadable segments, the build-id and the headers of the sections
+
+        :param mmap data: contents of the binary
+        :return: headers of the sections
+        """
+        if data[:4] != b"\x7fELF" or data[5] != 1 or data[4] not in self._FORMATS:
+            raise ValueError("not a little endian ELF file")
+        header, program_header, section_header, _ = self._FORMATS[data[4]]
+        is_64bit = data[4] == 2
+        fields = struct.unpack_from(header, data, 16)
+        phoff, shoff, phentsize, phnum, shentsize, shnum, shstrndx = fields[4:6] + fields[8:]
+
+        for i in range(phnum):
+            fields = struct.unpack_from(program_header, data, phoff + i * phentsize)
+            # 64bit headers have the flags right after the type
+            if fields[0] == PT_LOAD and is_64bit:
+                self.segments.append((fields[2], fields[5], fields[3]))
+            elif fields[0] == PT_LOAD:
+                self.segments.append((fields[1], fields[4], fields[2]))
+
+        headers = [
+            struct.unpack_from(section_header, data, shoff + i * shentsize) for i in range(shnum)
+        ]
+        for section in headers:
+            if section[1] == SHT_NOTE and not self.build_id:
+                self.build_id = _find_build_id(data[section[4] : section[4] + section[5]])
+        # The names of the sections are appended to their headers
+        names_offset = headers[shstrndx][4] if shstrndx < shnum else 0
+        return [
+            section
+            + (data[names_offset + section[0] : data.find(b"\0", names_offset + section[0])],)
+            for section in headers
+        ]
+
+    def _read_symbols(self, data: mmap.mmap, headers: list[tuple[Any, ...]]) -> None:
+        """Reads the function symbols from the ``.symtab`` (or ``.dynsym`` if it is stripped)
+
+        :param mmap data: contents of the binary
+        :param list headers: headers of the sections (with their names)
+        """
+        symbol = self._FORMATS[data[4]][3]
+        is_64bit = data[4] == 2
+        tables = [s for s in headers if s[1] == SHT_SYMTAB] or [
+            s for s in headers if s[1] == SHT_DYNSYM
+        ]
+        for table in tables:
+            _, _, _, _, offset, size, link, _, _, entsize, _ = table
+            strings = headers[link][4]
+            for entry in struct.iter_unpack(symbol, data[offset : offset + size - size % entsize]):
+                if is_64bit:
+                    name, info, _, shndx, value, sym_size = entry
+                else:
+                    name, value, sym_size, info, _, shndx = entry
+                if info & 0xF in FUNCTION_TYPES and shndx != 0:
+                    end = data.find(b"\0", strings + name)
+                    name = data[strings + name : end].decode(errors="replace")
+                    self.symbols.append((value, sym_size, name))
+
+    def _read_line_table(self, data: mmap.mmap, headers: list[tuple[Any, ...]]) -> None:
+        """Runs the line programs of all units of ``.debug_line`` and indexes their rows
+
+        Each row of the line table starts the range of addresses, which ends at the next row;
+        the ends of the sequences start the ranges, which are not covered by any source line.
+        The line tables in unsupported formats are skipped.
+
+        :param mmap data: contents of the binary
+        :param list headers: headers of the sections (with their names)
+        """
+        debug_line = _section_data(data, headers, b".debug_line")
+        if not debug_line:
+            return
+        program = LineProgram(
+            debug_line,
+            _section_data(data, headers, b".debug_info"),
+            _section_data(data, headers, b".debug_abbrev"),
+            _section_data(data, headers, b".debug_str"),
+            _section_data(data, headers, b".debug_line_str"),
+        )
+        try:
+            rows = program.run()
+        except (ValueError, IndexError, struct.error):
+            return
+        # The ends of the sequences precede the rows starting at the same address
+        rows.sort(key=lambda row: (row[0], row[1] != NO_FILE))
+        self.files = program.files
+        self.line_starts = array.array("Q", (row[0] for row in rows))
+        self.line_files = array.array("i", (row[1] for row in rows))
+        self.line_numbers = array.array("I", (row[2] for row in rows))
+
+    def _index_functions(self) -> None:
+        """Indexes the functions by their address ranges, keeping the first alias of each"""
+        functions: dict[int, tuple[int, str]] = {}
+        for address, size, name in self.symbols:
+            if address and address not in functions:
+                functions[address] = (size, name)
+        self.function_starts = array.array("Q", sorted(functions))
+        for i, address in enumerate(self.function_starts):
+            size, name = functions[address]
+            next_address = (
+                self.function_starts[i + 1] if i + 1 < len(self.function_starts) else address + 1
+            )
+            self.function_ends.append(address + size if size else next_address)
+            self.function_names.append(name)
+
+    def _load_cache(self, path: str) -> bool:
+        """Loads the symbols and the line table stored by :meth:`_store_cache`
+
+        :param str path: path to the cache
+        :return: true if the cache was loaded, false if it does not exist or is not valid
+        """
+        try:
+            with open(path, "rb") as cache:
+                content = cache.read()
+        except OSError:
+            return False
+        if not content.startswith(CACHE_MAGIC + struct.pack("<I", CACHE_VERSION)):
+            return False
+        blobs, offset = [], len(CACHE_MAGIC) + 4
+        try:
+            while offset < len(content):
+                (size,) = struct.unpack_from("<Q", content, offset)
+                if offset + 8 + size > len(content):
+                    return False
+                blobs.append(content[offset + 8 : offset + 8 + size])
+                offset += 8 + size
+            if len(blobs) != 7:
+                return False
+            addresses, sizes = array.array("Q", blobs[0]), array.array("Q", blobs[1])
+            names = blobs[2].decode().split("\0")[:-1]
+            line_starts = array.array("Q", blobs[3])
+            line_files = array.array("i", blobs[4])
+            line_numbers = array.array("I", blobs[5])
+            files = blobs[6].decode().split("\0")[:-1]
+        except (struct.error, ValueError):
+            # Truncated or corrupted caches are ignored and overwritten
+            return False
+        if not len(addresses) == len(sizes) == len(names) or not (
+            len(line_starts) == len(line_files) == len(line_numbers)
+        ):
+            return False
+        self.symbols = list(zip(addresses, sizes, names))
+        self.line_starts, self.line_files, self.line_numbers = line_starts, line_files, line_numbers
+        self.files = files
+        return True
+
+    def _store_cache(self, path: str) -> None:
+        """Stores the symbols and the line table to the cache, atomically replacing the old one
+
+        The cache is only an optimization, hence the failures of the storing are ignored.
+
+        :param str path: path to the cache
+        """
+        blobs = [
+            array.array("Q", (symbol[0] for symbol in self.symbols)).tobytes(),
+            array.array("Q", (symbol[1] for symbol in self.symbols)).tobytes(),
+            "".join(symbol[2] + "\0" for symbol in self.symbols).encode(),
+            self.line_starts.tobytes(),
+            self.line_files.tobytes(),
+            self.line_numbers.tobytes(),
+            "".join(file + "\0" for file in self.files).encode(),
+        ]
+        temporary_path = None
+        try:
+            os.makedirs(os.path.dirname(path), exist_ok=True)
+            with tempfile.NamedTemporaryFile(
+                "wb", dir=os.path.dirname(path), delete=False
+            ) as cache:
+                temporary_path = cache.name
+                cache.write(CACHE_MAGIC + struct.pack("<I", CACHE_VERSION))
+                for blob in blobs:
+                    cache.write(struct.pack("<Q", len(blob)) + blob)
+            os.replace(temporary_path, path)
+        except OSError:
+            if temporary_path is not None:
+                with exceptions.SuppressedExceptions(OSError):
+                    os.remove(temporary_path)
+
+    def address_of(self, offset: int) -> Optional[int]:
+        """
+        :param int offset: offset of the instruction in the binary
+        :return: virtual address of the instruction or None if it is not in loadable segment
+        """
+        for segment_offset, segment_size, vaddr in self.segments:
+            if segment_offset <= offset < segment_offset + segment_size:
+                return offset - segment_offset + vaddr
+        return None
+
+    def function_at_address(self, address: int, demangled: bool = False) -> Optional[str]:
+        """
+        :param int address: virtual address of the instruction
+        :param bool demangled: if set to true, then the demangled name is returned
+        :return: name of the function containing the instruction or None if it is not known
+        """
+        i = bisect.bisect_right(self.function_starts, address) - 1
+        if i >= 0 and address < self.function_ends[i]:
+            return self.demangled_function_names()[i] if demangled else self.function_names[i]
+        return None
+
+    def function_at(self, offset: int, demangled: bool = False) -> Optional[str]:
+        """
+        :param int offset: offset of the instruction in the binary
+        :param bool demangled: if set to true, then the demangled name is returned
+        :return: name of the function containing the instruction or None if it is not known
+        """
+        address = self.address_of(offset)
+        return self.function_at_address(address, demangled) if address is not None else None
+
+    def demangled_function_names(self) -> list[str]:
+        """Demangles the names of all the functions at once, when they are first needed
+
+        :return: demangled names of the functions (see :func:`demangle`)
+        """
+        if self.demangled_names is None:
+            self.demangled_names = demangle(self.function_names)
+        return self.demangled_names
+
+    def line_at(self, address: int) -> Optional[tuple[str, int]]:
+        """
+        :param int address: virtual address of the instruction
+        :return: the source file and the line of the instruction or None if it is not known
+        """
+        i = bisect.bisect_right(self.line_starts, address) - 1
+        if i < 0 or self.line_files[i] == NO_FILE:
+            return None
+        return self.files[self.line_files[i]], self.line_numbers[i]
+
+
+class LineProgram:
+    """Interpreter of the line number programs of DWARF (versions 2 to 5)
+
+    The rows of all units are collected as triples of address, index of the file in the global
+    list of files, and line. Only the rows needed for resolving the addresses are kept, i.e. the
+    columns, discriminators and flags of the rows are ignored. The relative paths of the files
+    are completed by the compilation directories of the units (read from ``.debug_info``).
+
+    :ivar bytes debug_line: contents of the ``.debug_line`` section
+    :ivar bytes debug_info: contents of the ``.debug_info`` section
+    :ivar bytes debug_abbrev: contents of the ``.debug_abbrev`` section
+    :ivar bytes debug_str: contents of the ``.debug_str`` section
+    :ivar bytes debug_line_str: contents of the ``.debug_line_str`` section
+    :ivar list files: paths of the files of all units
+    :ivar dict file_ids: map of the paths of the files to their indexes in files
+    """
+
+    __slots__ = [
+        "debug_line",
+        "debug_info",
+        "debug_abbrev",
+        "debug_str",
+        "debug_line_str",
+        "files",
+        "file_ids",
+    ]
+
+    def __init__(
+        self,
+        debug_line: bytes,
+        debug_info: bytes = b"",
+        debug_abbrev: bytes = b"",
+        debug_str: bytes = b"",
+        debug_line_str: bytes = b"",
+    ) -> None:
+        """
+        :param bytes debug_line: contents of the ``.debug_line`` section
+        :param bytes debug_info: contents of the ``.debug_info`` section
+        :param bytes debug_abbrev: contents of the ``.debug_abbrev`` section
+        :param bytes debug_str: contents of the ``.debug_str`` section
+        :param bytes debug_line_str: contents of the ``.debug_line_str`` section
+        """
+        self.debug_line = debug_line
+        self.debug_info = debug_info
+        self.debug_abbrev = debug_abbrev
+        self.debug_str = debug_str
+        self.debug_line_str = debug_line_str
+        self.files: list[str] = []
+        self.file_ids: dict[str, int] = {}
+
+    def run(self) -> list[tuple[int, int, int]]:
+        """
+        :return: rows of the line tables of all units
+        :raises ValueError: if some unit uses an unsupported format
+        """
+        directories = self.compilation_directories()
+        rows: list[tuple[int, int, int]] = []
+        offset = 0
+        while offset + 4 <= len(self.debug_line):
+            offset = self._run_unit(offset, directories.get(offset, ""), rows)
+        return rows
+
+    def file_id(self, path: str) -> int:
+        """
+        :param str path: path to the source file
+        :return: index of the file in the global list of files
+        """
+        file_id = self.file_ids.get(path)
+        if file_id is None:
+            file_id = self.file_ids[path] = len(self.files)
+            self.files.append(path)
+        return file_id
+
+    def compilation_directories(self) -> dict[int, str]:
+        """Reads the compilation directories from the first entries of the compilation units
+
+        The units in unsupported formats (and all units after them) are skipped.
+
+        :return: map of the offsets of the line tables to the directories of their units
+        """
+        data, offset = self.debug_info, 0
+        directories: dict[int, str] = {}
+        try:
+            while offset + 4 <= len(data):
+                offset_size, end, offset = _read_unit_length(data, offset)
+                (version,) = struct.unpack_from("<H", data, offset)
+                if version >= 5:
+                    unit_type, address_size = data[offset + 2], data[offset + 3]
+                    abbreviations = int.from_bytes(
+                        data[offset + 4 : offset + 4 + offset_size], "little"
+                    )
+                    offset += 4 + offset_size
+                    # Skeleton and split units have the id, type units the signature and offset
+                    offset += 8 if unit_type in (4, 5) else 0
+                    offset += 8 + offset_size if unit_type in (2, 6) else 0
+                else:
+                    abbreviations = int.from_bytes(
+                        data[offset + 2 : offset + 2 + offset_size], "little"
+                    )
+                    address_size = data[offset + 2 + offset_size]
+                    offset += 3 + offset_size
+                code, offset = _read_uleb(data, offset)
+                values: dict[int, Any] = {}
+                for attribute, form, implicit in self._abbreviation(abbreviations, code):
+                    if form == DW_FORM_IMPLICIT_CONST:
+                        values[attribute] = implicit
+                    else:
+                        values[attribute], offset = self._read_form(
+                            data, form, offset, offset_size, address_size
+                        )
+                if isinstance(values.get(DW_AT_COMP_DIR), str) and DW_AT_STMT_LIST in values:
+                    directories[values[DW_AT_STMT_LIST]] = values[DW_AT_COMP_DIR]
+                offset = end
+        except (ValueError, IndexError, struct.error):
+            pass
+        return directories
+
+    def _abbreviation(self, offset: int, code: int) -> list[tuple[int, int, int]]:
+        """
+        :param int offset: offset of the abbreviations of the unit in ``.debug_abbrev``
+        :param int code: code of the abbreviation
+        :return: attributes of the abbreviation as triples of attribute, form and implicit value
+        :raises ValueError: if the abbreviation does not exist
+        """
+        data = self.debug_abbrev
+        while True:
+            abbreviation_code, offset = _read_uleb(data, offset)
+            if not abbreviation_code:
+                raise ValueError(f"missing abbreviation {code}")
+            # The tag and the flag of children are skipped
+            _, offset = _read_uleb(data, offset)
+            offset += 1
+            attributes = []
+            while True:
+                attribute, offset = _read_uleb(data, offset)
+                form, offset = _read_uleb(data, offset)
+                implicit = 0
+                if form == DW_FORM_IMPLICIT_CONST:
+                    implicit, offset = _read_sleb(data, offset)
+                if not attribute and not form:
+                    break
+                attributes.append((attribute, form, implicit))
+            if abbreviation_code == code:
+                return attributes
+
+    def _run_unit(self, offset: int, directory: str, rows: list[tuple[int, int, int]]) -> int:
+        """Runs the line program of one unit
+
+        :param int offset: offset of the unit in the ``.debug_line``
+        :param str directory: compilation directory of the unit (empty if it is not known)
+        :param list rows: list, where the rows of the unit are appended
+        :return: offset of the next unit
+        """
+        data = self.debug_line
+        offset_size, end, offset = _read_unit_length(data, offset)
+        (version,) = struct.unpack_from("<H", data, offset)
+        if not 2 <= version <= 5:
+            raise ValueError(f"unsupported version {version} of the line table")
+        # The address and segment selector sizes of the version 5 are not needed
+        offset += 4 if version >= 5 else 2
+        header_length = int.from_bytes(data[offset : offset + offset_size], "little")
+        offset += offset_size
+        program_start = offset + header_length
+        min_length = data[offset]
+        offset += 2 if version >= 4 else 1
+        line_base = struct.unpack_from("<b", data, offset + 1)[0]
+        line_range, opcode_base = data[offset + 2], data[offset + 3]
+        opcode_lengths = data[offset + 4 : offset + 3 + opcode_base]
+        offset += 3 + opcode_base
+
+        if version >= 5:
+            directories, offset = self._read_entries(offset, offset_size)
+            entries, offset = self._read_entries(offset, offset_size)
+            directory_names = [
+                os.path.join(directory, entry.get(DW_LNCT_PATH, "")) for entry in directories
+            ]
+            files = [
+                self.file_id(
+                    os.path.join(
+                        directory_names[entry.get(DW_LNCT_DIRECTORY_INDEX, 0)],
+                        entry.get(DW_LNCT_PATH, ""),
+                    )
+                )
+                for entry in entries
+            ]
+        else:
+            # The directory of the unit is implicitly the first directory before the version 5
+            directory_names = [directory]
+            while data[offset]:
+                name, offset = _read_string(data, offset)
+                directory_names.append(os.path.join(directory, name))
+            offset += 1
+            # The files are indexed from one before the version 5
+            files = [NO_FILE]
+            while data[offset]:
+                name, offset = _read_string(data, offset)
+                directory_index, offset = _read_uleb(data, offset)
+                _, offset = _read_uleb(data, offset)
+                _, offset = _read_uleb(data, offset)
+                files.append(self.file_id(os.path.join(directory_names[directory_index], name)))
+
+        self._run_program(
+            program_start, end, files, min_length, line_base, line_range, opcode_lengths, rows
+        )
+        return end
+
+    def _run_program(
+        self,
+        offset: int,
+        end: int,
+        files: list[int],
+        min_length: int,
+        line_base: int,
+        line_range: int,
+        opcode_lengths: bytes,
+        rows: list[tuple[int, int, int]],
+    ) -> None:
+        """Runs the opcodes of the line program of the unit
+
+        The sequences of the functions removed by the linker (which are relocated to the zero
+        address) are skipped.
+
+        :param int offset: offset of the first opcode
+        :param int end: end of the unit
+        :param list files: global indexes of the files of the unit
+        :param int min_length: minimal length of the instruction
+        :param int line_base: the smallest line advance of the special opcodes
+        :param int line_range: number of the line advances of the special opcodes
+        :param bytes opcode_lengths: numbers of the arguments of the standard opcodes
+        :param list rows: list, where the rows are appended
+        """
+        data, opcode_base = self.debug_line, len(opcode_lengths) + 1
+        const_advance = min_length * ((255 - opcode_base) // line_range)
+        sequence: list[tuple[int, int, int]] = []
+        address, file, line = 0, 1, 1
+        while offset < end:
+            opcode = data[offset]
+            offset += 1
+            if opcode >= opcode_base:
+                adjusted = opcode - opcode_base
+                address += min_length * (adjusted // line_range)
+                line += line_base + adjusted % line_range
+                sequence.append((address, file, line))
+            elif opcode == 0:
+                length, offset = _read_uleb(data, offset)
+                extended = data[offset]
+                if extended == 1:
+                    # DW_LNE_end_sequence
+                    if sequence and sequence[0][0]:
+                        rows.extend(
+                            (row_address, files[row_file], row_line)
+                            for (row_address, row_file, row_line) in sequence
+                            if 0 <= row_file < len(files)
+                        )
+                        rows.append((address, NO_FILE, 0))
+                    sequence, address, file, line = [], 0, 1, 1
+                elif extended == 2:
+                    # DW_LNE_set_address
+                    address = int.from_bytes(data[offset + 1 : offset + length], "little")
+                elif extended == 3:
+                    # DW_LNE_define_file
+                    name, _ = _read_string(data, offset + 1)
+                    files.append(self.file_id(name))
+                offset += length
+            elif opcode == 1:
+                # DW_LNS_copy
+                sequence.append((address, file, line))
+            elif opcode == 2:
+                # DW_LNS_advance_pc
+                advance, offset = _read_uleb(data, offset)
+                address += min_length * advance
+            elif opcode == 3:
+                # DW_LNS_advance_line
+                advance, offset = _read_sleb(data, offset)
+                line += advance
+            elif opcode == 4:
+                # DW_LNS_set_file
+                file, offset = _read_uleb(data, offset)
+            elif opcode == 8:
+                # DW_LNS_const_add_pc
+                address += const_advance
+            elif opcode == 9:
+                # DW_LNS_fixed_advance_pc
+                address += data[offset] | data[offset + 1] << 8
+                offset += 2
+            else:
+                for _ in range(opcode_lengths[opcode - 1]):
+                    _, offset = _read_uleb(data, offset)
+
+    def _read_entries(self, offset: int, offset_size: int) -> tuple[list[dict[int, Any]], int]:
+        """Reads the directory or file entries of the header of the version 5
+
+        :param int offset: offset of the format of the entries
+        :param int offset_size: size of the offsets (4 or 8 for 64bit DWARF)
+        :return: entries as maps of the content types to values, and the offset after them
+        """
+        data = self.debug_line
+        format_count = data[offset]
+        offset += 1
+        formats = []
+        for _ in range(format_count):
+            content_type, offset = _read_uleb(data, offset)
+            form, offset = _read_uleb(data, offset)
+            formats.append((content_type, form))
+        count, offset = _read_uleb(data, offset)
+        entries = []
+        for _ in range(count):
+            entry = {}
+            for content_type, form in formats:
+                entry[content_type], offset = self._read_form(data, form, offset, offset_size)
+            entries.append(entry)
+        return entries, offset
+
+    def _read_form(
+        self, data: bytes, form: int, offset: int, offset_size: int, address_size: int = 8
+    ) -> tuple[Any, int]:
+        """
+        :param bytes data: contents of the read section
+        :param int form: the DWARF form of the value
+        :param int offset: offset of the value
+        :param int offset_size: size of the offsets (4 or 8 for 64bit DWARF)
+        :param int address_size: size of the addresses
+        :return: the value and the offset after it
+        :raises ValueError: if the form is not supported
+        """
+        if form == DW_FORM_STRING:
+            return _read_string(data, offset)
+        if form in (DW_FORM_LINE_STRP, DW_FORM_STRP):
+            strings = self.debug_line_str if form == DW_FORM_LINE_STRP else self.debug_str
+            string_offset = int.from_bytes(data[offset : offset + offset_size], "little")
+            return _read_string(strings, string_offset)[0], offset + offset_size
+        if form in ULEB_FORMS:
+            return _read_uleb(data, offset)
+        if form in SLEB_FORMS:
+            return _read_sleb(data, offset)
+        if form == DW_FORM_INDIRECT:
+            form, offset = _read_uleb(data, offset)
+            return self._read_form(data, form, offset, offset_size, address_size)
+        if form in BLOCK_FORMS or form in BLOCK_SIZE_FORMS:
+            if form in BLOCK_FORMS:
+                size, offset = _read_uleb(data, offset)
+            else:
+                size = int.from_bytes(data[offset : offset + BLOCK_SIZE_FORMS[form]], "little")
+                offset += BLOCK_SIZE_FORMS[form]
+            return data[offset : offset + size], offset + size
+        if form not in FORM_SIZES:
+            raise ValueError(f"unsupported DWARF form {form:#x}")
+        size = {ADDRESS_SIZE: address_size, OFFSET_SIZE: offset_size}.get(
+            FORM_SIZES[form], FORM_SIZES[form]
+        )
+        return int.from_bytes(data[offset : offset + size], "little"), offset + size
+
+
+def cache_directory() -> str:
+    """
+    :return: directory of the cached symbols (in the cache directory of the user)
+    """
+    cache_home = os.environ.get("XDG_CACHE_HOME") or os.path.join(os.path.expanduser("~"), ".cache")
+    return os.path.join(cache_home, "perun", "symbols")
+
+
+def cache_path(build_id: str) -> str:
+    """
+    :param str build_id: build-id of the binary in hex
+    :return: path to the cached symbols of the build (split the same way as in debuginfod)
+    """
+    return os.path.join(cache_directory(), build_id[:2], build_id[2:])
+
+
+def load(path: str) -> Optional[BinarySymbols]:
+    """Loads the symbols of the binary, reusing the symbols already loaded by this process
+
+    :param str path: path to the binary
+    :return: symbols of the binary or None if it cannot be read or is not a supported ELF file
+    """
+    try:
+        stat = os.stat(path)
+    except OSError:
+        return None
+    key = (os.path.realpath(path), stat.st_mtime_ns, stat.st_size)
+    if key not in _LOADED:
+        try:
+            _LOADED[key] = BinarySymbols(path)
+        except (OSError, ValueError):
+            _LOADED[key] = None
+    return _LOADED[key]
+
+
+def demangle(names: list[str]) -> list[str]:
+    """Demangles the names of C++ functions by a single call of ``c++filt``
+
+    :param list names: names of the functions
+    :return: demangled names in the same order (the names are kept as they are, if they are not
+        mangled or ``c++filt`` is not available)
+    """
+    mangled = [name for name in names if name.startswith("_Z")]
+    if not mangled:
+        return list(names)
+    try:
+        output = subprocess.run(
+            ["c++filt"], input="\n".join(mangled).encode(), capture_output=True, check=True
+        ).stdout
+    except (OSError, subprocess.CalledProcessError):
+        return list(names)
+    demangled_names = output.decode("utf-8", errors="replace").split("\n")
+    if len(demangled_names) < len(mangled):
+        return list(names)
+    demangled = dict(zip(mangled, demangled_names))
+    return [demangled.get(name, name) for name in names]
+
+
+def _find_build_id(notes: bytes) -> str:
+    """
+    :param bytes notes: contents of the note section
+    :return: the GNU build-id from the notes in hex (empty if there is none)
+    """
+    offset = 0
+    while offset + 12 <= len(notes):
+        name_size, desc_size, note_type = struct.unpack_from("<III", notes, offset)
+        name_end = offset + 12 + name_size
+        desc_start = name_end + (-name_size % 4)
+        if note_type == NT_GNU_BUILD_ID and notes[offset + 12 : name_end] == b"GNU\0":
+            return notes[desc_start : desc_start + desc_size].hex()
+        offset = desc_start + desc_size + (-desc_size % 4)
+    return ""
+
+
+def _section_data(data: mmap.mmap, headers: list[tuple[Any, ...]], name: bytes) -> bytes:
+    """
+    :param mmap data: contents of the binary
+    :param list headers: headers of the sections (with their names)
+    :param bytes name: name of the section
+    :return: (decompressed) contents of the section (empty if there is no such section)
+    """
+    for section in headers:
+        if section[-1] == name:
+            content = data[section[4] : section[4] + section[5]]
+            if section[2] & SHF_COMPRESSED:
+                # Elf32_Chdr and Elf64_Chdr headers start with the type (1 for zlib)
+                if struct.unpack_from("<I", content)[0] != 1:
+                    return b""
+                content = zlib.decompress(content[24 if data[4] == 2 else 12 :])
+            return content
+    return b""
+
+
+def _read_unit_length(data: bytes, offset: int) -> tuple[int, int, int]:
+    """
+    :param bytes data: contents of the DWARF section
+    :param int offset: offset of the unit
+    :return: size of the offsets of the unit (8 for 64bit DWARF), its end, and the offset of
+        its header after the length
+    """
+    (unit_length,) = struct.unpack_from("<I", data, offset)
+    if unit_length == 0xFFFFFFFF:
+        (unit_length,) = struct.unpack_from("<Q", data, offset + 4)
+        return 8, offset + 12 + unit_length, offset + 12
+    return 4, offset + 4 + unit_length, offset + 4
+
+
+def _read_string(data: bytes, offset: int) -> tuple[str, int]:
+    """
+    :param bytes data: read data
+    :param int offset: offset of the null terminated string
+    :return: the string and the offset after its terminator
+    """
+    end = data.index(b"\0", offset)
+    return data[offset:end].decode(errors="replace"), end + 1
+
+
+def _read_uleb(data: bytes, offset: int) -> tuple[int, int]:
+    """
+    :param bytes data: read data
+    :param int offset: offset of the unsigned LEB128 number
+    :return: the number and the offset after it
+    """
+    value, shift = 0, 0
+    while True:
+        byte = data[offset]
+        offset += 1
+        value |= (byte & 0x7F) << shift
+        if byte < 0x80:
+            return value, offset
+        shift += 7
+
+
+def _read_sleb(data: bytes, offset: int) -> tuple[int, int]:
+    """
+    :param bytes data: read data
+    :param int offset: offset of the signed LEB128 number
+    :return: the number and the offset after it
+    """
+    value, shift = 0, 0
+    while True:
+        byte = data[offset]
+        offset += 1
+        value |= (byte & 0x7F) << shift
+        shift += 7
+        if byte < 0x80:
+            return value - (1 << shift) if byte & 0x40 else value, offset
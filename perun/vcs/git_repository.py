@@ -8,6 +8,7 @@ from __future__ import annotations
 # Standard Imports
 from typing import Optional, Iterator, Any
 import os
+import weakref
 
 # Third-Party Imports
 from git.exc import NoSuchPathError, InvalidGitRepositoryError, GitCommandError
@@ -22,10 +23,18 @@ from perun.utils.exceptions import VersionControlSystemException
 from perun.utils.structs import MinorVersion, MajorVersion
 
 
+# Repositories opened in this process; they are reopened in forked children
+_OPENED_REPOSITORIES: weakref.WeakSet[GitRepository] = weakref.WeakSet()
+# Git repositories inherited from the parent process; they must not be destructed in the child,
+# since that would terminate the persistent git processes (e.g. cat-file) shared with the parent
+_INHERITED_GIT_REPOS: list[Repo] = []
+
+
 class GitRepository(AbstractRepository):
     def __init__(self, vcs_path: str):
         self.vcs_path: str = vcs_path
         self._set_git_repo(vcs_path)
+        _OPENED_REPOSITORIES.add(self)
 
         self.parse_commit_cache: dict[str, MinorVersion] = {}
         self.minor_version_validity_cache: set[str] = set()
@@ -36,6 +45,19 @@ class GitRepository(AbstractRepository):
         if self.valid_repo:
             self.git_repo: Repo = Repo(vcs_path)
 
+    def reopen_after_fork(self) -> None:
+        """Reopens the git repository in the forked child process
+
+        The persistent git processes of the repository are shared with the parent process, hence
+        using them from both processes would mix their requests and responses.
+        """
+        if self.valid_repo:
+            _INHERITED_GIT_REPOS.append(self.git_repo)
+            try:
+                self.git_repo = Repo(self.vcs_path)
+            except (InvalidGitRepositoryError, NoSuchPathError):
+                self.valid_repo = False
+
     @staticmethod
     def contains_git_repo(path: str) -> bool:
         """Checks if there is a git repo at the given @p path.
@@ -262,3 +284,13 @@ class GitRepository(AbstractRepository):
         :param str minor_version: newly checkout state
         """
         self.git_repo.git.checkout(minor_version)
+
+
+def _reopen_repositories_after_fork() -> None:
+    """Reopens all git repositories opened in the parent process in the forked child"""
+    for repository in list(_OPENED_REPOSITORIES):
+        repository.reopen_after_fork()
+
+
+if hasattr(os, "register_at_fork"):
+    os.register_at_fork(after_in_child=_reopen_repositories_after_fork)
@@ -1,96 +1,308 @@
-"""This module provides wrapper for the Flame graph visualization"""
+"""This module provides wrapper for the Flame graph visualization
+
+The flame graphs are rendered in-process from the stacks folded into the prefix trie (see
+:mod:`perun.profile.folding`), into the same interactive SVG as is produced by the perl script
+of Brendan Gregg (https://github.com/brendangregg/FlameGraph/blob/master/flamegraph.pl). Each
+node of the trie is visited only once, hence the rendering is linear in the number of unique
+stacks.
+"""
 from __future__ import annotations
 
 # Standard Imports
-from typing import TYPE_CHECKING
-import os
-import tempfile
+from typing import Optional, TYPE_CHECKING
+import re
 
 # Third-Party Imports
+import jinja2
 
 # Perun Imports
-from perun.profile import convert
-from perun.utils.common import script_kit
-from perun.utils.external import commands
+from perun.profile import folding
 
 if TYPE_CHECKING:
     from perun.profile.factory import Profile
 
 
+FONT_TYPE: str = "Verdana"
+FONT_SIZE: int = 12
+# Average width of the character relative to the font size
+FONT_WIDTH: float = 0.59
+# Frames narrower than this (in pixels) are not drawn at all
+MIN_WIDTH: float = 0.1
+X_PAD: int = 10
+TOP_PAD: int = FONT_SIZE * 4
+BOTTOM_PAD: int = FONT_SIZE * 2 + 10
+FRAME_PAD: int = 1
+
+
+def _number(value: float) -> str:
+    """Formats the number the same way as perl does, i.e. without any trailing zeros
+
+    :param float value: formatted number
+    :return: formatted number
+    """
+    return f"{value:.15g}"
+
+
+def _escape(text: str, quote: bool = True) -> str:
+    """Escapes the characters breaking the svg
+
+    :param str text: escaped text
+    :param bool quote: if set to true, then also quotes are escaped
+    :return: escaped text
+    """
+    text = text.replace("&", "&amp;").replace("<", "&lt;").replace(">", "&gt;")
+    return text.replace('"', "&quot;") if quote else text
+
+
+def _name_hash(name: str) -> float:
+    """Generates a vector hash for the name, weighting early over later characters.
+
+    This picks the same colors for the same functions across different flame graphs.
+
+    :param str name: name of the frame
+    :return: hash in the interval (0, 1]
+    """
+    vector, weight, maximum, modulo = 0.0, 1.0, 1.0, 10
+    # If module name is present, truncate it to the first character
+    for char in re.sub(r".(.*?)`", "", name, count=1):
+        vector += (ord(char) % modulo) / (modulo - 1) * weight
+        modulo += 1
+        maximum += weight
+        weight *= 0.70
+        if modulo > 12:
+            break
+    return 1 - vector / maximum
+
+
+def _hot_color(name: str) -> str:
+    """
+    :param str name: name of the frame
+    :return: color of the frame from the 'hot' palette
+    """
+    first, second = _name_hash(name), _name_hash(name[::-1])
+    return f"rgb({205 + int(50 * second)},{int(230 * first)},{int(55 * second)})"
+
+
+def _scale_color(delta: float, max_delta: float) -> str:
+    """
+    :param float delta: difference of amounts of the frame
+    :param float max_delta: maximal absolute difference of amounts
+    :return: color of the frame, red for increased and blue for decreased amounts
+    """
+    red = green = blue = 255
+    if delta > 0:
+        green = blue = int(210 * (max_delta - delta) / max_delta)
+    elif delta < 0:
+        red = green = int(210 * (max_delta + delta) / max_delta)
+    return f"rgb({red},{green},{blue})"
+
+
+def render_flame_graph(
+    trie: folding.StackTrie,
+    frame_height: int,
+    width: int = 1200,
+    title: str = "Flame Graph",
+    count_name: str = "samples",
+) -> str:
+    """Renders the interactive flame graph of the folded stacks.
+
+    If the trie is a difference of two tries (see :meth:`folding.StackTrie.difference`), then
+    the widths of frames correspond to the target amounts and frames are colored by the
+    differences of their amounts (red for increase and blue for decrease).
+
+    :param StackTrie trie: folded stacks
+    :param int frame_height: height of one frame
+    :param int width: width of the graph
+    :param str title: title of the graph
+    :param str count_name: name of the units of amounts
+    :return: svg of the flame graph
+    """
+    env = jinja2.Environment(loader=jinja2.PackageLoader("perun", "templates"))
+    template = env.get_template("flamegraph.svg.jinja2")
+    totals = trie.totals()
+    total = totals[folding.ROOT]
+    if total <= 0:
+        return template.render(
+            width=width,
+            height=FONT_SIZE * 5,
+            font_size=FONT_SIZE,
+            font_type=FONT_TYPE,
+            error="ERROR: No stack counts found",
+        )
+
+    deltas = trie.deltas() if trie.baseline_counts is not None else None
+    max_delta = max(max(map(abs, deltas)), 1) if deltas else 1
+    width_per_unit = (width - 2 * X_PAD) / total
+    min_width = MIN_WIDTH / width_per_unit
+
+    # Lay out the frames: children are ordered as their folded stacks would be sorted (stacks
+    # ending in the child sort before the stacks continuing through it), and start after the
+    # stacks ending in their parent; frames too narrow to be drawn are pruned with subtrees.
+    baseline_counts = trie.baseline_counts or trie.counts
+    stack_order: list[list[int]] = [[0, 0] for _ in trie.frame_names]
+    separators = (";", " ")
+    for order, (frame, ends) in enumerate(
+        sorted(
+            ((frame, ends) for frame in range(len(trie.frame_names)) for ends in (0, 1)),
+            key=lambda key: trie.frame_names[key[0]] + separators[key[1]],
+        )
+    ):
+        stack_order[frame][ends] = order
+    starts = {folding.ROOT: 0.0}
+    drawn, to_visit = [], [folding.ROOT]
+    while to_visit:
+        node = to_visit.pop()
+        drawn.append(node)
+        start, visible = starts[node] + trie.counts[node], []
+        for child in sorted(
+            trie.children(node),
+            key=lambda child: stack_order[trie.frames[child]][
+                trie.counts[child] != 0 or baseline_counts[child] != 0
+            ],
+        ):
+            if totals[child] >= min_width:
+                starts[child] = start
+                visible.append(child)
+            start += totals[child]
+        to_visit.extend(reversed(visible))
+    depths = trie.depths()
+    image_height = max(depths[node] for node in drawn) * frame_height + TOP_PAD + BOTTOM_PAD
+
+    frame_colors: dict[int, str] = {}
+    frames = []
+    for node in drawn:
+        depth, frame = depths[node], trie.frames[node]
+        name = trie.frame_names[frame] if node != folding.ROOT else ""
+        # Annotations of kernel, waker or inlined frames are not displayed
+        label = re.sub(r"_\[[kwi]\]$", "", name)
+        x_start = X_PAD + starts[node] * width_per_unit
+        x_end = X_PAD + (starts[node] + totals[node]) * width_per_unit
+        y_start = image_height - BOTTOM_PAD - (depth + 1) * frame_height + FRAME_PAD
+        y_end = image_height - BOTTOM_PAD - depth * frame_height
+        amount = float(f"{totals[node]:.0f}")
+        samples = f"{amount:,.0f} {count_name}"
+
+        if node == folding.ROOT:
+            info = f"all ({samples}, 100%)"
+        else:
+            info = f"{_escape(label)} ({samples}, {100 * amount / total:.2f}%"
+            if deltas is None:
+                info += ")"
+            else:
+                info += f"; {'+' if deltas[node] > 0 else ''}{100 * deltas[node] / total:.2f}%)"
+
+        if name == "--":
+            color = "rgb(160,160,160)"
+        elif name == "-":
+            color = "rgb(200,200,200)"
+        elif deltas is not None:
+            color = _scale_color(deltas[node], max_delta)
+        else:
+            if frame not in frame_colors:
+                frame_colors[frame] = _hot_color(name)
+            color = frame_colors[frame]
+
+        chars = int((x_end - x_start) / (FONT_SIZE * FONT_WIDTH))
+        text = ""
+        if chars >= 3:
+            text = label[:chars]
+            if chars < len(label):
+                text = text[:-2] + ".."
+            text = _escape(text, quote=False)
+
+        rect_x_start, rect_x_end = f"{x_start:0.1f}", f"{x_end:0.1f}"
+        frames.append(
+            '<g class="func_g" onmouseover="s(this)" onmouseout="c()" onclick="zoom(this)">\n'
+            f"<title>{info}</title>"
+            f'<rect x="{rect_x_start}" y="{_number(y_start)}" '
+            f'width="{float(rect_x_end) - float(rect_x_start):0.1f}" '
+            f'height="{y_end - y_start:0.1f}" fill="{color}" rx="2" ry="2" />\n'
+            f'<text text-anchor="" x="{x_start + 3:0.2f}" y="{_number(3 + (y_start + y_end) / 2)}" '
+            f'font-size="{FONT_SIZE}" font-family="{FONT_TYPE}" fill="rgb(0,0,0)"  >{text}</text>\n'
+            "</g>"
+        )
+
+    return template.render(
+        width=width,
+        height=image_height,
+        font_size=FONT_SIZE,
+        font_width=FONT_WIDTH,
+        font_type=FONT_TYPE,
+        xpad=X_PAD,
+        info_y=_number(image_height - BOTTOM_PAD / 2),
+        title=_escape(title, quote=False),
+        frames="\n".join(frames),
+    )
+
+
+def _default_title(profile: Profile, title: str, amount_key: str = "amount") -> tuple[str, str]:
+    """
+    :param Profile profile: visualized profile
+    :param str title: if set to empty, then title will be generated
+    :param str amount_key: key of the visualized metric of the resources
+    :return: title of the graph and units of the amounts
+    """
+    header = profile["header"]
+    profile_type = header["type"]
+    cmd, workload = (header["cmd"], header["workload"])
+    if amount_key != "amount":
+        title = title if title != "" else f"{amount_key} of {cmd} {workload}"
+        return title, amount_key
+    title = title if title != "" else f"{profile_type} consumption of {cmd} {workload}"
+    return title, header["units"][profile_type]
+
+
 def draw_flame_graph_difference(
-    lhs_profile: Profile, rhs_profile: Profile, height: int, width: int = 1200, title: str = ""
+    lhs_profile: Profile,
+    rhs_profile: Profile,
+    height: int,
+    width: int = 1200,
+    title: str = "",
+    lhs_trie: Optional[folding.StackTrie] = None,
+    rhs_trie: Optional[folding.StackTrie] = None,
+    amount_key: str = "amount",
 ) -> str:
     """Draws difference of two flame graphs from two profiles
 
+    The baseline amounts are normalized to the total amount of the target.
+
     :param lhs_profile: baseline profile
     :param rhs_profile: target_profile
+    :param height: height of one frame
+    :param width: width of the graph
+    :param title: if set to empty, then title will be generated
+    :param lhs_trie: already folded stacks of the baseline profile
+    :param rhs_trie: already folded stacks of the target profile
+    :param amount_key: key of the visualized metric of the resources
     """
-    # First we create two flamegraph formats
-    lhs_flame = convert.to_flame_graph_format(lhs_profile)
-    with open("lhs.flame", "w") as lhs_handle:
-        lhs_handle.write("".join(lhs_flame))
-    rhs_flame = convert.to_flame_graph_format(rhs_profile)
-    with open("rhs.flame", "w") as rhs_handle:
-        rhs_handle.write("".join(rhs_flame))
-
-    header = lhs_profile["header"]
-    profile_type = header["type"]
-    cmd, workload = (header["cmd"], header["workload"])
-    title = title if title != "" else f"{profile_type} consumption of {cmd} {workload}"
-    units = header["units"][profile_type]
-
-    diff_script = script_kit.get_script("difffolded.pl")
-    flame_script = script_kit.get_script("flamegraph.pl")
-    difference_script = (
-        f"{diff_script} -n lhs.flame rhs.flame "
-        f"| {flame_script} --title '{title}' --countname {units} --reverse "
-        f"--width {width * 2} --height {height}"
+    lhs_trie = folding.fold_profile(lhs_profile, amount_key) if lhs_trie is None else lhs_trie
+    rhs_trie = folding.fold_profile(rhs_profile, amount_key) if rhs_trie is None else rhs_trie
+    title, units = _default_title(lhs_profile, title, amount_key)
+    return render_flame_graph(
+        rhs_trie.difference(lhs_trie, normalize=True), height, width * 2, title, units
     )
-    out, _ = commands.run_safely_external_command(difference_script)
-    os.remove("lhs.flame")
-    os.remove("rhs.flame")
 
-    return out.decode("utf-8")
 
-
-def draw_flame_graph(profile: Profile, height: int, width: int = 1200, title: str = "") -> str:
+def draw_flame_graph(
+    profile: Profile,
+    height: int,
+    width: int = 1200,
+    title: str = "",
+    trie: Optional[folding.StackTrie] = None,
+    amount_key: str = "amount",
+) -> str:
     """Draw Flame graph from profile.
 
-        To create Flame graphs we use perl script created by Brendan Gregg.
+        The Flame graphs are based on the perl script created by Brendan Gregg.
         https://github.com/brendangregg/FlameGraph/blob/master/flamegraph.pl
 
     :param profile: the memory profile
     :param width: width of the graph
-    :param height: graphs height
+    :param height: height of one frame
     :param title: if set to empty, then title will be generated
+    :param trie: already folded stacks of the profile
+    :param amount_key: key of the visualized metric of the resources
     """
-    # converting profile format to format suitable to Flame graph visualization
-    flame = convert.to_flame_graph_format(profile)
-
-    header = profile["header"]
-    profile_type = header["type"]
-    cmd, workload = (header["cmd"], header["workload"])
-    title = title if title != "" else f"{profile_type} consumption of {cmd} {workload}"
-    units = header["units"][profile_type]
-
-    with tempfile.NamedTemporaryFile(delete=False) as tmp:
-        tmp.write("".join(flame).encode("utf-8"))
-        tmp.close()
-        cmd = " ".join(
-            [
-                script_kit.get_script("flamegraph.pl"),
-                tmp.name,
-                "--title",
-                f'"{title}"',
-                "--countname",
-                f"{units}",
-                "--reverse",
-                "--width",
-                str(width),
-                "--height",
-                str(height),
-            ]
-        )
-        out, _ = commands.run_safely_external_command(cmd)
-        os.remove(tmp.name)
-    return out.decode("utf-8")
+    trie = folding.fold_profile(profile, amount_key) if trie is None else trie
+    title, units = _default_title(profile, title, amount_key)
+    return render_flame_graph(trie, height, width, title, units)
@@ -12,14 +12,17 @@ import perun.view.flamegraph.flamegraph as flame
 import perun.profile.factory as profile_factory
 
 
-def save_flamegraph(profile: profile_factory.Profile, filename: str, graph_height: int) -> None:
+def save_flamegraph(
+    profile: profile_factory.Profile, filename: str, graph_height: int, metric: str = "amount"
+) -> None:
     """Draws and saves flamegraph to file
 
     :param profile: profile for which we are saving flamegraph
     :param filename: name of the file where the flamegraph will be saved
     :param graph_height: height of the graph
+    :param metric: key of the visualized metric of the resources
     """
-    flamegraph_content = flame.draw_flame_graph(profile, graph_height)
+    flamegraph_content = flame.draw_flame_graph(profile, graph_height, amount_key=metric)
     with open(filename, "w") as file_handle:
         file_handle.write(flamegraph_content)
 
@@ -38,9 +41,18 @@ def save_flamegraph(profile: profile_factory.Profile, filename: str, graph_heigh
     type=int,
     help="Increases the width of the resulting flame graph.",
 )
+@click.option(
+    "--metric",
+    "-m",
+    default="amount",
+    help=(
+        "Sets the metric of the resources, by which the frames are sized (e.g. one of the events"
+        " sampled by kperf with --counters)."
+    ),
+)
 @profile_factory.pass_profile
 def flamegraph(
-    profile: profile_factory.Profile, filename: str, graph_height: int, **_: Any
+    profile: profile_factory.Profile, filename: str, graph_height: int, metric: str, **_: Any
 ) -> None:
     """Flame graph interprets the relative and inclusive presence of the
     resources according to the stack depth of the origin of resources.
@@ -58,8 +70,9 @@ def flamegraph(
     relative to others.
 
     **Acknowledgements**: Big thanks to Brendan Gregg for creating the original
-    perl script for creating flame graphs w.r.t simple format. If you like this
-    visualization technique, please check out this guy's site
+    perl script for creating flame graphs w.r.t simple format, which our
+    renderer is based on. If you like this visualization technique, please
+    check out this guy's site
     (https://brendangregg.com) for more information about performance, profiling
     and useful talks and visualization techniques!
 
@@ -79,7 +92,7 @@ def flamegraph(
 
     Refer to :ref:`views-flame-graph` for more thorough description and
     examples of the interpretation technique. Refer to
-    :func:`perun.profile.convert.to_flame_graph_format` for more details how
-    the profiles are converted to the flame graph format.
+    :func:`perun.profile.folding.fold_profile` for more details how the
+    traces of the profiles are folded into stacks of the flame graph.
     """
-    save_flamegraph(profile, filename, graph_height)
+    save_flamegraph(profile, filename, graph_height, metric)
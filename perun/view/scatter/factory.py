@@ -171,7 +171,8 @@ def _draw_models(profile: Profile, models: ProfileModels) -> hv.Overlay:
             # This is a parametric model, add it to the overlay
             curves *= _create_parametric_model(model)
         # Non-parametric models don't contain coefficients
-        elif model["model"] == "regressogram":
+        elif model["model"] == "regressogram" or "sketch" in model:
+            # Models computed from sketches are summarized into buckets as regressograms
             curves *= _create_regressogram_model(model)
         elif model["model"] in ("moving_average", "kernel_regression"):
             for curve in _create_non_param_model(profile, model):
@@ -206,7 +207,7 @@ def _create_non_param_model(profile: Profile, model: ProfileModel) -> Iterator[h
     }
     legend = _build_model_legend(model)
     # Obtain the x-coordinates with the required uid to pair with current model
-    for x_pts, _, uid in data_provider.generic_profile_provider(profile, **params):
+    for x_pts, _, uid in data_provider.columnar_profile_provider(profile, **params):
         if uid == model["uid"]:
             # Build the model
             yield hv.Curve(
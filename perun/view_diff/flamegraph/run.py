@@ -13,7 +13,7 @@ import jinja2
 from perun.utils import log
 from perun.utils.common import diff_kit
 from perun.profile.factory import Profile
-from perun.profile import convert
+from perun.profile import convert, folding
 from perun.view.flamegraph import flamegraph as flamegraph_factory
 from perun.view_diff.table import run as table_run
 
@@ -87,8 +87,8 @@ def get_uids(profile: Profile) -> set[str]:
     :param profile: profile
     :return: set of unique uids in profile
     """
-    df = convert.resources_to_pandas_dataframe(profile)
-    return set(df["uid"].unique())
+    groups, _ = convert.resources_to_aggregated_amounts(profile, ("uid",))
+    return {uid for (uid,) in groups}
 
 
 def generate_header(profile: Profile) -> list[tuple[str, Any, str]]:
@@ -140,11 +140,16 @@ def generate_flamegraph_diffrence(
     :param kwargs: additional arguments
     """
     log.major_info("Generating Flamegraph Difference")
+    metric = kwargs.get("metric", "amount")
+    lhs_trie = folding.fold_profile(lhs_profile, metric)
+    rhs_trie = folding.fold_profile(rhs_profile, metric)
     lhs_graph = flamegraph_factory.draw_flame_graph(
         lhs_profile,
         kwargs.get("height", DEFAULT_HEIGHT),
         kwargs.get("width", DEFAULT_WIDTH),
         title="Baseline Flamegraph",
+        trie=lhs_trie,
+        amount_key=metric,
     )
     log.minor_success("Baseline flamegraph", "generated")
     rhs_graph = flamegraph_factory.draw_flame_graph(
@@ -152,6 +157,8 @@ def generate_flamegraph_diffrence(
         kwargs.get("height", DEFAULT_HEIGHT),
         kwargs.get("width", DEFAULT_WIDTH),
         title="Target Flamegraph",
+        trie=rhs_trie,
+        amount_key=metric,
     )
     log.minor_success("Target flamegraph", "generated")
 
@@ -161,6 +168,9 @@ def generate_flamegraph_diffrence(
         kwargs.get("height", DEFAULT_HEIGHT),
         kwargs.get("width", DEFAULT_WIDTH),
         title="Difference Flamegraph",
+        lhs_trie=lhs_trie,
+        rhs_trie=rhs_trie,
+        amount_key=metric,
     )
     log.minor_success("Diff flamegraph", "generated")
 
@@ -203,6 +213,12 @@ def generate_flamegraph_diffrence(
     default=DEFAULT_HEIGHT,
     help="Sets the height of the flamegraph (default=14).",
 )
+@click.option(
+    "-m",
+    "--metric",
+    default="amount",
+    help="Sets the metric of the resources, by which the frames are sized (default=amount).",
+)
 @click.option("-o", "--output-file", help="Sets the output file (default=automatically generated).")
 def flamegraph(ctx: click.Context, *_: Any, **kwargs: Any) -> None:
     """ """
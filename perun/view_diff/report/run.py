@@ -4,6 +4,7 @@ from __future__ import annotations
 # Standard Imports
 from dataclasses import dataclass
 from typing import Any
+import operator
 
 # Third-Party Imports
 import click
@@ -56,24 +57,23 @@ def to_short_trace(trace: str) -> str:
 def profile_to_data(profile: Profile) -> list[TableRecord]:
     """Converts profile to list of columns and list of list of values
 
+    The amounts are aggregated by uid and trace directly from the profile, hence the size of
+    the data is bounded by the number of unique traces rather than the number of resources.
+
     :param profile: converted profile
     :return: list of columns and list of rows
     """
-    df = convert.resources_to_pandas_dataframe(profile)
-
-    grouped_df = df.groupby(["uid", "trace"]).agg({"amount": "sum"}).reset_index()
-    sorted_df = grouped_df.sort_values(by="amount", ascending=False)
-    amount_sum = df["amount"].sum()
+    groups, amount_sum = convert.resources_to_aggregated_amounts(profile, ("uid", "trace"))
     data = []
-    for _, row in sorted_df.iterrows():
+    for (uid, trace), amount in sorted(groups.items(), key=operator.itemgetter(1), reverse=True):
         data.append(
             TableRecord(
-                row["uid"],
-                row["trace"],
-                to_short_trace(row["trace"]),
-                table_run.generate_trace_list(row["trace"], row["uid"]),
-                row["amount"],
-                round(100 * row["amount"] / amount_sum, PRECISION),
+                uid,
+                trace,
+                to_short_trace(trace),
+                table_run.generate_trace_list(trace, uid),
+                amount,
+                round(100 * amount / amount_sum, PRECISION),
             )
         )
     return data
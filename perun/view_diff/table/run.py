@@ -16,11 +16,12 @@ from __future__ import annotations
 # Standard Imports
 from dataclasses import dataclass
 from typing import Any
+import heapq
 import itertools
+import operator
 
 # Third-Party Imports
 import click
-import pandas
 import tabulate
 
 # Perun Imports
@@ -92,23 +93,20 @@ def get_top_n_records(profile: Profile, **kwargs: Any) -> list[TableRecord]:
     :param kwargs: other parameters
     :return: list of top N records
     """
-    df = convert.resources_to_pandas_dataframe(profile)
-
-    if filters := kwargs.get("filters"):
-        df = filter_df(df, filters)
-
-    grouped_df = df.groupby(["uid", "trace"]).agg({"amount": "sum"}).reset_index()
-    sorted_df = grouped_df.sort_values(by="amount", ascending=False)
-    amount_sum = df["amount"].sum()
+    groups, amount_sum = convert.resources_to_aggregated_amounts(
+        profile, ("uid", "trace"), kwargs.get("filters")
+    )
     top_n = []
-    for _, top in sorted_df.head(kwargs["top_n"]).iterrows():
+    for (uid, trace), amount in heapq.nlargest(
+        kwargs["top_n"], groups.items(), key=operator.itemgetter(1)
+    ):
         top_n.append(
             TableRecord(
-                top["uid"],
-                top["trace"],
-                generate_trace_list(top["trace"], top["uid"]),
-                top["amount"],
-                round(100 * top["amount"] / amount_sum, PRECISION),
+                uid,
+                trace,
+                generate_trace_list(trace, uid),
+                amount,
+                round(100 * amount / amount_sum, PRECISION),
             )
         )
     return top_n
@@ -135,22 +133,6 @@ def print_traces(top_n_lhs: TableRecord, top_n_rhs: TableRecord) -> None:
     tabulate.PRESERVE_WHITESPACE = False
 
 
-def filter_df(df: pandas.DataFrame, filters: list[tuple[str, Any]]) -> pandas.DataFrame:
-    """Filters dataframe based on list of rules
-
-    :param df: input dataframe
-    :param filters: list of tuples of column and value
-    :return: filtered pandas dataframe
-    """
-    mask = None
-    for column, value in filters:
-        if mask is None:
-            mask = df[column] == value
-        else:
-            mask |= df[column] == value
-    return df[mask]  # type: ignore
-
-
 def compare_profiles(lhs_profile: Profile, rhs_profile: Profile, **kwargs: Any) -> None:
     """Compares the profiles and prints table for top N ranks
 
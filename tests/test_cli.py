@@ -176,6 +176,9 @@ def test_regressogram_correct(pcs_single_prof):
         {"params": ["--bucket_method", "doane", "--statistic_function", "mean"]},
         # Test bucket_method and bucket_number parameters common
         {"params": ["--bucket_method", "sqrt", "--bucket_number", 10]},
+        # Test the approximate streaming computation
+        {"params": ["--streaming", "-sf", "median"]},
+        {"params": ["-st", "--sketch_resolution", 16, "--bucket_method", "fd"]},
     ]
 
     # Set stable parameters at all tests
@@ -430,6 +433,15 @@ def test_moving_average_correct(pcs_single_prof):
     # Perform the testing
     moving_average_runner_test(runner, correct_tests, tests_edge, 0, cprof_idx)
 
+    # Test the approximate streaming computation of all methods
+    for method_params in (["sma", "-ww", 5, "-wt", "triang"], ["smm", "--center"], ["ema"]):
+        run_non_param_test(
+            runner,
+            [cprof_idx, "moving-average", "--streaming", "-sr", 64] + method_params,
+            0,
+            "succeeded",
+        )
+
 
 def kernel_regression_runner_test(runner, tests_set, tests_edge, exit_code, cprof_idx):
     # Set stable parameters at all tests
@@ -887,8 +899,14 @@ def test_kernel_regression_correct(pcs_with_root):
                 "tricube",
             ]
         },
+        # 60. Test binned kernel smoothing
+        {"params": ["--binned", "-kt", "normal"]},
+        # 61. Test binned kernel smoothing with cross-validation bandwidth method
+        {"params": ["-bn", "-gz", 64, "-sm", "local-polynomial", "-bm", "cv_ls"]},
+        # 62. Test cross-validation bandwidth method with exact kernel smoothing
+        {"params": ["--bandwidth-method", "cv_ls", "--grid-size", 256]},
     ]
-    tests_edge = [5, 22, 30, 34, 40, 59]
+    tests_edge = [5, 22, 30, 34, 40, 62]
 
     # Instantiate the runner first
     runner = CliRunner()
@@ -2,22 +2,31 @@
 
 # Standard Imports
 from subprocess import SubprocessError, CalledProcessError
+import dataclasses
+import math
 import os
 import subprocess
 import signal
+import struct
 
 # Third-Party Imports
 from click.testing import CliRunner
+from scipy import stats
+import numpy as np
+import pytest
 
 # Perun Imports
 from perun import cli
 from perun.collect.complexity import makefiles, symbols, run as complexity, configurator
-from perun.logic import pcs, runner as run
+from perun.collect.kperf import parser as kperf_parser, perf_data, run as kperf_run
+from perun.collect.time import adaptive, run as time_run
+from perun.logic import config, pcs, runner as run, store
+from perun.profile import folding, helpers as profile_helpers
 from perun.profile.factory import Profile
 from perun.testing import asserts, utils as test_utils
-from perun.utils import log
+from perun.utils import exceptions, log
 from perun.utils.common import common_kit
-from perun.utils.external import commands
+from perun.utils.external import commands, isolation, processes
 from perun.utils.structs import Unit, Executable, CollectStatus, RunnerReport, Job
 from perun.workload.integer_generator import IntegerGenerator
 
@@ -473,6 +482,43 @@ def test_collect_time(monkeypatch, pcs_with_root, capsys):
     assert len(profiles) == 1
     assert new_profile.endswith(".perf")
 
+    # Each run is measured natively with its resource usage stored in the real time
+    cpu = min(os.sched_getaffinity(0))
+    status, _, kwargs = time_run.collect(Executable("sleep", "0.01"), 2, 0, pin_cpus=str(cpu))
+    assert status == CollectStatus.OK
+    resources = kwargs["profile"]["global"]["resources"]
+    assert [(r["order"], r["subtype"]) for r in resources] == [
+        (order, subtype) for order in (1, 2) for subtype in ("real", "user", "sys")
+    ]
+    real = resources[0]
+    assert 0.01 <= real["amount"] < 10 and real["voluntary-switches"] >= 1
+    # The memory of small commands cannot be distinguished from the memory of perun
+    assert "max-rss" not in real and "minor-faults" not in resources[1]
+    usage = processes.ProcessUsage(10**9, 0.5, 0.5, 1024, 1, 2, 3, 4, 0)
+    resources = time_run.usage_to_resources("cmd", 1, usage)
+    assert resources[0]["max-rss"] == 1024 and "max-rss" not in resources[1]
+
+    # The max-rss is omitted only for the runs, where it is unknown
+    usages = iter([usage, dataclasses.replace(usage, max_rss=None), usage])
+    old_run_measured = processes.run_measured
+    monkeypatch.setattr(processes, "run_measured", lambda *_, **__: next(usages))
+    _, _, kwargs = time_run.collect(Executable("cmd"), 3, 0)
+    monkeypatch.setattr(processes, "run_measured", old_run_measured)
+    profile = Profile(kwargs["profile"])
+    reals = sorted(
+        (r for _, r in profile.all_resources() if r["subtype"] == "real"),
+        key=lambda r: r["order"],
+    )
+    assert [r.get("max-rss") for r in reals] == [1024, None, 1024]
+    assert [r["minor-faults"] for r in reals] == [3, 3, 3]
+
+    # The concurrent runs store their placements in their resources
+    status, _, kwargs = time_run.collect(Executable("true"), 3, 1, parallel=2)
+    assert status == CollectStatus.OK
+    reals = [r for r in kwargs["profile"]["global"]["resources"] if r["subtype"] == "real"]
+    assert [(r["order"], r["slot"]) for r in reals] == [(1, 0), (2, 1), (3, 0)]
+    assert all(processes.parse_cpu_list(r["cpus"]) for r in reals)
+
     # Test running time with error
     run.run_single_job(["echo"], ["hello"], ["time"], [], [head])
 
@@ -485,6 +531,120 @@ def test_collect_time(monkeypatch, pcs_with_root, capsys):
     assert "Something happened lol!" in err
 
 
+def test_collect_time_adaptively(pcs_with_root, monkeypatch, tmp_path):
+    """Test the adaptive warm-up and repetition of the timing
+
+    Expecting the warm-up stopped at the steady state, the timing stopped once the confidence
+    interval is narrow enough, and the achieved confidence stored in the header of the profile
+    """
+    values = [1.0, 1.2, 0.9, 1.1, 1.0]
+    lower, upper = adaptive.confidence_interval(values, 0.95)
+    assert (lower, upper) == pytest.approx(
+        stats.t.interval(0.95, 4, loc=np.mean(values), scale=stats.sem(values))
+    )
+    assert adaptive.confidence_interval(list(range(1, 21)), 0.95, "median") == (6, 15)
+    assert adaptive.relative_width([1.0], 0.95) == math.inf
+    assert adaptive.relative_width([1.0] * 5, 0.95, "median") == math.inf
+    assert adaptive.is_steady([5, 4, 3, 2, 1, 1, 1, 1, 1, 1], 0.02)
+    assert not adaptive.is_steady([5, 4, 3, 2, 1, 1], 0.02)
+
+    def measured(wall_times):
+        """Returns measurements of runs with the given wall times in seconds"""
+        runs = iter(wall_times)
+        return lambda: processes.ProcessUsage(int(next(runs) * 1e9), 0, 0, 0, 0, 0, 0, 0, 0)
+
+    # The warm-up stops once the slow start is over; stable runs stop after minimal repeats
+    warming_up = [3.0, 2.0, 1.5, 1.0, 1.0, 1.0, 1.0, 1.0, 1.0]
+    runs, confidence = adaptive.time_adaptively(measured(warming_up + [1.0] * 100), 0, 3)
+    assert (confidence["warmups"], confidence["repetitions"], len(runs)) == (9, 3, 3)
+    assert confidence["steady_state"] and confidence["converged"]
+    assert confidence["relative_width"] == 0 and confidence["lower"] == 1.0
+
+    # Noisy runs are repeated until the interval is narrow enough
+    noisy = [0.9, 1.1] * 1000
+    _, confidence = adaptive.time_adaptively(measured(noisy), 0, 2, target_width=0.05)
+    assert confidence["converged"] and confidence["relative_width"] <= 0.05
+    assert 10 < confidence["repetitions"] < 100
+
+    # Without any time budget, only the minimal runs are made
+    _, confidence = adaptive.time_adaptively(measured(noisy), 3, 2, 0.001, time_budget=0)
+    assert (confidence["warmups"], confidence["repetitions"]) == (0, 2)
+    assert not confidence["converged"] and not confidence["steady_state"]
+
+    # The confidence is kept in the header of the profile
+    executable = Executable("sleep", "0.001")
+    status, _, kwargs = time_run.collect(executable, 2, 1, adaptive=True, time_budget=1)
+    assert status == CollectStatus.OK
+    job = Job(Unit("time", {}), [], executable)
+    prof = profile_helpers.finalize_profile_for_job(Profile(kwargs["profile"]), job)
+    assert prof["header"]["type"] == "time"
+    assert prof["header"]["confidence"]["repetitions"] >= 2
+    assert len(list(prof.all_resources())) == 3 * prof["header"]["confidence"]["repetitions"]
+
+    # The adaptive runs are limited by the cgroup as well
+    for interface_file, content in (("controllers", "cpu memory"), ("subtree_control", "")):
+        (tmp_path / f"cgroup.{interface_file}").write_text(content)
+    monkeypatch.setattr(isolation, "current_cgroup", lambda: str(tmp_path))
+    status, _, _ = time_run.collect(executable, 2, 0, adaptive=True, time_budget=0, cpu_limit=1)
+    assert status == CollectStatus.OK
+    cgroup = tmp_path / f"perun-time-{os.getpid()}-0"
+    assert (cgroup / "cpu.max").read_text() == "100000 100000"
+    assert (cgroup / "cgroup.procs").read_text().strip() == "0"
+
+    result = CliRunner().invoke(
+        cli.collect, ["-c", "true", "time", "-w", "0", "-r", "2", "-a", "-tb", "1", "-s", "median"]
+    )
+    asserts.predicate_from_cli(result, result.exit_code == 0)
+    asserts.predicate_from_cli(result, "Confidence interval of median" in result.output)
+
+
+def test_collect_in_parallel(monkeypatch, pcs_with_root, capsys):
+    """Test running the independent jobs concurrently"""
+    head = pcs.vcs().get_minor_version_info(pcs.vcs().get_minor_head())
+    # The runtime configuration is restored even if the test fails
+    monkeypatch.setattr(config.runtime(), "data", {})
+    config.runtime().set("execute.workers", 3)
+
+    workloads = ["hello", "world", "perun", "rocks"]
+    status = run.run_single_job(["echo"], workloads, ["time"], [], [head])
+    assert status == CollectStatus.OK
+    out = common_kit.escape_ansi(capsys.readouterr()[0])
+    for workload in workloads:
+        assert f"Workload - {workload}" in out
+        assert f"Stored generated profile - .perun/jobs/time-[echo]-[{workload}]" in out
+
+    # All profiles are stored with their own workload
+    jobs_dir = os.path.join(pcs_with_root.get_path(), "jobs")
+    profiles = list(filter(test_utils.index_filter, os.listdir(jobs_dir)))
+    assert len(profiles) == len(workloads)
+    stored_workloads = [
+        store.load_profile_from_file(os.path.join(jobs_dir, prof), True)["header"]["workload"]
+        for prof in profiles
+    ]
+    assert sorted(stored_workloads) == sorted(workloads)
+
+    # Jobs with exclusive resources are serialized
+    job = Job(Unit("time", {"exclusive_resources": ["lab"]}), [], Executable("echo"))
+    assert run.get_exclusive_resources_of(job) == {"lab"}
+    assert run.get_exclusive_resources_of(Job(Unit("trace", {}), [], Executable("echo"))) == {
+        "systemtap"
+    }
+    assert run.get_exclusive_resources_of(Job(Unit("kperf", {}), [], Executable("echo"))) == {
+        "kperf-data"
+    }
+    collector_params = {"collector_params": {"time": {"exclusive_resources": ["lab"]}}}
+    status = run.run_single_job(["echo"], workloads[:2], ["time"], [], [head], **collector_params)
+    assert status == CollectStatus.OK
+
+    # Cpus are split to disjoint sets
+    cpu_sets = run.split_cpus_to_workers(3)
+    assert len(cpu_sets) == 3 and all(cpu_sets)
+    if len(os.sched_getaffinity(0)) >= 3:
+        assert sum(len(cpu_set) for cpu_set in cpu_sets) == len(set.union(*cpu_sets))
+    config.runtime().set("execute.pin_cpus", "false")
+    assert run.split_cpus_to_workers(3) == [set(), set(), set()]
+
+
 def test_integrity_tests(capsys):
     """Basic tests for checking integrity of runners"""
     mock_report = RunnerReport(complexity, "postprocessor", {"profile": {}})
@@ -555,6 +715,240 @@ def test_teardown(pcs_with_root, monkeypatch, capsys):
     assert "while collecting by time: received signal" in err
 
 
+def _perf_record(record_type, body, misc=0):
+    """Creates the record of perf data padded to the multiple of 8 bytes"""
+    body += b"\0" * (-len(body) % 8)
+    return struct.pack("<IHH", record_type, misc, 8 + len(body)) + body
+
+
+def _folded_stacks(trie):
+    """Returns the set of folded stacks and their amounts"""
+    return {
+        (";".join(trie.stack_of(n)), trie.counts[n]) for n in range(len(trie)) if trie.counts[n]
+    }
+
+
+def test_kperf_perf_data(tmp_path):
+    """Test reading the perf data natively
+
+    Expecting the stacks folded the same way as by perf script and stackcollapse-perf.pl
+    """
+    binary = os.path.join(os.path.split(__file__)[0], "sources", "collect_trace", "tst")
+    kallsyms = tmp_path / "kallsyms"
+    kallsyms.write_text("ffffffff81000000 T _text\nffffffff81001000 t do_syscall_64\n")
+    base, kernel_context, user_context = 0x555500000000, 2**64 - 128, 2**64 - 512
+
+    def sample(pid, period, *callchain):
+        return _perf_record(
+            perf_data.PERF_RECORD_SAMPLE,
+            struct.pack(
+                f"<QIIQQ{len(callchain)}Q", 0, pid, pid, period, len(callchain), *callchain
+            ),
+        )
+
+    records = [
+        _perf_record(
+            perf_data.PERF_RECORD_COMM,
+            struct.pack("<II", 42, 42) + b"tst prog\0",
+            perf_data.PERF_RECORD_MISC_COMM_EXEC,
+        ),
+        _perf_record(
+            perf_data.PERF_RECORD_MMAP2,
+            struct.pack("<IIQQQ32x", 42, 42, base, 0x2000, 0) + binary.encode() + b"\0",
+        ),
+        _perf_record(perf_data.PERF_RECORD_MMAP, struct.pack("<IIQQQ", 2**32 - 1, 0, 0, 0, 0)),
+        # QuickSort calling BubbleSort, interrupted in the kernel
+        sample(
+            42, 10, kernel_context, 0xFFFFFFFF81001010, user_context, base + 0xFF0, base + 0xA00
+        ),
+        sample(42, 5, kernel_context, 0xFFFFFFFF81001010, user_context, base + 0xFF0, base + 0xA00),
+        # The forked process shares the maps and the name of its parent
+        _perf_record(perf_data.PERF_RECORD_FORK, struct.pack("<IIIIQ", 43, 42, 43, 42, 0)),
+        sample(43, 1, user_context, base + 0xD30, 0x1234),
+    ]
+    data = b"".join(records)
+    attr = struct.pack("<IIQQQQ", 0, 136, 0, 4000, 0x123, 0).ljust(136, b"\0")
+    attr += struct.pack("<QQ", 0, 0)
+    header = struct.pack(
+        "<8sQQQQQQQQ32x",
+        b"PERFILE2",
+        104,
+        len(attr),
+        104,
+        len(attr),
+        104 + len(attr),
+        len(data),
+        0,
+        0,
+    )
+    perf_file = tmp_path / "collected.data"
+    perf_file.write_bytes(header + attr + data)
+
+    symbolizer = perf_data.Symbolizer(str(kallsyms))
+    trie = perf_data.fold_perf_data(str(perf_file), symbolizer=symbolizer)
+    # The names of functions are demangled and tidied as by perf script and stackcollapse-perf.pl
+    expected = kperf_parser.fold_events(
+        [
+            "tst_prog;QuickSort;BubbleSort;do_syscall_64 15",
+            "tst_prog;[unknown];Partition 1",
+        ]
+    )
+    assert _folded_stacks(trie) == _folded_stacks(expected)
+    assert len(_folded_stacks(trie)) == 2
+
+    # Kernel symbols are not available
+    trie = perf_data.fold_perf_data(str(perf_file), symbolizer=perf_data.Symbolizer("/missing"))
+    stacks = _folded_stacks(trie)
+    assert ("tst_prog;QuickSort;BubbleSort;[[kernel.kallsyms]]", 15) in stacks
+
+    perf_file.write_bytes(header[:50])
+    with pytest.raises(exceptions.InvalidPerfDataException):
+        perf_data.fold_perf_data(str(perf_file))
+    with pytest.raises(exceptions.InvalidPerfDataException):
+        perf_data.fold_perf_data(str(tmp_path / "missing.data"))
+
+
+def test_kperf_counters(tmp_path, monkeypatch):
+    """Test sampling several events as a group
+
+    Expecting the stacks of each event folded separately, derived metrics of the stacks and
+    software events sampled when the hardware counters are not available
+    """
+    kallsyms = tmp_path / "kallsyms"
+    kallsyms.write_text("ffffffff81000000 T _text\nffffffff81001000 t do_syscall_64\n")
+    kernel_context, cycles_id, instructions_id = 2**64 - 128, 7, 8
+
+    def sample(event_id, period, *callchain):
+        return _perf_record(
+            perf_data.PERF_RECORD_SAMPLE,
+            struct.pack(
+                f"<QIIQQ{len(callchain)}Q", event_id, 42, 42, period, len(callchain), *callchain
+            ),
+        )
+
+    data = b"".join(
+        [
+            _perf_record(perf_data.PERF_RECORD_COMM, struct.pack("<II", 42, 42) + b"tst\0"),
+            sample(instructions_id, 300, kernel_context, 0xFFFFFFFF81001010),
+            sample(cycles_id, 100, kernel_context, 0xFFFFFFFF81001010),
+            sample(cycles_id, 50, kernel_context, 0xFFFFFFFF81000010),
+            sample(instructions_id, 100, kernel_context, 0xFFFFFFFF81001010),
+        ]
+    )
+    sample_type = 0x10122
+    attrs_offset, attr_size = 104, 152
+    ids_offset = attrs_offset + 2 * attr_size
+    attrs = b""
+    for config, event_id in ((0, cycles_id), (1, instructions_id)):
+        attrs += struct.pack("<IIQQQQ", 0, 136, config, 4000, sample_type, 0).ljust(136, b"\0")
+        attrs += struct.pack("<QQ", ids_offset + 8 * config, 8)
+    ids = struct.pack("<QQ", cycles_id, instructions_id)
+    header = struct.pack(
+        "<8sQQQQQQQQ32x",
+        b"PERFILE2",
+        104,
+        attr_size,
+        attrs_offset,
+        len(attrs),
+        ids_offset + len(ids),
+        len(data),
+        0,
+        0,
+    )
+    perf_file = tmp_path / "collected.data"
+    perf_file.write_bytes(header + attrs + ids + data)
+
+    symbolizer = perf_data.Symbolizer(str(kallsyms))
+    tries = perf_data.fold_perf_events(str(perf_file), symbolizer=symbolizer)
+    assert list(tries) == ["instructions", "cycles"]
+    assert _folded_stacks(tries["cycles"]) == {("tst;do_syscall_64", 100), ("tst;_text", 50)}
+    assert _folded_stacks(tries["instructions"]) == {("tst;do_syscall_64", 400)}
+    # Only the first sampled event is folded into the single trie
+    trie = perf_data.fold_perf_data(str(perf_file), symbolizer=symbolizer)
+    assert _folded_stacks(trie) == _folded_stacks(tries["instructions"])
+
+    statistics = kperf_parser.StackStatistics("cycles")
+    cycles = tries.pop("cycles")
+    statistics.add(cycles, tries)
+    statistics.add(cycles, {"branch-misses": kperf_parser.fold_events(["tst;main 2"])})
+    resources = {r["uid"]: r for r in kperf_parser.parse_events(statistics)}
+    assert len(resources) == 3
+    syscall = resources["do_syscall_64"]
+    # The amounts and counts of events are the means per repetition
+    assert (syscall["amount"], syscall["instructions"], syscall["branch-misses"]) == (100, 200, 0)
+    assert syscall["ipc"] == pytest.approx(2.0)
+    assert syscall["branch-mpki"] == 0
+    assert (resources["main"]["amount"], resources["main"]["branch-misses"]) == (0, 1)
+    assert "ipc" not in resources["main"] and "branch-mpki" not in resources["main"]
+
+    # The flame graphs can be drawn for the counts of any of the events
+    profile = Profile({"global": {"time": "0.0", "resources": list(resources.values())}})
+    assert folding.fold_profile(profile).totals()[folding.ROOT] == 150
+    assert folding.fold_profile(profile, "instructions").totals()[folding.ROOT] == 200
+    assert folding.fold_profile(profile, "branch-misses").totals()[folding.ROOT] == 1
+
+    def mocked_perf_stat(cmd, *_, **__):
+        assert cmd.startswith("perf stat")
+        return b"", b"<not supported>,,cycles,0,100.00,,\n"
+
+    monkeypatch.setattr(commands, "run_safely_external_command", mocked_perf_stat)
+    assert kperf_run.select_events() == kperf_run.SOFTWARE_EVENTS
+    monkeypatch.setattr(commands, "run_safely_external_command", lambda *_, **__: (b"", b""))
+    assert kperf_run.select_events() == kperf_run.HARDWARE_EVENTS
+
+
+def test_kperf_parallel(monkeypatch):
+    """Test running the repetitions of kperf concurrently
+
+    Expecting each slot recording into its own file, and the placements of the repetitions
+    stored in the header of the profile
+    """
+    recorded = []
+
+    def mocked_run_perf(_, __, ___, output_file, cgroup):
+        recorded.append(output_file)
+        assert cgroup.path is None
+        return kperf_parser.fold_events(["cmd;main 2"]), {}
+
+    monkeypatch.setattr(kperf_run, "run_perf", mocked_run_perf)
+    status, _, kwargs = kperf_run.collect(Executable("ls"), warmup=1, repeat=3, parallel=2)
+    assert status == CollectStatus.OK
+    # Each slot is warmed up
+    assert sorted(recorded) == ["collected-0.data"] * 3 + ["collected-1.data"] * 2
+    assert kwargs["raw_data"].repetitions == 3
+    _, _, kwargs = kperf_run.after(**kwargs)
+    placements = kwargs["profile"]["header"]["placements"]
+    assert [(p["repetition"], p["slot"]) for p in placements] == [(1, 0), (2, 1), (3, 0)]
+    assert kwargs["profile"]["global"]["resources"][0]["amount"] == 2
+
+
+def test_kperf_repetitions():
+    """Test aggregating the stacks across the repetitions
+
+    Expecting one resource per stack with the statistics of its amounts per repetition
+    """
+    statistics = kperf_parser.StackStatistics()
+    for run in (["cmd;main;foo 10", "cmd;main 2"], ["cmd;main;foo 14"], ["cmd;main;foo 12"]):
+        statistics.add(kperf_parser.fold_events(run))
+    statistics.add(kperf_parser.fold_events(["cmd;main;bar 3"]))
+    assert statistics.repetitions == 4
+    assert len(statistics.trie) == 5
+
+    resources = {r["uid"]: r for r in kperf_parser.parse_events(statistics)}
+    assert len(resources) == 3
+    foo = resources["foo"]
+    assert (foo["amount"], foo["runs"], foo["repetitions"]) == (9.0, 3, 4)
+    assert foo["variance"] == pytest.approx(statistics_variance([10, 14, 12, 0]))
+    assert resources["main"]["variance"] == pytest.approx(statistics_variance([2, 0, 0, 0]))
+    assert resources["bar"]["trace"] == [{"func": "main"}]
+
+
+def statistics_variance(values):
+    """Computes the sample variance of the values"""
+    mean = sum(values) / len(values)
+    return sum((value - mean) ** 2 for value in values) / (len(values) - 1)
+
+
 def test_collect_kperf(monkeypatch, pcs_with_root, capsys):
     """Test collecting the profile using the time collector"""
     # Count the state before running the single job
@@ -593,17 +987,6 @@ def test_collect_kperf(monkeypatch, pcs_with_root, capsys):
     monkeypatch.setattr(commands, "run_safely_external_command", old_run)
 
     # Test error stuff
-    def mocked_is_executable_sc(command):
-        if "stackcoll" in command:
-            return False
-        else:
-            return True
-
-    monkeypatch.setattr("perun.utils.external.commands.is_executable", mocked_is_executable_sc)
-    result = runner.invoke(cli.collect, ["-c", "ls", "-w", ".", "kperf", "-w", "0", "-r", "1"])
-    assert result.exit_code != 0
-    assert "not-executable" in result.output
-
     def mocked_is_executable_perf(command):
         if "perf" in command:
             return False
@@ -614,3 +997,26 @@ def test_collect_kperf(monkeypatch, pcs_with_root, capsys):
     result = runner.invoke(cli.collect, ["-c", "ls", "-w", ".", "kperf", "-w", "0", "-r", "1"])
     assert result.exit_code != 0
     assert "not-executable" in result.output
+
+
+def test_kperf_without_stackcollapse(monkeypatch, pcs_with_root):
+    """Test collecting by kperf without the stackcollapse-perf.pl script
+
+    Expecting the script to be needed only for the perf data that cannot be read natively
+    """
+    monkeypatch.setattr(
+        "perun.utils.external.commands.is_executable", lambda command: "stackcoll" not in command
+    )
+    monkeypatch.setattr(commands, "run_safely_external_command", lambda *_, **__: (b"", b""))
+    old_fold = perf_data.fold_perf_data
+    monkeypatch.setattr(
+        perf_data, "fold_perf_data", lambda *_: kperf_parser.fold_events(["ls;main 1"])
+    )
+    runner = CliRunner()
+    result = runner.invoke(cli.collect, ["-c", "ls", "-w", ".", "kperf", "-w", "0", "-r", "1"])
+    assert result.exit_code == 0
+    assert "stackcollapse-perf.pl" in result.output
+
+    monkeypatch.setattr(perf_data, "fold_perf_data", old_fold)
+    with pytest.raises(exceptions.MissingDependencyException):
+        kperf_run.run_perf(Executable("ls"), output_file=os.path.join(os.getcwd(), "missing"))
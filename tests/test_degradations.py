@@ -10,7 +10,9 @@ import pytest
 
 # Perun Imports
 from perun.check.methods.abstract_base_checker import AbstractBaseChecker
+from perun.collect.kperf import parser as kperf_parser
 from perun.logic import config, store
+from perun.profile.factory import Profile
 from perun.utils import log
 from perun.utils.exceptions import UnsupportedModuleException
 import perun.check.factory as check
@@ -87,6 +89,88 @@ def test_degradation_in_history(pcs_with_degradations):
     assert check.PerformanceChange.Degradation in [r[0].result for r in result]
 
 
+def test_degradation_in_parallel(pcs_with_degradations):
+    """Tests checking the degradations using the pool of workers
+
+    Expects the same results as if the checks were run sequentially
+    """
+    git_repo = git.Repo(pcs_with_degradations.get_vcs_path())
+    head = str(git_repo.head.commit)
+
+    def to_records(changes):
+        return [(deg.to_storage_record(), cmdstr, source) for (deg, cmdstr, source) in changes]
+
+    config.runtime().set("degradation.cache", "false")
+    sequential_result = check.degradation_in_history(head)
+    config.runtime().set("degradation.workers", 3)
+    loaded_profiles = {}
+    parallel_result = check.degradation_in_minor(head, True, loaded_profiles)
+    assert to_records(parallel_result) == to_records(
+        check.degradation_in_minor(head, True, loaded_profiles)
+    )
+    assert parallel_result
+    assert set(to_records(parallel_result)) <= set(to_records(sequential_result))
+    assert loaded_profiles
+
+    assert to_records(check.degradation_in_history(head)) == to_records(sequential_result)
+    assert check._LOADED_PROFILES == {}
+
+    config.runtime().set("degradation.workers", "many")
+    assert check.get_number_of_check_workers() == 1
+    config.runtime().data.clear()
+
+
+def test_degradation_cache(pcs_with_degradations, monkeypatch):
+    """Tests reusing the cached results of degradation checks
+
+    Expects that unchanged history is not checked again
+    """
+    git_repo = git.Repo(pcs_with_degradations.get_vcs_path())
+    head = str(git_repo.head.commit)
+
+    def to_records(changes):
+        return [(deg.to_storage_record(), cmdstr, source) for (deg, cmdstr, source) in changes]
+
+    result = check.degradation_in_history(head)
+    cache_dir = os.path.join(pcs_with_degradations.get_path(), "cache", "degradations")
+    assert os.path.exists(cache_dir)
+
+    def failing_check(*_, **__):
+        raise AssertionError("cached check was run again")
+
+    monkeypatch.setattr(check, "run_degradation_check", failing_check)
+    assert to_records(check.degradation_in_history(head)) == to_records(result)
+
+    # Profiles of cached checks are not loaded at all, only their headers are
+    monkeypatch.setattr(check, "load_profile_once", failing_check)
+    assert to_records(check.degradation_in_history(head)) == to_records(result)
+
+    # Corrupted results are recomputed
+    for cache_subdir, _, cached_files in os.walk(cache_dir):
+        for cached_file in cached_files:
+            with open(os.path.join(cache_subdir, cached_file), "w") as cached_handle:
+                cached_handle.write("[{]")
+    with pytest.raises(AssertionError):
+        check.degradation_in_history(head)
+    monkeypatch.undo()
+    assert to_records(check.degradation_in_history(head)) == to_records(result)
+
+    # The results are identified by the version and the configuration of the method as well
+    parameters = check.get_degradation_check_parameters("exclusive_time_outliers", "best-model")
+    assert set(parameters["configuration"]) == {"degradation.location_filter", "degradation.cutoff"}
+    monkeypatch.setattr(config.runtime(), "data", {})
+    config.runtime().set("degradation.cutoff", "42.0")
+    changed_parameters = check.get_degradation_check_parameters(
+        "exclusive_time_outliers", "best-model"
+    )
+    assert changed_parameters["configuration"]["degradation.cutoff"] == "42.0"
+    assert changed_parameters["version"] == parameters["version"]
+    aat_parameters = check.get_degradation_check_parameters(
+        "average_amount_threshold", "best-model"
+    )
+    assert aat_parameters["configuration"] == {}
+
+
 def test_degradation_between_profiles(pcs_with_root, capsys):
     """Set of basic tests for testing degradation between profiles
 
@@ -197,6 +281,73 @@ def test_degradation_between_profiles(pcs_with_root, capsys):
         _ = list(check.run_degradation_check("unknown", profiles[3], profiles[3]))
 
 
+def test_noise_aware_degradation():
+    """Test detecting degradations between profiles aggregated across repetitions
+
+    Expecting that changes within the noise of repetitions are not reported
+    """
+
+    def aggregated_profile(amounts):
+        statistics = kperf_parser.StackStatistics()
+        for amount in amounts:
+            statistics.add(kperf_parser.fold_events([f"cmd;main;foo {amount}", "cmd;main 10"]))
+        profile = Profile(
+            {"global": {"time": 0.0, "resources": kperf_parser.parse_events(statistics)}}
+        )
+        profile["header"] = {"type": "time", "units": {"time": "sample"}}
+        return profile
+
+    noisy_baseline, noisy_target = aggregated_profile([10, 30, 20]), aggregated_profile(
+        [30, 50, 40]
+    )
+    stable_baseline, stable_target = aggregated_profile([19, 20, 21]), aggregated_profile(
+        [39, 40, 41]
+    )
+
+    result = {
+        r.location: r
+        for r in check.run_degradation_check(
+            "average_amount_threshold", noisy_baseline, noisy_target
+        )
+    }
+    assert result["foo"].result == check.PerformanceChange.NoChange
+    assert result["foo"].confidence_type == "t-test"
+    assert 0.9 < result["foo"].confidence_rate < 0.95
+    assert result["main"].result == check.PerformanceChange.NoChange
+
+    result = {
+        r.location: r
+        for r in check.run_degradation_check(
+            "average_amount_threshold", stable_baseline, stable_target
+        )
+    }
+    assert result["foo"].result == check.PerformanceChange.Degradation
+    assert result["foo"].confidence_rate > 0.99
+
+    # The amounts are means per repetition, hence more repetitions are not a degradation
+    more_repetitions = aggregated_profile([19, 20, 21] * 2)
+    result = {
+        r.location: r
+        for r in check.run_degradation_check(
+            "average_amount_threshold", stable_baseline, more_repetitions
+        )
+    }
+    assert result["foo"].result == check.PerformanceChange.NoChange
+    assert result["foo"].rate_degradation == pytest.approx(1.0)
+
+    # With a single repetition there is no estimate of the noise, hence no confidence
+    single_repetition = aggregated_profile([40])
+    result = {
+        r.location: r
+        for r in check.run_degradation_check(
+            "average_amount_threshold", stable_baseline, single_repetition
+        )
+    }
+    assert result["foo"].result == check.PerformanceChange.Degradation
+    assert result["foo"].confidence_type == "no"
+    assert result["foo"].confidence_rate == 0.0
+
+
 def test_strategies():
     """Set of basic tests for handling the strategies
 
@@ -9,8 +9,9 @@ from click.testing import CliRunner
 
 # Perun Imports
 from perun import cli
+from perun.profile import convert, folding
 from perun.testing import asserts
-from perun.view.flamegraph import run as flamegraph_run
+from perun.view.flamegraph import flamegraph, run as flamegraph_run
 import perun.testing.utils as test_utils
 
 
@@ -41,3 +42,44 @@ def test_flame_graph(pcs_with_root, valid_profile_pool):
         second_contents = f2.readlines()
 
     assert len(first_contents) == len(second_contents)
+
+
+def test_folded_stacks():
+    """Test folding of the stacks into the trie and its merging and differences
+
+    Expecting no errors, stacks folded into shared prefixes and correctly rendered differences
+    """
+    memory_profile = test_utils.load_profile("to_add_profiles", "new-prof-2-memory-basic.perf")
+    trie = folding.fold_profile(memory_profile)
+    # The folded trie contains all of the stacks of the flame graph format
+    lines = convert.to_flame_graph_format(memory_profile)
+    assert trie.totals()[folding.ROOT] == sum(float(line.split(" ")[-1]) for line in lines)
+    for line in lines:
+        stack = line.rsplit(" ", maxsplit=1)[0].split(";")
+        node = folding.ROOT
+        for frame in stack[1:][::-1] + stack[:1]:
+            node = trie.edges[(node << folding.FRAME_BITS) | trie.frame_ids[frame]]
+        assert trie.stack_of(node) == stack[1:][::-1] + stack[:1]
+
+    baseline, target = folding.StackTrie(), folding.StackTrie()
+    baseline.add(["main", "f", "g"], 10)
+    baseline.add(["main", "f"], 10)
+    target.add(["main", "f", "g"], 30)
+    target.add(["main", "h"], 10)
+    merged = baseline.merge(target)
+    assert len(merged) == 5
+    assert merged.totals()[folding.ROOT] == 60
+    assert sorted(merged.counts) == [0, 0, 10, 10, 40]
+
+    # The baseline is normalized to the total of the target
+    diff = target.difference(baseline)
+    assert diff.totals()[folding.ROOT] == 40
+    assert sorted(diff.deltas()) == [-20, 0, 0, 10, 10]
+    svg = flamegraph.render_flame_graph(diff, 16, title="Diff", count_name="B")
+    assert "g (30 B, 75.00%; +25.00%)" in svg
+    assert "f (30 B, 75.00%; -50.00%)" in svg
+    assert "h (10 B, 25.00%; +25.00%)" in svg
+    assert svg.count('class="func_g"') == 5
+
+    # Empty stacks are rendered as error
+    assert "ERROR" in flamegraph.render_flame_graph(folding.StackTrie(), 16)
@@ -16,7 +16,7 @@ from click.testing import CliRunner
 from perun import cli
 from perun.fuzz.structs import CoverageConfiguration
 from perun.testing import asserts
-from perun.utils.external import commands
+from perun.utils.external import commands, processes
 import perun.fuzz.evaluate.by_coverage as coverage_fuzz
 import perun.fuzz.evaluate.by_perun as perun_fuzz
 
@@ -539,13 +539,13 @@ def test_fuzzing_errors(pcs_with_root, monkeypatch):
         else:
             return old_run_process(*_, **__)
 
-    old_check_output = commands.get_stdout_from_external_command
+    old_run_measured = processes.run_measured
 
-    def patched_check_output(*_, **__):
-        return "real 0.01\nuser 0.00\nsys 0.00"
+    def patched_run_measured(*_, **__):
+        return processes.ProcessUsage(10**7, 0.0, 0.0, 0, 0, 0, 0, 0, 0)
 
     monkeypatch.setattr(commands, "run_safely_external_command", patched_run_process)
-    monkeypatch.setattr(commands, "get_stdout_from_external_command", patched_check_output)
+    monkeypatch.setattr(processes, "run_measured", patched_run_measured)
     result = runner.invoke(
         cli.fuzz_cmd,
         [
@@ -594,4 +594,4 @@ def test_fuzzing_errors(pcs_with_root, monkeypatch):
     asserts.predicate_from_cli(result, result.exit_code == 0)
     asserts.predicate_from_cli(result, "Executing binary raised an exception" in result.output)
     monkeypatch.setattr(coverage_fuzz, "target_testing", old_target_perun_testing)
-    monkeypatch.setattr(commands, "get_stdout_from_external_command", old_check_output)
+    monkeypatch.setattr(processes, "run_measured", old_run_measured)
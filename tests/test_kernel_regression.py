@@ -0,0 +1,64 @@
+"""
+Tests of non-parametric method kernel regression functionality.
+
+The binned kernel smoothing and its cross-validation bandwidth selector are compared
+with the exact computations on generated data.
+
+The postprocessby CLI is tested in test_cli module.
+"""
+from __future__ import annotations
+
+# Standard Imports
+
+# Third-Party Imports
+import numpy as np
+
+# Perun Imports
+from perun.postprocess.kernel_regression import methods
+
+
+def test_binned_kernel_smoothing():
+    """Test that binned kernel smoothing approximates the exact kernel smoothing
+
+    Expecting no errors and estimates close to the exact estimates
+    """
+    rng = np.random.default_rng(42)
+    x_pts = np.sort(rng.uniform(0, 100, 500))
+    y_pts = np.sin(x_pts / 10) * 50 + x_pts + rng.normal(0, 5, len(x_pts))
+
+    for smoothing_method in ("spatial-average", "local-linear", "local-polynomial"):
+        for kernel_type in ("epanechnikov", "tricube", "normal"):
+            config = {
+                "kernel_type": kernel_type,
+                "smoothing_method": smoothing_method,
+                "polynomial_order": 3,
+                "bandwidth_method": "scott",
+                "bandwidth_value": None,
+            }
+            exact = methods.kernel_smoothing(x_pts.tolist(), y_pts.tolist(), config)
+            binned = methods.kernel_smoothing(
+                x_pts.tolist(), y_pts.tolist(), config | {"binned": True}
+            )
+            assert binned["bandwidth"] == exact["bandwidth"]
+            assert binned["grid_size"] == methods.DEFAULT_GRID_SIZE
+            assert np.allclose(binned["bucket_stats"], exact["bucket_stats"], atol=1e-2)
+            assert abs(binned["r_square"] - exact["r_square"]) < 1e-5
+
+    # The shortcut of leave-one-out cross-validation corresponds to leaving the points out
+    kernel = methods._KERNEL_TYPES_MAPS["epanechnikov"]
+    estimate = methods.BinnedKernelSmoothing(x_pts, y_pts, kernel, 0)
+    for bandwidth in (1, 2, 4, 8):
+        weights = kernel((x_pts[:, np.newaxis] - x_pts[np.newaxis, :]) / bandwidth)
+        np.fill_diagonal(weights, 0)
+        exact_error = np.mean(((weights * y_pts).sum(axis=1) / weights.sum(axis=1) - y_pts) ** 2)
+        assert np.isclose(estimate.cross_validation_score(bandwidth), exact_error, rtol=1e-3)
+    assert 0 < estimate.select_bandwidth() < 8
+
+    # Points with the same x coordinates are smoothed to their mean
+    constant = methods.kernel_smoothing(
+        [1.0] * 10,
+        list(range(10)),
+        config | {"binned": True, "bandwidth_method": "cv_ls", "grid_size": 16},
+    )
+    assert constant["bandwidth"] == 1.0
+    assert np.allclose(constant["bucket_stats"], 4.5)
@@ -2,6 +2,8 @@
 from __future__ import annotations
 
 # Standard Imports
+import array
+import json
 
 # Third-Party Imports
 import pytest
@@ -118,3 +120,46 @@ def test_name_generation(capsys):
     rt_config.set("format.output_profile_template", "sampling-[%memory.sampling%]")
     profile_name = profiles.generate_profile_name({"collector_info": {"name": "trace"}})
     assert profile_name == "sampling-[_].perf"
+
+
+def test_columnar_storage():
+    """Test storing the collectable values of resources in compact columns
+
+    Expecting the same resources as stored, regardless of the used storage
+    """
+    resources = [
+        {"uid": "f", "type": "time", "amount": 1.5, "timestamp": 1, "trace": [{"func": "main"}]},
+        {"uid": "f", "type": "time", "amount": 2.5, "timestamp": 2, "trace": [{"func": "main"}]},
+        {"uid": "g", "type": "time", "amount": 3.5, "timestamp": 3},
+        {"uid": "g", "type": "time", "amount": 4, "timestamp": 2**70},
+    ]
+    rt_config = config.runtime()
+    profile = Profile({"global": {"time": "0.0", "resources": resources}})
+    rt_config.set("profiles.columnar_storage", "false")
+    list_profile = Profile({"global": {"time": "0.0", "resources": resources}})
+    rt_config.set("profiles.columnar_storage", "true")
+
+    assert len(profile["resources"]) == 2
+    assert list(profile.all_resources()) == list(list_profile.all_resources())
+    assert profile.serialize() == list_profile.serialize()
+
+    # Homogeneous numeric columns are compact, while mixed or overflowing ones are kept as lists
+    f_columns, g_columns = profile["resources"]["f#0"], profile["resources"]["g#0"]
+    assert isinstance(f_columns["amount"], array.array)
+    assert isinstance(f_columns["timestamp"], array.array)
+    assert g_columns["amount"] == [3.5, 4]
+    assert g_columns["timestamp"] == [3, 2**70]
+    assert all(isinstance(column, list) for column in list_profile["resources"]["f#0"].values())
+
+    # Loaded profiles are compacted as well
+    loaded_profile = Profile(json.loads(json.dumps(profile.serialize())))
+    assert isinstance(loaded_profile["resources"]["f#0"]["amount"], array.array)
+    assert list(loaded_profile.all_resources()) == list(profile.all_resources())
+
+    # Equal persistent values of different types are kept in separate resource types
+    typed_resources = [
+        {"uid": "h", "type": "time", "subtype": subtype, "amount": 1} for subtype in (1, 1.0, True)
+    ]
+    typed_profile = Profile({"global": {"time": "0.0", "resources": typed_resources}})
+    assert len(typed_profile["resources"]) == 3
+    assert [type(res["subtype"]) for _, res in typed_profile.all_resources()] == [int, float, bool]
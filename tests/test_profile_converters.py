@@ -58,6 +58,40 @@ def test_flame_graph(memory_profiles):
         assert line_no == len(flame_graph)
 
 
+def test_aggregated_amounts(memory_profiles):
+    """Test aggregation of amounts of resources without constructing the dataframe
+
+    Expecting the same groups and totals as when grouping the pandas dataframe.
+    """
+    profiles = memory_profiles + [
+        test_utils.load_profile("diff_profiles", "kperf-baseline.perf"),
+        test_utils.load_profile("full_profiles", "prof-1-time-2017-03-19-19-17-36.perf"),
+    ]
+    for profile in profiles:
+        df = convert.resources_to_pandas_dataframe(profile)
+        for group_by, filters in [
+            (("uid", "trace"), None),
+            (("uid",), None),
+            (("uid", "subtype"), [("subtype", "malloc")]),
+            (("trace",), [("uid", "main"), ("uid", "sys")]),
+        ]:
+            if any(key not in df for key in group_by):
+                continue
+            filtered_df = df
+            if filters:
+                mask = False
+                for column, value in filters:
+                    mask |= df[column] == value if column in df else False
+                filtered_df = df[mask]
+            expected = filtered_df.groupby(list(group_by))["amount"].sum().to_dict()
+            groups, total = convert.resources_to_aggregated_amounts(profile, group_by, filters)
+            assert {
+                (group[0] if len(group) == 1 else group): amount
+                for (group, amount) in groups.items()
+            } == pytest.approx(expected)
+            assert total == pytest.approx(filtered_df["amount"].sum())
+
+
 def test_coefficients_to_points_correct():
     """Test correct conversion from models coefficients to points that can be used for plotting.
 
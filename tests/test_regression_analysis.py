@@ -9,11 +9,13 @@ The postprocessby CLI is tested in test_cli module.
 from __future__ import annotations
 
 # Standard Imports
+import math
 
 # Third-Party Imports
 import pytest
 
 # Perun Imports
+from perun.postprocess.regression_analysis import data_provider, generic, methods, specific
 from perun.postprocess.regression_analysis.run import postprocess
 from perun.utils import exceptions, metrics
 import perun.testing.utils as test_utils
@@ -372,3 +374,72 @@ def test_exp_model():
     test_utils.compare_results(model["r_square"], 1.0)
     test_utils.compare_results([c["value"] for c in model["coeffs"] if c["name"] == "b0"][0], 1.0)
     test_utils.compare_results([c["value"] for c in model["coeffs"] if c["name"] == "b1"][0], 2.0)
+
+
+def test_vectorized_regression_sums():
+    """Test computing the sums of models over whole arrays of points
+
+    Expects the same sums as when computed point by point, with points outside the domain of
+    model skipped.
+    """
+    x_pts = [-2.0, 0.0, 1.0, 2.0, 4.0, 8.0, 16.0, 32.0]
+    y_pts = [1.0, 2.0, 2.5, 3.0, -1.0, 5.0, 6.0, 7.5]
+
+    modifications = [(math.log10, math.log10), (lambda x: x, lambda y: y), (math.log, abs)]
+    sums = generic.generic_regression_sums(x_pts, y_pts, modifications, 2)
+    for (f_x, f_y), model_sums in zip(modifications, sums):
+        assert len(model_sums) == 2
+        for (_, part_end), data in zip([(0, 4), (4, 8)], model_sums):
+            valid = []
+            for x_pt, y_pt in zip(x_pts[:part_end], y_pts[:part_end]):
+                try:
+                    valid.append((x_pt, f_x(x_pt), f_y(y_pt)))
+                except ValueError:
+                    pass
+            assert data["pts_num"] == len(valid)
+            assert data["num_sqrt"] == pytest.approx(math.sqrt(len(valid)))
+            assert data["x_sum"] == pytest.approx(sum(x for (_, x, _) in valid))
+            assert data["y_sum"] == pytest.approx(sum(y for (_, _, y) in valid))
+            assert data["xy_sum"] == pytest.approx(sum(x * y for (_, x, y) in valid))
+            assert data["x_sq_sum"] == pytest.approx(sum(x**2 for (_, x, _) in valid))
+            assert data["y_sq_sum"] == pytest.approx(sum(y**2 for (_, _, y) in valid))
+            assert data["x_end"] == max(x for (x, _, _) in valid)
+            assert data["x_start"] == min([x_pts[0]] + [x for (x, _, _) in valid])
+
+    # The generator provides the same data, each step as a separate dictionary
+    generated = list(generic.generic_regression_data(x_pts, y_pts, math.log10, math.log10, 2))
+    assert generated == sums[0] and generated[0] is not sums[0][0]
+
+    # Quadratic data are computed over arrays as well
+    quad_data = list(specific.specific_quad_data(x_pts, y_pts, 1))[0]
+    assert quad_data["x4_sum"] == pytest.approx(sum(x**4 for x in x_pts))
+    assert quad_data["x_sq_y_sum"] == pytest.approx(sum(x**2 * y for x, y in zip(x_pts, y_pts)))
+    assert (quad_data["x_start"], quad_data["x_end"], quad_data["pts_num"]) == (-2.0, 32.0, 8)
+
+    # All models are computed from the shared sums
+    results = methods.compute(iter([(x_pts, y_pts, "uid")]), "full", ("linear", "power"))
+    assert [result["model"] for result in results] == ["linear", "power"]
+    assert results[1]["x_start"] == -2.0 and results[1]["x_end"] == 32.0
+
+
+def test_columnar_data_provider():
+    """Test that the columnar data provider yields the same points as the generic one"""
+    for directory, profile_name, per_key in [
+        ("postprocess_profiles", "complexity-models.perf", "structure-unit-size"),
+        ("postprocess_profiles", "exp_datapoints_rg_ma_kr.perf", "structure-unit-size"),
+        ("full_profiles", "prof-3-memory-2017-05-15-15-43-42.perf", "address"),
+        ("full_profiles", "prof-3-memory-2017-05-15-15-43-42.perf", "subtype"),
+    ]:
+        profile = test_utils.load_profile(directory, profile_name)
+        expected = list(
+            data_provider.generic_profile_provider(profile, of_key="amount", per_key=per_key)
+        )
+        columnar = list(
+            data_provider.columnar_profile_provider(profile, of_key="amount", per_key=per_key)
+        )
+        assert len(expected) > 0
+        assert [(x.tolist(), y.tolist(), uid) for (x, y, uid) in columnar] == expected
+
+    # Missing keys are reported in the same way as by the generic provider
+    with pytest.raises(KeyError):
+        list(data_provider.columnar_profile_provider(profile, of_key="amount", per_key="unknown"))
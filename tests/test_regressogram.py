@@ -13,9 +13,16 @@ from __future__ import annotations
 # Standard Imports
 
 # Third-Party Imports
+import numpy as np
+import pandas as pd
+import pytest
+import scipy.stats
 
 # Perun Imports
+from perun.postprocess.regression_analysis import data_provider
+from perun.postprocess.regressogram import methods
 from perun.postprocess.regressogram.run import postprocess
+from perun.utils.common import sketch_kit
 import perun.testing.utils as test_utils
 
 
@@ -144,3 +151,86 @@ _EXPECTED_RESULTS = {
         {"r_square": 0.0, "bucket_stats": 1},
     ],
 }
+
+
+def test_streaming_regressogram():
+    """
+    Test the approximate regressogram computed from the sketches.
+
+    Expects the same number of buckets as the exact regressogram and precise values for sketches
+    with high resolution.
+    """
+    test_model = test_utils.load_profile("postprocess_profiles", "exp_model_datapoints.perf")
+    for x_pts, y_pts, _ in data_provider.columnar_profile_provider(
+        test_model, of_key="amount", per_key="structure-unit-size"
+    ):
+        for bucket_method in ("auto", "doane", "fd", "rice", "scott", "sqrt", "sturges", 7):
+            for statistic_function in ("mean", "median"):
+                exact = methods.regressogram(
+                    x_pts.tolist(), y_pts.tolist(), statistic_function, bucket_method
+                )
+                streamed = methods.streaming_regressogram(
+                    x_pts, y_pts, statistic_function, bucket_method, resolution=1 << 16
+                )
+                assert len(streamed["bucket_stats"]) == len(exact["bucket_stats"])
+                for key in ("x_start", "x_end", "y_start"):
+                    assert streamed[key] == exact[key]
+                if statistic_function == "mean":
+                    assert streamed["r_square"] == pytest.approx(exact["r_square"])
+                    assert streamed["bucket_stats"] == pytest.approx(exact["bucket_stats"])
+
+    # Sketches of parts of the series are merged into the same sketch as of the whole series
+    x_pts = np.concatenate([np.linspace(0, 1, 1000), np.linspace(-500, 2000, 3000)])
+    y_pts = x_pts**2
+    whole, first, second = (sketch_kit.HistogramSketch(128) for _ in range(3))
+    whole.update(x_pts, y_pts)
+    first.update(x_pts[:1000], y_pts[:1000])
+    second.update(x_pts[1000:], y_pts[1000:])
+    first.merge(second)
+    assert (first.level, first.offset) == (whole.level, whole.offset)
+    assert first.counts.tolist() == whole.counts.tolist()
+    assert first.y_sums == pytest.approx(whole.y_sums)
+    assert first.x_moments.std() == pytest.approx(np.std(x_pts))
+    assert first.x_moments.skewness() == pytest.approx(scipy.stats.skew(x_pts))
+    assert whole.width <= 2 * (2000 + 500) / (128 - 2)
+    assert abs(whole.quantile(0.25) - np.percentile(x_pts, 25)) <= whole.width / 2
+
+
+def test_windowed_statistics():
+    """
+    Test the incremental moving statistics used by streaming moving average.
+
+    Expects the same results as computed by pandas, regardless of the splitting into batches.
+    """
+    y_pts = np.sin(np.arange(500) / 10.0) * 100 + np.arange(500) % 7
+    for method, center, window_type in [
+        ("sma", True, None),
+        ("sma", False, "triang"),
+        ("smm", True, None),
+        ("smm", False, None),
+    ]:
+        rolling = pd.Series(y_pts).rolling(6, min_periods=2, center=center, win_type=window_type)
+        expected = rolling.median() if method == "smm" else rolling.mean()
+        statistics = sketch_kit.WindowedStatistics(method, 6, 2, center, window_type)
+        computed = np.concatenate(
+            [statistics.update(y_pts[start : start + 37]) for start in range(0, 500, 37)]
+            + [statistics.finish()]
+        )
+        assert np.allclose(computed, expected.values, equal_nan=True)
+
+    alpha = sketch_kit.ewm_alpha("com", 4)
+    expected = pd.Series(y_pts).ewm(com=4, min_periods=3).mean().values
+    statistics = sketch_kit.WindowedStatistics("ema", 4, 3, alpha=alpha)
+    assert np.allclose(statistics.update(y_pts), expected, equal_nan=True)
+
+    # Parts of the series warmed up by the preceding values are computed independently
+    statistics = sketch_kit.WindowedStatistics("sma", 6, 2, True)
+    statistics.warm_up(y_pts[:300])
+    assert np.allclose(
+        np.concatenate([statistics.update(y_pts[300:]), statistics.finish()]),
+        pd.Series(y_pts).rolling(6, min_periods=2, center=True).mean().values[300:],
+    )
+    warm_up = sketch_kit.ewm_warm_up_length(alpha, 1e-9)
+    statistics = sketch_kit.WindowedStatistics("ema", 4, 3, alpha=alpha)
+    statistics.warm_up(y_pts[300 - warm_up : 300])
+    assert np.allclose(statistics.update(y_pts[300:]), expected[300:], atol=1e-9 * 200)
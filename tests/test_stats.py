@@ -2,6 +2,8 @@
 from __future__ import annotations
 
 # Standard Imports
+import json
+import multiprocessing
 import os
 import pathlib
 
@@ -156,6 +158,86 @@ def test_basic_stats_operations(pcs_with_root):
     _check_objects([(minor_head, ["custom_stats"])], [], [])
 
 
+def test_stats_file_records(pcs_with_root, monkeypatch):
+    """Test the layout of stats files and the batched writing of their modifications.
+
+    The modifications are appended to the stats file as separate records, only once they are
+    flushed. The superseded records are eventually compacted and the stats files in the older
+    format are converted.
+    """
+    stats_file = stats.add_stats("record_stats", ["entry_1"], [{"value": 1}])
+    inode = os.stat(stats_file).st_ino
+    # The modification is pending, the file contains the preamble only
+    assert os.path.getsize(stats_file) == stats.STATS_FILE_PREAMBLE.size
+    assert stats.get_stats_of("record_stats") == {"entry_1": {"value": 1}}
+
+    # Modifications are appended to the file without rewriting it
+    stats.add_stats("record_stats", ["entry_2"], [{"value": 2}])
+    stats.update_stats("record_stats", ["entry_1"], [{"other": 3}])
+    stats.flush_stats()
+    flushed_size = os.path.getsize(stats_file)
+    stats.update_stats("record_stats", ["entry_2"], [{"other": 4}])
+    stats.flush_stats()
+    assert os.stat(stats_file).st_ino == inode and os.path.getsize(stats_file) > flushed_size
+    expected = {"entry_1": {"value": 1, "other": 3}, "entry_2": {"value": 2, "other": 4}}
+    assert stats.get_stats_of("record_stats") == expected
+
+    # Fresh processes (without the cache) read the same content and single records
+    stats._CACHED_STATS_FILES.clear()
+    assert stats.get_stats_of("record_stats") == expected
+    assert stats.get_stats_of("record_stats", ["entry_2"]) == {"entry_2": expected["entry_2"]}
+    # Records appended by other processes are found by the cached files
+    with open(stats_file, "ab") as stats_handle:
+        stats_handle.write(stats._encode_record(stats.RECORD_DELETE, "entry_1", {}))
+    assert stats.get_stats_of("record_stats") == {"entry_2": expected["entry_2"]}
+
+    # Modifications are flushed in batches, once they are large enough
+    monkeypatch.setattr(stats, "FLUSH_THRESHOLD", 1024)
+    monkeypatch.setattr(stats, "COMPACTION_THRESHOLD", 1024)
+    for i in range(100):
+        stats.add_stats("record_stats", ["entry_3"], [{"value": i}])
+    assert len(stats._get_cached_stats_file(stats_file).pending) < 100
+    stats.flush_stats()
+    # The superseded records were compacted
+    assert os.stat(stats_file).st_ino != inode and os.path.getsize(stats_file) < 4096
+    stats._CACHED_STATS_FILES.clear()
+    assert stats.get_stats_of("record_stats") == {
+        "entry_2": expected["entry_2"],
+        "entry_3": {"value": 99},
+    }
+
+    # Stats files in the older format are read and converted on modification
+    legacy_file = stats.get_stats_file_path("legacy_stats")
+    with open(legacy_file, "wb") as legacy_handle:
+        legacy_handle.write(store.pack_content(json.dumps({"entry_1": {"value": 1}}).encode()))
+    assert stats.get_stats_of("legacy_stats") == {"entry_1": {"value": 1}}
+    stats.update_stats("legacy_stats", ["entry_1"], [{"other": 2}])
+    stats.flush_stats()
+    with open(legacy_file, "rb") as legacy_handle:
+        assert legacy_handle.read(4) == stats.STATS_FILE_MAGIC
+    stats._CACHED_STATS_FILES.clear()
+    assert stats.get_stats_of("legacy_stats") == {"entry_1": {"value": 1, "other": 2}}
+
+    # Pending modifications of deleted files are discarded
+    stats.add_stats("record_stats", ["entry_4"], [{"value": 4}])
+    stats.delete_stats_file("record_stats", keep_directory=True)
+    stats.flush_stats()
+    assert not os.path.exists(stats_file)
+
+    # Modifications of the workers are written immediately, since they exit without flushing;
+    # the pending modifications of the parent are written before the fork
+    stats.add_stats("worker_stats", ["entry_0"], [{"value": 0}])
+    worker = multiprocessing.get_context("fork").Process(
+        target=stats.add_stats, args=("worker_stats", ["entry_1"], [{"value": 1}])
+    )
+    worker.start()
+    worker.join()
+    assert worker.exitcode == 0 and not stats._WRITE_THROUGH
+    assert not stats._get_cached_stats_file(stats.get_stats_file_path("worker_stats")).pending
+    stats._CACHED_STATS_FILES.clear()
+    assert stats.get_stats_of("worker_stats") == {"entry_0": {"value": 0}, "entry_1": {"value": 1}}
+
+
 def test_stats_lists(pcs_full_no_prof):
     """Tests the list functions (lists of stat versions or stat files).
 
@@ -2,14 +2,18 @@
 from __future__ import annotations
 
 # Standard Imports
+import io
 import os
+import zlib
 
 # Third-Party Imports
 import pytest
 
 # Perun Imports
-from perun.logic import store, index
+from perun.logic import cache, config, store, index
+from perun.profile import binary
 from perun.utils import exceptions, timestamps, streams
+from perun.utils.common import compression_kit
 
 
 @pytest.mark.usefixtures("cleandir")
@@ -169,3 +173,234 @@ def test_streams(tmpdir, monkeypatch):
     monkeypatch.setattr("perun.logic.store.read_and_deflate_chunk", lambda _: "p mixed 1\0tmp")
     with pytest.raises(exceptions.IncorrectProfileFormatException):
         store.load_profile_from_file(tmp_file, False)
+
+
+@pytest.mark.usefixtures("cleandir")
+def test_binary_profiles(tmpdir):
+    """Test packing and loading of profiles in the binary columnar format"""
+    pool_path = os.path.join(os.path.split(__file__)[0], "profiles", "full_profiles")
+    for profile_file in os.listdir(pool_path):
+        profile = store.load_profile_from_file(os.path.join(pool_path, profile_file), True, True)
+
+        # Both object formats are loaded to the same profile
+        for object_format in ("binary", "json"):
+            checksum, content = store.pack_profile_object(profile, object_format)
+            assert store.is_sha1(checksum)
+            object_file = os.path.join(str(tmpdir), f"{object_format}-{profile_file}")
+            with open(object_file, "wb") as object_handle:
+                object_handle.write(content)
+            loaded_profile = store.load_profile_from_file(object_file, False)
+            assert loaded_profile.serialize() == profile.serialize()
+            assert list(loaded_profile.all_resources()) == list(profile.all_resources())
+
+    # Columns are read lazily and selectively
+    profile = store.load_profile_from_file(os.path.join(pool_path, profile_file), True, True)
+    binary_file = os.path.join(str(tmpdir), "binary.perf")
+    with open(binary_file, "wb") as binary_handle:
+        binary_handle.write(binary.pack_profile(profile))
+    with open(binary_file, "rb") as binary_handle:
+        reader = binary.BinaryProfileReader(binary_file, binary_handle)
+        assert reader.profile["header"] == profile["header"]
+        amounts = reader.read_resources(["amount"])
+        assert all(list(columns.keys()) == ["amount"] for columns in amounts.values() if columns)
+        for resource_type, columns in profile["resources"].items():
+            assert list(amounts[resource_type]["amount"]) == list(columns["amount"])
+
+    # Malformed binary profiles
+    with open(binary_file, "wb") as binary_handle:
+        binary_handle.write(binary.BINARY_PROFILE_MAGIC_PREFIX + b"\0" * 20)
+    with pytest.raises(exceptions.IncorrectProfileFormatException):
+        store.load_profile_from_file(binary_file, False)
+
+
+def test_profile_cache(tmpdir):
+    """Test caching of decoded profiles from the object store"""
+    config.runtime().set("profiles.cache_size_limit", cache.DEFAULT_CACHE_SIZE_LIMIT)
+    pool_path = os.path.join(os.path.split(__file__)[0], "profiles", "full_profiles")
+    profiles = [
+        store.load_profile_from_file(os.path.join(pool_path, profile_file), True, True)
+        for profile_file in sorted(os.listdir(pool_path))[:3]
+    ]
+    objects_dir = os.path.join(str(tmpdir), ".perun", "objects")
+    cache_dir = os.path.join(str(tmpdir), ".perun", "cache", "profiles")
+    object_files = []
+    for profile in profiles:
+        checksum, content = store.pack_profile_object(profile)
+        store.add_loose_object_to_dir(objects_dir, checksum, content)
+        object_files.append((store.split_object_name(objects_dir, checksum)[1], checksum))
+
+    # First load stores the profile in the cache, the second one is loaded from the cache
+    object_file, checksum = object_files[0]
+    assert cache.get_cache_directory_for(object_file) == cache_dir
+    assert cache.load_cached_profile(object_file, checksum) is None
+    loaded_profile = store.load_profile_from_file(object_file, False)
+    cached_profile = cache.load_cached_profile(object_file, checksum)
+    assert cached_profile is not None
+    assert cached_profile.serialize() == loaded_profile.serialize() == profiles[0].serialize()
+    assert store.load_profile_from_file(object_file, False).serialize() == profiles[0].serialize()
+
+    # Stale or malformed cached profiles are discarded
+    cached_file = os.path.join(cache_dir, checksum + cache.PROFILE_CACHE_SUFFIX)
+    with open(object_file, "ab") as object_handle:
+        object_handle.write(b"\0")
+    assert cache.load_cached_profile(object_file, checksum) is None
+    assert not os.path.exists(cached_file)
+    store.load_profile_from_file(object_files[1][0], False)
+    cached_file = os.path.join(cache_dir, object_files[1][1] + cache.PROFILE_CACHE_SUFFIX)
+    with open(cached_file, "wb") as cached_handle:
+        cached_handle.write(b"garbage")
+    assert cache.load_cached_profile(*object_files[1]) is None
+    assert not os.path.exists(cached_file)
+
+    # Least recently used profiles are evicted
+    for object_file, _ in object_files:
+        store.load_profile_from_file(object_file, False)
+    cached_sizes = {entry.name: entry.stat().st_size for entry in os.scandir(cache_dir)}
+    assert len(cached_sizes) == 3
+    oldest = object_files[0][1] + cache.PROFILE_CACHE_SUFFIX
+    os.utime(os.path.join(cache_dir, oldest), (0, 0))
+    cache.evict_profiles(cache_dir, sum(cached_sizes.values()) - 1)
+    assert sorted(os.listdir(cache_dir)) == sorted(name for name in cached_sizes if name != oldest)
+
+    # Cache can be disabled
+    config.runtime().set("profiles.cache_size_limit", 0)
+    assert cache.load_cached_profile(*object_files[1]) is None
+    config.runtime().set("profiles.cache_size_limit", cache.DEFAULT_CACHE_SIZE_LIMIT)
+
+    # Profiles outside of the object store are not cached
+    assert cache.get_cache_directory_for(os.path.join(pool_path, "any.perf")) is None
+
+
+def test_block_compression(tmpdir):
+    """Test packing of contents into containers of independently compressed blocks"""
+    content = b"".join(f"line {i}: {i * i}\n".encode("utf-8") for i in range(20000))
+
+    # Contents packed by older versions of Perun are still readable
+    legacy_file = os.path.join(str(tmpdir), "legacy")
+    with open(legacy_file, "wb") as legacy_handle:
+        legacy_handle.write(zlib.compress(content))
+    with open(legacy_file, "rb") as legacy_handle:
+        assert store.read_and_deflate_chunk(legacy_handle) == content.decode("utf-8")
+
+    # Packed contents are split into blocks, which are inflated in parallel
+    packed_content = store.pack_content(content)
+    assert compression_kit.is_block_container(packed_content)
+    assert compression_kit.decompress(io.BytesIO(packed_content)) == content
+    for workers in (1, 4):
+        packed_content = compression_kit.compress(content, block_size=4096, workers=workers)
+        chunks = list(compression_kit.iter_decompressed(io.BytesIO(packed_content), workers))
+        assert len(chunks) == len(content) // 4096 + 1
+        assert b"".join(chunks) == content
+    assert compression_kit.decompress(io.BytesIO(compression_kit.compress(b""))) == b""
+
+    # Contents can be compressed while they are produced
+    stream_file = os.path.join(str(tmpdir), "stream")
+    with open(stream_file, "wb") as stream_handle:
+        with compression_kit.BlockWriter(stream_handle, block_size=1000, workers=2) as writer:
+            for line in content.splitlines(keepends=True):
+                writer.write(line)
+    with open(stream_file, "rb") as stream_handle:
+        assert store.read_and_deflate_chunk(stream_handle) == content.decode("utf-8")
+    with open(stream_file, "wb") as stream_handle:
+        store.write_packed_content(stream_handle, content)
+    with open(stream_file, "rb") as stream_handle:
+        assert stream_handle.read() == store.pack_content(content)
+
+    # Writes spanning several blocks produce the same blocks as a single write
+    stream_handle = io.BytesIO()
+    with compression_kit.BlockWriter(stream_handle, block_size=4096, workers=4) as writer:
+        writer.write(content[:1000])
+        writer.write(content[1000:10000])
+        writer.write(bytearray(content[10000:]))
+    assert stream_handle.getvalue() == compression_kit.compress(content, block_size=4096)
+
+    # Malformed containers
+    with pytest.raises(zlib.error):
+        compression_kit.decompress(io.BytesIO(packed_content[:-10]))
+    with pytest.raises(zlib.error):
+        compression_kit.compress(content, codec="unknown")
+
+
+@pytest.mark.usefixtures("cleandir")
+def test_log_structured_index(tmpdir, monkeypatch, capsys):
+    """Test appending, compaction and binary search lookup in the log-structured index"""
+    monkeypatch.setattr("perun.logic.index.INDEX_COMPACTION_THRESHOLD", 4)
+    pool_path = os.path.join(os.path.split(__file__)[0], "profiles", "degradation_profiles")
+    profile = store.load_profile_from_file(os.path.join(pool_path, "linear_base.perf"), True, True)
+
+    def create_entry(i):
+        """Helper function for creating the i-th entry"""
+        sha = store.compute_checksum(f"profile {i}".encode("utf-8"))
+        st = timestamps.timestamp_to_str(1700000000 + 31 * i % 40)
+        return index.ExtendedIndexEntry(st, sha, f"profile-{i % 7}.perf", -1, profile)
+
+    entries = [create_entry(i) for i in range(30)]
+    index_file = os.path.join(str(tmpdir), "index")
+    index.touch_index(index_file)
+    compactions = []
+    compact_index = index.compact_index
+
+    def counted_compact_index(index_handle):
+        """Helper function for counting the compactions"""
+        compactions.append(index_handle)
+        compact_index(index_handle)
+
+    monkeypatch.setattr(index, "compact_index", counted_compact_index)
+    for entry in reversed(entries):
+        index.write_entry_to_index(index_file, entry)
+    monkeypatch.setattr(index, "compact_index", compact_index)
+
+    # Registered entries are compacted periodically, once the log is long relative to the index
+    with open(index_file, "rb") as index_handle:
+        index_version, number_of_entries = index.read_index_prefix(index_handle)
+        _, compacted_entries = index.read_index_layout(index_handle)
+        assert index_version == index.IndexVersion.NimbleGecko.value
+        assert 0 < compacted_entries <= number_of_entries
+        assert number_of_entries - compacted_entries <= max(4, compacted_entries // 2)
+        assert len(compactions) == 4
+
+    # Duplicate entries are not registered
+    index.write_entry_to_index(index_file, create_entry(0))
+    assert "already registered" in "".join(capsys.readouterr())
+
+    def entry_key(entry):
+        """Helper function for sorting the entries"""
+        return entry.path, entry.time
+
+    with open(index_file, "rb") as index_handle:
+        walked_entries = list(index.walk_index(index_handle))
+        assert [entry_key(entry) for entry in walked_entries] == sorted(
+            entry_key(entry) for entry in entries
+        )
+        assert sorted(entry.checksum for entry in walked_entries) == sorted(
+            entry.checksum for entry in entries
+        )
+
+        # Entries are looked up by both checksum and path
+        for entry in entries:
+            found_entry = index.lookup_entry_within_index(
+                index_handle, lambda _: True, entry.checksum, ("checksum", entry.checksum)
+            )
+            assert entry_key(found_entry) == entry_key(entry)
+            found_entries = index.lookup_all_entries_within_index(
+                index_handle, lambda _: True, ("path", entry.path)
+            )
+            assert [entry_key(found) for found in found_entries] == sorted(
+                entry_key(other) for other in entries if other.path == entry.path
+            )
+        with pytest.raises(exceptions.EntryNotFoundException):
+            index.lookup_entry_within_index(
+                index_handle, lambda _: True, "nothing", ("path", "nothing.perf")
+            )
+
+    # Older versions of index are converted to the log-structured index
+    monkeypatch.setattr("perun.logic.index.INDEX_VERSION", index.IndexVersion.FastSloth.value)
+    index_v2_file = os.path.join(str(tmpdir), "index_v2")
+    index.touch_index(index_v2_file)
+    for entry in entries[:5]:
+        index.write_entry_to_index(index_v2_file, entry)
+    monkeypatch.setattr("perun.logic.index.INDEX_VERSION", index.IndexVersion.NimbleGecko.value)
+    index.write_entry_to_index(index_v2_file, entries[5])
+    with open(index_v2_file, "rb") as index_handle:
+        assert index.read_index_prefix(index_handle) == (index.IndexVersion.NimbleGecko.value, 6)
+        assert len(index.lookup_indexed_entries(index_handle, "path", entries[0].path)) == 1
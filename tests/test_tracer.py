@@ -19,6 +19,7 @@ from perun.utils.exceptions import SystemTapStartupException
 from perun.utils.structs import CollectStatus
 import perun.collect.trace.run as trace_run
 import perun.collect.trace.systemtap.engine as stap
+import perun.collect.trace.systemtap.parse_compact as parse_compact
 import perun.testing.utils as test_utils
 
 _mocked_stap_code = 0
@@ -312,6 +313,45 @@ def test_collect_trace_utils(pcs_with_root):
     assert result.exit_code == 0
 
 
+def test_trace_stack_mismatch_recovery():
+    """Test the recovery of function call stack when some exit records are lost."""
+
+    class MockedProbes:
+        func = {name: {"name": name} for name in ("main", "f", "g")}
+
+    ctx = parse_compact.TransformContext(MockedProbes(), {"tst"}, False, "")
+    timestamp = 0
+
+    def record(record_type, name):
+        nonlocal timestamp
+        timestamp += 1
+        return {
+            "type": record_type,
+            "tid": 1,
+            "timestamp": timestamp,
+            "id": name,
+            "seq": 0,
+            "loc": "tst",
+        }
+
+    for name in ("main", "f", "g", "f", "g", "g"):
+        parse_compact._record_func_begin(record(RecordType.FUNC_BEGIN, name), ctx)
+    # Regular exit matches the top of the stack
+    assert parse_compact._record_func_end(record(RecordType.FUNC_END, "g"), ctx)["uid"] == "g"
+    # Exit of 'f' lost one 'g' frame
+    assert parse_compact._record_func_end(record(RecordType.FUNC_END, "f"), ctx)["uid"] == "f"
+    # Exit of 'main' lost the remaining 'g' and 'f' frames
+    assert parse_compact._record_func_end(record(RecordType.FUNC_END, "main"), ctx)["uid"] == "main"
+    # Unknown exit records do not match anything
+    assert parse_compact._record_func_end(record(RecordType.FUNC_END, "f"), ctx) == {}
+
+    thread_ctx = ctx.per_thread[1]
+    assert thread_ctx.func_stack == []
+    assert all(not positions for positions in thread_ctx.func_positions.values())
+    assert dict(ctx.stack_mismatches) == {"f": 1, "main": 1}
+    assert dict(ctx.lost_frames) == {"g": 2, "f": 1}
+
+
 def test_collect_trace(pcs_with_root, trace_collect_job):
     """Test running the trace collector from the CLI with parameter handling
 
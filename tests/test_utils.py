@@ -4,31 +4,47 @@ from __future__ import annotations
 # Standard Imports
 import glob
 import io
+import multiprocessing
 import pkgutil
+import random
 import os
 import re
+import resource
 import subprocess
 import signal
 import sys
 
 # Third-Party Imports
+import numpy as np
 import pytest
 
 # Perun Imports
 from perun import collect, postprocess, view
+from perun.collect.complexity import symbols
+from perun.collect.memory import syscalls
 from perun.collect.trace.optimizations.structs import Complexity
 from perun.fuzz import filetype
 from perun.logic import commands, config
+from perun.postprocess.moving_average import methods as moving_average
+from perun.postprocess.regression_analysis import methods as regression_analysis
+from perun.postprocess.regressogram import methods as regressogram
 from perun.testing import asserts
 from perun.utils import log
-from perun.utils.common import common_kit, cli_kit, traces_kit
+from perun.utils.common import common_kit, cli_kit, parallel_kit, traces_kit
 from perun.utils.exceptions import (
     SystemTapScriptCompilationException,
     SystemTapStartupException,
     ResourceLockedException,
 )
 from perun.utils.structs import Unit, OrderedEnum, HandledSignals
-from perun.utils.external import environment, commands as external_commands, processes, executable
+from perun.utils.external import (
+    environment,
+    commands as external_commands,
+    processes,
+    executable,
+    isolation,
+    symbolization,
+)
 
 
 def assert_all_registered_modules(package_name, package, must_have_function_names):
@@ -230,6 +246,216 @@ def test_nonblocking_subprocess():
     assert "already being used" in str(exception.value)
 
 
+def test_measured_process(monkeypatch, tmp_path):
+    """Test spawning and measuring the processes natively
+
+    Expecting the wall time with nanosecond resolution and failures of commands reported
+    """
+    os.chdir(tmp_path)
+    assert processes.parse_cpu_list("0-3, 8,") == {0, 1, 2, 3, 8}
+    with pytest.raises(ValueError):
+        processes.parse_cpu_list("0-x")
+
+    usage = processes.run_measured("sleep 0.05")
+    assert 5 * 10**7 <= usage.wall_time < 10**10
+    assert usage.exit_code == 0 and usage.voluntary_switches >= 1
+    # The peak memory of the (small) spawning process is accounted to the small commands as well
+    assert usage.max_rss is None
+    allocation = 32 * 1024 * 1024
+    usage = processes.run_measured(f"{sys.executable} -c 'b\"x\" * {allocation}'")
+    assert usage.max_rss is not None and usage.max_rss > 32 * 1024
+
+    # The commands are spawned by perun itself, if the spawning process cannot be started
+    def failing_spawner():
+        raise OSError("cannot start the spawner")
+
+    monkeypatch.setattr(processes._SPAWNERS, "spawner", None)
+    monkeypatch.setattr(processes, "MeasuringSpawner", failing_spawner)
+    spawner_max_rss = resource.getrusage(resource.RUSAGE_SELF).ru_maxrss
+    allocation = (spawner_max_rss + 32 * 1024) * 1024
+    usage = processes.run_measured(f"{sys.executable} -c 'b\"x\" * {allocation}'")
+    assert usage.max_rss is not None and usage.max_rss > spawner_max_rss + 16 * 1024
+    assert processes.run_measured("true").max_rss is None
+    monkeypatch.undo()
+
+    # The pinning is inherited only by the spawned process
+    original_cpus = os.sched_getaffinity(0)
+    cpu = min(original_cpus)
+    assert processes.run_measured("true", {cpu}).exit_code == 0
+    assert os.sched_getaffinity(0) == original_cpus
+
+    assert processes.run_measured("false", check=False).exit_code == 1
+    with pytest.raises(subprocess.CalledProcessError):
+        processes.run_measured("false")
+    with pytest.raises(OSError):
+        processes.run_measured("nonexisting-perun-command")
+
+
+def test_isolated_placements(tmp_path, monkeypatch):
+    """Test splitting the cpus to isolated placements of concurrent runs
+
+    Expecting disjoint cpus of slots spread over the NUMA nodes, and unlimited runs, when the
+    cgroups cannot be created
+    """
+    assert isolation.format_cpu_list({8, 0, 1, 2, 3, 5}) == "0-3,5,8"
+    assert processes.parse_cpu_list("0-3,5,8") == {0, 1, 2, 3, 5, 8}
+
+    for node, cpu_list in ((0, "0-3\n"), (1, "4-7\n")):
+        (tmp_path / f"node{node}").mkdir()
+        (tmp_path / f"node{node}" / "cpulist").write_text(cpu_list)
+    monkeypatch.setattr(isolation, "NODE_CPU_LISTS", str(tmp_path / "node*" / "cpulist"))
+    assert isolation.numa_nodes(range(8)) == {0: {0, 1, 2, 3}, 1: {4, 5, 6, 7}}
+    assert isolation.numa_nodes(range(10)) == {0: {0, 1, 2, 3}, 1: {4, 5, 6, 7}, -1: {8, 9}}
+
+    placements = isolation.split_to_placements(4, range(8))
+    assert [(p.slot, isolation.format_cpu_list(p.cpus), p.node) for p in placements] == [
+        (0, "0-1", 0),
+        (1, "4-5", 1),
+        (2, "2-3", 0),
+        (3, "6-7", 1),
+    ]
+    assert placements[1].to_resource() == {"slot": 1, "cpus": "4-5", "numa-node": 1}
+    # With more slots than cpus, the slots share the cpus
+    assert [p.cpus for p in isolation.split_to_placements(3, [0, 1])] == [{0}, {1}, {0}]
+
+    monkeypatch.setattr(isolation, "NODE_CPU_LISTS", str(tmp_path / "none" / "cpulist"))
+    assert isolation.numa_nodes([0, 1]) == {-1: {0, 1}}
+    unknown_placements = isolation.split_to_placements(2, [0, 1])
+    assert [p.node for p in unknown_placements] == [None, None]
+    assert unknown_placements[0].to_resource() == {"slot": 0, "cpus": "0"}
+    # The repetitions are spread round-robin over the slots and returned in their order
+    placements = isolation.split_to_placements(2, os.sched_getaffinity(0))
+    results = isolation.run_in_placements(
+        placements, 5, lambda placement, order: (placement.slot, order, os.sched_getaffinity(0))
+    )
+    assert [(slot, order) for (slot, order, _) in results] == [(i % 2, i) for i in range(5)]
+    assert all(cpus == placements[slot].cpus for (slot, _, cpus) in results)
+
+    # The cgroups without limits, or without cgroup v2, are not created
+    with isolation.slot_cgroups("perun-test", 2) as cgroups:
+        assert [cgroup.path for cgroup in cgroups] == [None, None]
+    monkeypatch.setattr(isolation, "CGROUP_ROOT", str(tmp_path / "cgroup"))
+    with pytest.raises(OSError):
+        isolation.current_cgroup()
+    with isolation.slot_cgroups("perun-test", 1, memory_limit="64M", cpu_limit=0.5) as cgroups:
+        assert cgroups[0].path is None
+        assert cgroups[0].limits == {"memory.max": "64M", "cpu.max": "50000 100000"}
+
+    # The current process is moved to the leaf, and the cgroups of slots are its siblings
+    parent = tmp_path / "cgroup"
+    parent.mkdir()
+    for interface_file, content in (("controllers", "cpu memory"), ("subtree_control", "")):
+        (parent / f"cgroup.{interface_file}").write_text(content)
+    monkeypatch.setattr(isolation, "current_cgroup", lambda: str(parent))
+    with isolation.slot_cgroups("perun-test", 2, memory_limit="64M") as cgroups:
+        assert (parent / "perun-test-main" / "cgroup.procs").read_text() == str(os.getpid())
+        assert (parent / "cgroup.subtree_control").read_text() == "+memory"
+        assert [cgroup.path for cgroup in cgroups] == [
+            str(parent / "perun-test-0"),
+            str(parent / "perun-test-1"),
+        ]
+        assert (parent / "perun-test-1" / "memory.max").read_text() == "64M"
+        assert cgroups[0].path is not None
+        # The commands join the cgroup before they are executed
+        assert processes.run_measured("true", cgroup=cgroups[0].path).exit_code == 0
+        assert (parent / "perun-test-0" / "cgroup.procs").read_text().strip() == "0"
+    assert (parent / "cgroup.subtree_control").read_text() == "-memory"
+    assert (parent / "cgroup.procs").read_text() == str(os.getpid())
+    # The missing controllers cannot limit the resources
+    (parent / "cgroup.controllers").write_text("memory")
+    with isolation.slot_cgroups("perun-cpu", 1, cpu_limit=1) as cgroups:
+        assert cgroups[0].path is None and not (parent / "perun-cpu-main").exists()
+
+
+def test_symbolization(tmp_path, monkeypatch):
+    """Test resolving the addresses of the binary to its functions and source lines
+
+    Expecting the same lines as by addr2line, and the symbols of the build cached on disk and
+    shared by the collectors
+    """
+    monkeypatch.setenv("XDG_CACHE_HOME", str(tmp_path))
+    binary = os.path.join(os.path.split(__file__)[0], "sources", "collect_trace", "tst")
+    symbols_of_binary = symbolization.BinarySymbols(binary)
+    build_id = "87beebf135f7cc83e3ac6e6a3ecd2b3c836288f1"
+    assert symbols_of_binary.build_id == build_id
+    assert os.path.exists(symbolization.cache_path(build_id))
+    assert symbolization.cache_path(build_id).startswith(str(tmp_path))
+
+    sources = "/home/jirka/perun/tests/collect_trace/cpp_sources"
+    assert symbols_of_binary.function_at_address(0xA00) == "_Z9QuickSortPii"
+    assert symbols_of_binary.function_at(0xA00) == "_Z9QuickSortPii"
+    assert symbols_of_binary.function_at(0xA00, demangled=True) == "QuickSort(int*, int)"
+    assert symbols_of_binary.function_at_address(0x10) is None
+    assert symbols_of_binary.line_at(0xA00) == (f"{sources}/sorts.h", 16)
+    assert symbols_of_binary.line_at(0xD30) == (f"{sources}/sorts.h", 84)
+    assert symbols_of_binary.line_at(0x1303) == (f"{sources}/tst.cpp", 9)
+    assert symbols_of_binary.line_at(0x10) is None
+
+    # The second load is served from the cache, without parsing the debug information
+    def failing_read(*_):
+        raise AssertionError("the binary was parsed again")
+
+    monkeypatch.setattr(symbolization.BinarySymbols, "_read_line_table", failing_read)
+    monkeypatch.setattr(symbolization.BinarySymbols, "_read_symbols", failing_read)
+    cached = symbolization.BinarySymbols(binary)
+    assert cached.symbols == symbols_of_binary.symbols
+    assert cached.line_at(0xD30) == symbols_of_binary.line_at(0xD30)
+    assert cached.function_at_address(0xA00) == "_Z9QuickSortPii"
+
+    # The collectors share the loaded symbols
+    assert symbolization.load(binary) is symbolization.load(binary)
+    assert symbols.extract_symbol_map(binary)["_Z9QuickSortPii"] == "0x9ca"
+    syscalls.build_address_to_line_cache({("0xa00", "0x0"), ("0x10", "0x0")}, binary)
+    assert syscalls.address_to_line("0xa00") == [f"{sources}/sorts.h", "16"]
+    assert syscalls.address_to_line("0x10") == ["??", "0"]
+
+    # The names are demangled in a batch, and kept if they cannot be demangled
+    names = ["_Z9QuickSortPii", "main", "_Z10BubbleSortPii"]
+    assert symbolization.demangle(names) == [
+        "QuickSort(int*, int)",
+        "main",
+        "BubbleSort(int*, int)",
+    ]
+
+    def missing_demangler(*_, **__):
+        raise OSError("c++filt is missing")
+
+    monkeypatch.setattr(subprocess, "run", missing_demangler)
+    assert symbolization.demangle(names) == names
+
+    # Truncated or corrupted caches are parsed again and overwritten
+    monkeypatch.undo()
+    monkeypatch.setenv("XDG_CACHE_HOME", str(tmp_path))
+    cache_path = symbolization.cache_path(build_id)
+    with open(cache_path, "rb") as cache_handle:
+        content = cache_handle.read()
+    for corrupted in (content[:14], content[:-5], content[:-1] + b"\xff"):
+        with open(cache_path, "wb") as cache_handle:
+            cache_handle.write(corrupted)
+        assert symbolization.BinarySymbols(binary).symbols == symbols_of_binary.symbols
+        with open(cache_path, "rb") as cache_handle:
+            assert cache_handle.read() == content
+
+    # Failures of storing the cache do not leave any temporary files
+    def failing_replace(*_):
+        raise OSError("cannot replace")
+
+    os.remove(cache_path)
+    monkeypatch.setattr(os, "replace", failing_replace)
+    assert symbolization.BinarySymbols(binary).symbols == symbols_of_binary.symbols
+    assert os.listdir(os.path.dirname(cache_path)) == []
+    monkeypatch.undo()
+
+    # Invalid binaries
+    not_elf = tmp_path / "not_elf"
+    not_elf.write_text("#!/bin/sh\n")
+    with pytest.raises(ValueError):
+        symbolization.BinarySymbols(str(not_elf))
+    assert symbolization.load(str(not_elf)) is None
+    assert symbolization.load(str(tmp_path / "missing")) is None
+    assert symbols.extract_symbols(str(not_elf)) == []
+
+
 def test_signal_handler():
     """Tests default signal handler"""
     with HandledSignals(signal.SIGINT):
@@ -339,6 +565,87 @@ def test_filetypes(monkeypatch):
     assert filetype.get_filetype("somefile") == (True, None)
 
 
+def test_parallel_kit():
+    """Test computing the postprocessors for chunks of points in parallel"""
+    chunks = [
+        ([x for x in range(1, 40 + i)], [3 * x + i for x in range(1, 40 + i)], f"uid{i}")
+        for i in range(7)
+    ]
+    regressogram_config = {
+        "bucket_method": "doane",
+        "statistic_function": "mean",
+        "per_key": "size",
+        "of_key": "amount",
+    }
+    moving_average_config = {
+        "moving_method": "sma",
+        "window_width": 3,
+        "min_periods": None,
+        "center": True,
+        "window_type": None,
+        "per_key": "size",
+        "of_key": "amount",
+    }
+
+    # Chunks of different ranges and noise, for which different window widths are computed
+    noisy_chunks = [
+        (
+            [x for x in range(1, 50 * (i + 1))],
+            [x + (x * 37) % (3 + 4 * i) for x in range(1, 50 * (i + 1))],
+            f"noisy{i}",
+        )
+        for i in range(4)
+    ]
+
+    def postprocess_all():
+        adaptive_config = dict(moving_average_config, window_width=None)
+        return (
+            regression_analysis.compute(iter(chunks), "full", ("linear", "power")),
+            regressogram.compute_regressogram(iter(chunks), regressogram_config),
+            moving_average.compute_moving_average(iter(chunks), moving_average_config),
+            moving_average.compute_moving_average(iter(noisy_chunks), adaptive_config),
+        )
+
+    # NaNs of results returned by workers are different objects, hence we compare representations
+    sequential_results = repr(postprocess_all())
+    assert [model["window_width"] for model in postprocess_all()[3]] == [1, 1, 3, 3]
+    config.runtime().set("execute.postprocess_workers", 3)
+    assert repr(postprocess_all()) == sequential_results
+    assert parallel_kit._SHARED_CHUNKS == {}
+
+    # Non-numeric points and points of different types are computed sequentially
+    assert parallel_kit.map_chunks(
+        lambda x, y, uid, suffix: (x, y, uid + suffix),
+        [(["a", "b"], [1, 2], "first"), ([1, 2], [3, 4], "second")],
+        "!",
+    ) == [(["a", "b"], [1, 2], "first!"), ([1, 2], [3, 4], "second!")]
+    assert parallel_kit.map_chunks(
+        lambda x, y, uid: (x, y, uid),
+        [([1.5, 2.5], [1, 2], "floats"), ([1, 2], [3, 4], "ints")],
+    ) == [([1.5, 2.5], [1, 2], "floats"), ([1, 2], [3, 4], "ints")]
+    shared = parallel_kit.to_shared_array([np.array([1, 2]), np.array([3])])
+    assert shared.tolist() == [1, 2, 3] and shared.dtype.kind == "i"
+
+    # Daemonic workers (e.g. of degradation checks) cannot have children and compute sequentially
+    results = multiprocessing.get_context("fork").Queue()
+    worker = multiprocessing.get_context("fork").Process(
+        target=_map_chunks_in_worker, args=(chunks, regressogram_config, results), daemon=True
+    )
+    worker.start()
+    assert repr(results.get(timeout=60)) == repr(postprocess_all()[1])
+    worker.join()
+    assert worker.exitcode == 0
+
+    config.runtime().set("execute.postprocess_workers", "many")
+    assert parallel_kit.get_number_of_workers() == 1
+    config.runtime().data.clear()
+
+
+def _map_chunks_in_worker(chunks, regressogram_config, results):
+    """Computes the regressogram in the daemonic worker and sends the results to the queue"""
+    results.put(regressogram.compute_regressogram(iter(chunks), regressogram_config))
+
+
 def test_traces():
     """Test various parts of working with traces"""
     trace_a = [
@@ -463,6 +770,56 @@ def test_trace_manager():
     assert int(traces_kit.fast_compute_distance(trace_a, trace_b, cache={}, threshold=3)) == 3
 
 
+def test_indexed_trace_classification(monkeypatch):
+    """Test that classification with candidate index is comparable to the exhaustive one
+
+    Expecting that only few pivots are compared and similar number of clusters is found.
+    """
+    random.seed(42)
+    words = ["alloc", "page", "map", "vma", "lru", "state", "free", "zone", "rmap", "pte"]
+
+    def random_function():
+        return "_".join(random.sample(words, random.randint(1, 3))) + str(random.randint(0, 20))
+
+    bases = [
+        ["main", "start"] + [random_function() for _ in range(random.randint(4, 12))]
+        for _ in range(40)
+    ]
+    traces = []
+    for _ in range(400):
+        trace = list(random.choice(bases))
+        index = random.randint(2, len(trace) - 1)
+        if random.random() < 0.5:
+            trace[index] = random_function()
+        else:
+            trace.insert(index, random_function())
+        traces.append(trace)
+
+    # Traces with the same frames have the same bands of signatures
+    assert list(traces_kit.signature_bands(traces[0])) == list(
+        traces_kit.signature_bands(list(traces[0]))
+    )
+    assert len(list(traces_kit.signature_bands([]))) == traces_kit.MINHASH_BANDS
+
+    for strategy in traces_kit.ClassificationStrategy:
+        classifier = traces_kit.TraceClassifier(strategy=strategy)
+        for trace in traces:
+            classifier.classify_trace(trace)
+            layer = classifier.get_classification_layer(trace)
+            assert len(layer.candidate_clusters_for(trace)) <= traces_kit.MAX_CANDIDATES
+        monkeypatch.setattr(traces_kit, "MAX_CANDIDATES", len(traces))
+        exhaustive_classifier = traces_kit.TraceClassifier(strategy=strategy)
+        for trace in traces:
+            exhaustive_classifier.classify_trace(trace)
+        monkeypatch.undo()
+
+        clusters = len(classifier.get_classification_layer(traces[0]).clusters)
+        exhaustive_clusters = len(
+            exhaustive_classifier.get_classification_layer(traces[0]).clusters
+        )
+        assert abs(clusters - exhaustive_clusters) <= 0.1 * exhaustive_clusters
+
+
 def test_machine_info(monkeypatch):
     # Test that we can obtain some information about kernel
     assert environment.get_kernel() != "Unknown"